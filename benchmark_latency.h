@@ -0,0 +1,206 @@
+#ifndef BENCHMARK_LATENCY_H
+#define BENCHMARK_LATENCY_H
+
+// Tail latency for the paced (real-time rate) benchmark cases. Mean time
+// per iteration hides the rare slow block (allocator stall, page fault,
+// preemption), so these cases record every block instead:
+//
+//     IQLatencyRecorder recorder("paced_block120", numBlocks);
+//     ... recorder.record(latencyNs, processingNs); per block ...
+//     recorder.report(state);   // p50/p99/p99.9/max counters, CSV
+//
+// Values go into an HDR-style histogram: exact below 2 x SUB_BUCKETS ns,
+// then SUB_BUCKETS linear buckets per power of two, so every value is
+// kept to within 1/SUB_BUCKETS of itself at a fixed memory cost, and
+// recording is a few instructions with no allocation. With IQ_LATENCY_CSV
+// set to a directory, report() also writes <name>.csv (one row per block)
+// and <name>_percentiles.csv (the percentile distribution) for plotting.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+class IQLatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 7;
+    static const int64_t SUB_BUCKETS = (int64_t)1 << SUB_BUCKET_BITS;
+
+    IQLatencyHistogram() : counts_((64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS, 0) { reset(); }
+
+    void record(int64_t value) {
+        if (value < 0) {
+            value = 0;
+        }
+        counts_[index(value)]++;
+        total_++;
+        sum_ += (double)value;
+        max_ = std::max(max_, value);
+        min_ = std::min(min_, value);
+    }
+
+    void reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        sum_ = 0.0;
+        max_ = 0;
+        min_ = INT64_MAX;
+    }
+
+    uint64_t count() const { return total_; }
+    int64_t max() const { return max_; }
+    int64_t min() const { return total_ ? min_ : 0; }
+    double mean() const { return total_ ? sum_ / total_ : 0.0; }
+
+    // Smallest recorded value with at least a fraction p of the values at
+    // or below it, to within the bucket width (highest value of its bucket)
+    int64_t percentile(double p) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(p * total_));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); i++) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(max_, highestEquivalent(i));
+            }
+        }
+        return max_;
+    }
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+    double sum_;
+    int64_t max_;
+    int64_t min_;
+
+    static int msb(uint64_t v) {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(v);
+#else
+        int b = 0;
+        while (v >>= 1) {
+            b++;
+        }
+        return b;
+#endif
+    }
+
+    // Values below 2 x SUB_BUCKETS map to themselves; above that, shift
+    // the value down to SUB_BUCKET_BITS + 1 significant bits
+    static size_t index(int64_t value) {
+        if (value < 2 * SUB_BUCKETS) {
+            return (size_t)value;
+        }
+        int shift = msb((uint64_t)value) - SUB_BUCKET_BITS;
+        return (size_t)(shift * SUB_BUCKETS + (value >> shift));
+    }
+
+    static int64_t highestEquivalent(size_t i) {
+        if ((int64_t)i < 2 * SUB_BUCKETS) {
+            return (int64_t)i;
+        }
+        int shift = (int)(i / SUB_BUCKETS) - 1;
+        int64_t mantissa = (int64_t)i - shift * SUB_BUCKETS;
+        return ((mantissa + 1) << shift) - 1;
+    }
+};
+
+// Per-block latency (and optionally processing time) of one paced run
+class IQLatencyRecorder {
+public:
+    // expectedBlocks sizes the CSV rows up front, so record() does not
+    // allocate during the run
+    IQLatencyRecorder(const std::string& name, size_t expectedBlocks) : name_(name) {
+        const char* dir = std::getenv("IQ_LATENCY_CSV");
+        if (dir && *dir) {
+            csvDir_ = dir;
+            rows_.reserve(expectedBlocks);
+        }
+    }
+
+    // processingNs < 0: not measured
+    void record(int64_t latencyNs, int64_t processingNs = -1) {
+        latency_.record(latencyNs);
+        if (processingNs >= 0) {
+            processing_.record(processingNs);
+        }
+        if (!csvDir_.empty() && rows_.size() < rows_.capacity()) {
+            Row row = {latencyNs, processingNs};
+            rows_.push_back(row);
+        }
+    }
+
+    const IQLatencyHistogram& latency() const { return latency_; }
+    const IQLatencyHistogram& processing() const { return processing_; }
+
+    // Attach percentiles (microseconds) as counters and write the CSVs
+    void report(benchmark::State& state) const {
+        attach(state, latency_, "");
+        if (processing_.count() > 0) {
+            attach(state, processing_, "proc_");
+        }
+        if (!csvDir_.empty()) {
+            writeCsv();
+        }
+    }
+
+private:
+    struct Row {
+        int64_t latencyNs;
+        int64_t processingNs;
+    };
+
+    std::string name_;
+    std::string csvDir_;
+    IQLatencyHistogram latency_;
+    IQLatencyHistogram processing_;
+    std::vector<Row> rows_;
+
+    static void attach(benchmark::State& state, const IQLatencyHistogram& h, const std::string& prefix) {
+        state.counters[prefix + "p50_us"] = h.percentile(0.5) / 1000.0;
+        state.counters[prefix + "p99_us"] = h.percentile(0.99) / 1000.0;
+        state.counters[prefix + "p99.9_us"] = h.percentile(0.999) / 1000.0;
+        state.counters[prefix + "max_us"] = h.max() / 1000.0;
+    }
+
+    void writeCsv() const {
+        std::string path = csvDir_ + "/" + name_ + ".csv";
+        if (FILE* f = std::fopen(path.c_str(), "w")) {
+            std::fprintf(f, "block,latency_ns,processing_ns\n");
+            for (size_t i = 0; i < rows_.size(); i++) {
+                if (rows_[i].processingNs >= 0) {
+                    std::fprintf(f, "%zu,%lld,%lld\n", i, (long long)rows_[i].latencyNs,
+                                 (long long)rows_[i].processingNs);
+                } else {
+                    std::fprintf(f, "%zu,%lld,\n", i, (long long)rows_[i].latencyNs);
+                }
+            }
+            std::fclose(f);
+        } else {
+            std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        }
+
+        // Percentile distribution in the HdrHistogram style: 1 - p halving
+        // from 50% towards the tail
+        path = csvDir_ + "/" + name_ + "_percentiles.csv";
+        if (FILE* f = std::fopen(path.c_str(), "w")) {
+            std::fprintf(f, "percentile,latency_ns,processing_ns\n");
+            for (double tail = 0.5; tail * latency_.count() >= 0.5; tail /= 2.0) {
+                double p = 1.0 - tail;
+                std::fprintf(f, "%.10g,%lld,%lld\n", p * 100.0, (long long)latency_.percentile(p),
+                             (long long)processing_.percentile(p));
+            }
+            std::fprintf(f, "100,%lld,%lld\n", (long long)latency_.max(), (long long)processing_.max());
+            std::fclose(f);
+        }
+    }
+};
+
+#endif // BENCHMARK_LATENCY_H
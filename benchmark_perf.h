@@ -0,0 +1,238 @@
+#ifndef BENCHMARK_PERF_H
+#define BENCHMARK_PERF_H
+
+// Hardware performance counters for the Google Benchmark cases, read with
+// perf_event_open around the timed loop only:
+//
+//     IQPerfCounters perf(state);
+//     for (auto _ : perf.loop()) { ... }
+//     state.SetItemsProcessed(...);   // Derived counters use these
+//
+// When the scope ends, per-sample counters (cycles, instructions, L1D and
+// last-level cache misses, branch mispredicts; per iteration when the case
+// reports no items) plus IPC and bytes/cycle are attached as user counters.
+// Built with IQ_PERF_COUNTERS (CMake ENABLE_PERF_COUNTERS) on Linux; when
+// perf is unavailable (no kernel support, a VM without a PMU,
+// perf_event_paranoid > 2, seccomp in containers) or IQ_PERF=0 is set,
+// the loop runs unchanged and no counters are attached. Counts are
+// user-space only, for the calling thread, and scaled when the kernel
+// multiplexes them.
+
+#include <benchmark/benchmark.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(IQ_PERF_COUNTERS) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define IQ_PERF_AVAILABLE 1
+#endif
+
+class IQPerfCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, NUM_EVENTS };
+
+    explicit IQPerfCounters(benchmark::State& state) : state_(state), counted_(false) {
+        std::memset(values_, 0, sizeof(values_));
+        std::memset(valid_, 0, sizeof(valid_));
+    }
+
+    ~IQPerfCounters() {
+        if (counted_) {
+            attach();
+        }
+    }
+
+    IQPerfCounters(const IQPerfCounters&) = delete;
+    IQPerfCounters& operator=(const IQPerfCounters&) = delete;
+
+    // The benchmark loop, with counting enabled from its start to its end
+    class Loop {
+    public:
+        class Iterator {
+        public:
+            Iterator(benchmark::State::StateIterator it, IQPerfCounters* owner) : it_(it), owner_(owner) {}
+            benchmark::State::StateIterator::Value operator*() const { return *it_; }
+            Iterator& operator++() {
+                ++it_;
+                return *this;
+            }
+            bool operator!=(const Iterator& other) const {
+                if (it_ != other.it_) {
+                    return true;
+                }
+                owner_->stop();
+                return false;
+            }
+
+        private:
+            benchmark::State::StateIterator it_;
+            IQPerfCounters* owner_;
+        };
+
+        Iterator begin() { return Iterator(owner_->state_.begin(), owner_); }
+        Iterator end() {
+            // State::end() starts the timer; counting starts right after
+            Iterator e(owner_->state_.end(), owner_);
+            owner_->start();
+            return e;
+        }
+
+    private:
+        friend class IQPerfCounters;
+        explicit Loop(IQPerfCounters* owner) : owner_(owner) {}
+        IQPerfCounters* owner_;
+    };
+
+    Loop loop() { return Loop(this); }
+
+    // True when at least the cycle counter could be opened
+    static bool available() { return group().fds[CYCLES] >= 0; }
+
+private:
+    benchmark::State& state_;
+    bool counted_;
+    double values_[NUM_EVENTS];
+    bool valid_[NUM_EVENTS];
+
+    // One counter group per process, opened on first use and reused by
+    // every benchmark (benchmarks run one at a time on the main thread)
+    struct Group {
+        int fds[NUM_EVENTS];
+        uint64_t ids[NUM_EVENTS];
+        int leader;
+    };
+
+#if defined(IQ_PERF_AVAILABLE)
+    static int openEvent(uint32_t type, uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = (groupFd < 0) ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                           PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+    }
+
+    static uint64_t cacheMissEvent(uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+    static Group openGroup() {
+        Group g;
+        g.leader = -1;
+        for (int e = 0; e < NUM_EVENTS; e++) {
+            g.fds[e] = -1;
+            g.ids[e] = 0;
+        }
+
+#if defined(IQ_PERF_AVAILABLE)
+        const char* env = std::getenv("IQ_PERF");
+        if (env && std::strcmp(env, "0") == 0) {
+            return g;
+        }
+
+        const uint32_t types[NUM_EVENTS] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+        const uint64_t configs[NUM_EVENTS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            cacheMissEvent(PERF_COUNT_HW_CACHE_L1D), cacheMissEvent(PERF_COUNT_HW_CACHE_LL),
+            PERF_COUNT_HW_BRANCH_MISSES};
+
+        // Cycles lead the group; events the PMU lacks are left out
+        g.fds[CYCLES] = openEvent(types[CYCLES], configs[CYCLES], -1);
+        if (g.fds[CYCLES] < 0) {
+            std::fprintf(stderr, "perf counters unavailable (%s); reporting time only\n", std::strerror(errno));
+            return g;
+        }
+        g.leader = g.fds[CYCLES];
+        for (int e = 0; e < NUM_EVENTS; e++) {
+            if (e != CYCLES) {
+                g.fds[e] = openEvent(types[e], configs[e], g.leader);
+            }
+            if (g.fds[e] >= 0) {
+                ioctl(g.fds[e], PERF_EVENT_IOC_ID, &g.ids[e]);
+            }
+        }
+#endif
+        return g;
+    }
+
+    static const Group& group() {
+        static Group g = openGroup();
+        return g;
+    }
+
+    void start() {
+#if defined(IQ_PERF_AVAILABLE)
+        const Group& g = group();
+        if (g.leader >= 0) {
+            ioctl(g.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(g.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(IQ_PERF_AVAILABLE)
+        const Group& g = group();
+        if (g.leader < 0) {
+            return;
+        }
+        ioctl(g.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // nr, time_enabled, time_running, then {value, id} per event
+        uint64_t buffer[3 + 2 * NUM_EVENTS];
+        ssize_t bytes = read(g.leader, buffer, sizeof(buffer));
+        if (bytes < (ssize_t)(3 * sizeof(uint64_t)) || buffer[2] == 0) {
+            return;
+        }
+        double scale = (double)buffer[1] / (double)buffer[2];
+        for (uint64_t i = 0; i < buffer[0] && i < (uint64_t)NUM_EVENTS; i++) {
+            for (int e = 0; e < NUM_EVENTS; e++) {
+                if (g.fds[e] >= 0 && g.ids[e] == buffer[4 + 2 * i]) {
+                    values_[e] = buffer[3 + 2 * i] * scale;
+                    valid_[e] = true;
+                }
+            }
+        }
+        counted_ = valid_[CYCLES] && values_[CYCLES] > 0.0;
+#endif
+    }
+
+    void attach() {
+        // Per sample when the case reports items, otherwise per iteration
+        double items = (double)state_.items_processed();
+        const char* unit = "_per_sample";
+        if (items <= 0.0) {
+            items = (double)state_.iterations();
+            unit = "_per_iter";
+        }
+        const char* names[NUM_EVENTS] = {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+        for (int e = 0; e < NUM_EVENTS; e++) {
+            if (valid_[e]) {
+                state_.counters[std::string(names[e]) + unit] = values_[e] / items;
+            }
+        }
+        if (valid_[INSTRUCTIONS]) {
+            state_.counters["ipc"] = values_[INSTRUCTIONS] / values_[CYCLES];
+        }
+        double bytes = (double)state_.bytes_processed();
+        if (bytes > 0.0) {
+            state_.counters["bytes_per_cycle"] = bytes / values_[CYCLES];
+        }
+    }
+};
+
+#endif // BENCHMARK_PERF_H
@@ -1,13 +1,37 @@
 #include <benchmark/benchmark.h>
+#include "benchmark_latency.h"
+#include "benchmark_perf.h"
+#include "iq_arena.h"
+#include "iq_quality.h"
+#include "iq_resampler_reference.h"
 #include "iq_resampler_cpp.h"
+#include "iq_resampler_q15.h"
+#include "iq_ring_buffer.h"
+#include "iq_telemetry.h"
+#include "iq_thread.h"
 
 #ifdef USE_IPP
 #include "iq_resampler_ipp.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <random>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -42,6 +66,16 @@ std::vector<float> generateRandomIQSignal(int numSamples) {
     return signal;
 }
 
+// Quantize a float IQ signal to interleaved integer IQ (SC16 / SC8)
+template <typename T>
+std::vector<T> quantizeIQSignal(const std::vector<float>& signal, float fullScale) {
+    std::vector<T> out(signal.size());
+    for (size_t i = 0; i < signal.size(); i++) {
+        out[i] = (T)std::lrint(signal[i] * fullScale);
+    }
+    return out;
+}
+
 //==============================================================================
 // Pure C++ Implementation Benchmarks
 //==============================================================================
@@ -50,7 +84,9 @@ static void BM_CPP_120kTo100k_SmallBlock(benchmark::State& state) {
     IQResamplerCPP resampler(120000, 100000);
     auto input = generateIQSignal(1200, 120000, 10000);  // 10ms at 120kHz
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -64,7 +100,9 @@ static void BM_CPP_120kTo100k_MediumBlock(benchmark::State& state) {
     IQResamplerCPP resampler(120000, 100000);
     auto input = generateIQSignal(12000, 120000, 10000);  // 100ms at 120kHz
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -78,7 +116,9 @@ static void BM_CPP_120kTo100k_LargeBlock(benchmark::State& state) {
     IQResamplerCPP resampler(120000, 100000);
     auto input = generateIQSignal(120000, 120000, 10000);  // 1s at 120kHz
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -92,7 +132,9 @@ static void BM_CPP_48kTo44k(benchmark::State& state) {
     IQResamplerCPP resampler(48000, 44100);
     auto input = generateIQSignal(4800, 48000, 5000);  // 100ms at 48kHz
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -106,7 +148,9 @@ static void BM_CPP_Streaming(benchmark::State& state) {
     IQResamplerCPP resampler(120000, 100000);
     auto input = generateIQSignal(1200, 120000, 10000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         // Simulate streaming by processing multiple small blocks
         for (int i = 0; i < 10; i++) {
             auto output = resampler.process(input);
@@ -123,7 +167,9 @@ static void BM_CPP_RandomSignal(benchmark::State& state) {
     IQResamplerCPP resampler(120000, 100000);
     auto input = generateRandomIQSignal(12000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -133,6 +179,792 @@ static void BM_CPP_RandomSignal(benchmark::State& state) {
 }
 BENCHMARK(BM_CPP_RandomSignal);
 
+static void BM_CPP_ComplexSpan(benchmark::State& state) {
+    IQResamplerCPP resampler(120000, 100000);
+    auto signal = generateIQSignal(12000, 120000, 10000);
+    const std::complex<float>* input = reinterpret_cast<const std::complex<float>*>(signal.data());
+    std::vector<std::complex<float>> output(12000);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        size_t produced = resampler.process(input, 12000, output.data(), output.size());
+        benchmark::DoNotOptimize(produced);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * signal.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (signal.size() / 2));
+}
+BENCHMARK(BM_CPP_ComplexSpan);
+
+//==============================================================================
+// Pure C++ Sample Format Benchmarks (input format -> output format)
+//==============================================================================
+
+// Mode (index into the list below): the conversion runs in the
+// de-interleave ahead of the linear interpolator, in the load ahead of the
+// polyphase filter, and as one pass per block ahead of the FFT engine
+static const IQResamplerCPP::Mode FORMAT_MODES[] = {
+    IQResamplerCPP::Mode::Linear, IQResamplerCPP::Mode::Polyphase, IQResamplerCPP::Mode::PolyphaseFFT};
+static const char* const FORMAT_MODE_NAMES[] = {"Linear", "Polyphase", "PolyphaseFFT"};
+
+template <typename In, typename Process>
+static void runFormatBenchmark(benchmark::State& state, const std::vector<In>& input, Process process) {
+    IQResamplerCPP resampler(120000, 100000, 127, FORMAT_MODES[state.range(0)]);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = process(resampler, input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(In));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+    state.SetLabel(FORMAT_MODE_NAMES[state.range(0)]);
+}
+
+template <typename In>
+static std::vector<float> processF32(IQResamplerCPP& resampler, const std::vector<In>& input) {
+    return resampler.process(input);
+}
+
+template <typename In>
+static std::vector<int16_t> processSC16(IQResamplerCPP& resampler, const std::vector<In>& input) {
+    return resampler.processSC16(input);
+}
+
+static void BM_CPP_Format_F32_F32(benchmark::State& state) {
+    runFormatBenchmark(state, generateIQSignal(12000, 120000, 10000), processF32<float>);
+}
+BENCHMARK(BM_CPP_Format_F32_F32)->ArgName("mode")->DenseRange(0, 2);
+
+static void BM_CPP_Format_SC16_F32(benchmark::State& state) {
+    runFormatBenchmark(state, quantizeIQSignal<int16_t>(generateIQSignal(12000, 120000, 10000), 32767.0f),
+                       processF32<int16_t>);
+}
+BENCHMARK(BM_CPP_Format_SC16_F32)->ArgName("mode")->DenseRange(0, 2);
+
+static void BM_CPP_Format_SC8_F32(benchmark::State& state) {
+    runFormatBenchmark(state, quantizeIQSignal<int8_t>(generateIQSignal(12000, 120000, 10000), 127.0f),
+                       processF32<int8_t>);
+}
+BENCHMARK(BM_CPP_Format_SC8_F32)->ArgName("mode")->DenseRange(0, 2);
+
+static void BM_CPP_Format_F32_SC16(benchmark::State& state) {
+    runFormatBenchmark(state, generateIQSignal(12000, 120000, 10000), processSC16<float>);
+}
+BENCHMARK(BM_CPP_Format_F32_SC16)->ArgName("mode")->DenseRange(0, 2);
+
+static void BM_CPP_Format_SC16_SC16(benchmark::State& state) {
+    runFormatBenchmark(state, quantizeIQSignal<int16_t>(generateIQSignal(12000, 120000, 10000), 32767.0f),
+                       processSC16<int16_t>);
+}
+BENCHMARK(BM_CPP_Format_SC16_SC16)->ArgName("mode")->DenseRange(0, 2);
+
+static void BM_CPP_Format_SC8_SC16(benchmark::State& state) {
+    runFormatBenchmark(state, quantizeIQSignal<int8_t>(generateIQSignal(12000, 120000, 10000), 127.0f),
+                       processSC16<int8_t>);
+}
+BENCHMARK(BM_CPP_Format_SC8_SC16)->ArgName("mode")->DenseRange(0, 2);
+
+//==============================================================================
+// Polyphase (float) and Fixed-Point (Q15) Benchmarks
+//==============================================================================
+
+static void BM_CPP_Polyphase_120kTo100k(benchmark::State& state) {
+    IQResamplerCPP resampler(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    auto input = generateIQSignal(12000, 120000, 10000);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler.process(input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+}
+BENCHMARK(BM_CPP_Polyphase_120kTo100k);
+
+// L = 147 branches: the shortest prototype that gives every branch a real
+// filter is IQFilterDesign::minimumTaps (8 taps per branch).
+static void BM_CPP_Polyphase_48kTo44k(benchmark::State& state) {
+    IQResamplerCPP resampler(48000, 44100, IQFilterDesign::minimumTaps(48000, 44100),
+                             IQResamplerCPP::Mode::Polyphase);
+    auto input = generateIQSignal(4800, 48000, 5000);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler.process(input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+}
+BENCHMARK(BM_CPP_Polyphase_48kTo44k);
+
+// Spec-driven Kaiser prototype (80 dB, 0.1 dB ripple, passband to 80%):
+// taps per branch follow the ratio instead of a fixed total
+static void BM_CPP_KaiserSpec(benchmark::State& state) {
+    int inputRate = state.range(0);
+    int outputRate = state.range(1);
+    IQResamplerCPP resampler(inputRate, outputRate, IQFilterSpec(0.8, 80.0, 0.1));
+    auto input = generateIQSignal(inputRate / 10, inputRate, inputRate / 12.0f);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler.process(input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+    state.counters["branch_taps"] = resampler.branchTaps();
+}
+BENCHMARK(BM_CPP_KaiserSpec)->Args({120000, 100000})->Args({48000, 44100})->Args({100000, 50000});
+
+// 2:1 decimation (single symmetric branch), folded vs generic kernel.
+// Build target benchmark_cpp_scalar runs the same cases without SIMD.
+static void BM_CPP_SymmetricFold(benchmark::State& state) {
+    int taps = state.range(0);
+    IQResamplerCPP resampler(100000, 50000, taps, IQResamplerCPP::Mode::PolyphaseDirect);
+    resampler.setSymmetricFolding(state.range(1) != 0);
+    auto input = generateIQSignal(10000, 100000, 10000);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler.process(input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+}
+BENCHMARK(BM_CPP_SymmetricFold)->ArgNames({"taps", "fold"})
+    ->Args({31, 0})->Args({31, 1})->Args({63, 0})->Args({63, 1})->Args({127, 0})->Args({127, 1});
+
+// Q15 through caller buffers; scratch sits in an arena sized by reserve(),
+// as for the BM_CPP_* cases
+template <typename T>
+static void runQ15Benchmark(benchmark::State& state, IQResamplerQ15& resampler, const std::vector<T>& input) {
+    std::vector<int16_t> output(2 * resampler.maxOutputSamplesFor(input.size() / 2));
+    resampler.reserve(input.size() / 2);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        size_t produced = resampler.processSC16(input.data(), input.size() / 2, output.data(), output.size() / 2);
+        benchmark::DoNotOptimize(produced);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(T));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+}
+
+static void BM_Q15_120kTo100k_SC16(benchmark::State& state) {
+    IQResamplerQ15 resampler(120000, 100000);
+    runQ15Benchmark(state, resampler,
+                    quantizeIQSignal<int16_t>(generateIQSignal(12000, 120000, 10000), 16384.0f));
+}
+BENCHMARK(BM_Q15_120kTo100k_SC16);
+
+static void BM_Q15_120kTo100k_SC8(benchmark::State& state) {
+    IQResamplerQ15 resampler(120000, 100000);
+    runQ15Benchmark(state, resampler,
+                    quantizeIQSignal<int8_t>(generateIQSignal(12000, 120000, 10000), 64.0f));
+}
+BENCHMARK(BM_Q15_120kTo100k_SC8);
+
+static void BM_Q15_120kTo100k_Float(benchmark::State& state) {
+    IQResamplerQ15 resampler(120000, 100000);
+    auto input = generateIQSignal(12000, 120000, 10000);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler.process(input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+}
+BENCHMARK(BM_Q15_120kTo100k_Float);
+
+static void BM_Q15_48kTo44k_SC16(benchmark::State& state) {
+    IQResamplerQ15 resampler(48000, 44100, IQFilterDesign::minimumTaps(48000, 44100));
+    runQ15Benchmark(state, resampler,
+                    quantizeIQSignal<int16_t>(generateIQSignal(4800, 48000, 5000), 16384.0f));
+}
+BENCHMARK(BM_Q15_48kTo44k_SC16);
+
+//==============================================================================
+// Long Filters: Direct-Form Polyphase vs FFT Overlap-Save
+//==============================================================================
+
+static void BM_CPP_LongFilter_Direct(benchmark::State& state) {
+    int taps = state.range(0);
+    IQResamplerCPP resampler(120000, 100000, taps, IQResamplerCPP::Mode::PolyphaseDirect);
+    auto input = generateIQSignal(12000, 120000, 10000);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler.process(input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+}
+BENCHMARK(BM_CPP_LongFilter_Direct)->Arg(127)->Arg(511)->Arg(2047)->Arg(8191);
+
+static void BM_CPP_LongFilter_FFT(benchmark::State& state) {
+    int taps = state.range(0);
+    IQResamplerCPP resampler(120000, 100000, taps, IQResamplerCPP::Mode::PolyphaseFFT);
+    auto input = generateIQSignal(12000, 120000, 10000);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler.process(input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+}
+BENCHMARK(BM_CPP_LongFilter_FFT)->Arg(127)->Arg(511)->Arg(2047)->Arg(8191);
+
+//==============================================================================
+// Pull Mode: fixed-size output requests fed from a ring buffer
+//==============================================================================
+
+static void runPullBenchmark(benchmark::State& state, int taps) {
+    const size_t request = state.range(0);
+    IQResamplerCPP resampler(120000, 100000, taps, IQResamplerCPP::Mode::Polyphase);
+    IQRingBuffer ring(16384);
+    resampler.setInputSource(ring);
+
+    auto signal = generateIQSignal(12000, 120000, 10000);
+    const std::complex<float>* input = reinterpret_cast<const std::complex<float>*>(signal.data());
+    std::vector<std::complex<float> > output(request);
+    size_t inputPos = 0;
+    size_t produced = 0;
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        // Keep the ring topped up, as a receive thread would
+        while (ring.space() > 0) {
+            size_t n = ring.write(input + inputPos, std::min(ring.space(), 12000 - inputPos));
+            inputPos = (inputPos + n) % 12000;
+        }
+        produced += resampler.pull(output.data(), request);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(produced);
+}
+
+static void BM_CPP_Pull(benchmark::State& state) {
+    runPullBenchmark(state, 127);
+}
+BENCHMARK(BM_CPP_Pull)->Arg(64)->Arg(480)->Arg(4096);
+
+// Same through the FFT engine (410 taps per branch): small requests and
+// the single-sample overflow step are too short for a frame transform
+static void BM_CPP_Pull_FFT(benchmark::State& state) {
+    runPullBenchmark(state, 2047);
+}
+BENCHMARK(BM_CPP_Pull_FFT)->Arg(64)->Arg(480)->Arg(4096);
+
+//==============================================================================
+// Burst Mode: TDMA-style bursts with flush per burst, batched vs per burst
+//==============================================================================
+
+// Burst lengths shared by both burst benchmarks (fixed seed), from a tenth
+// of maxLength up to maxLength
+static std::vector<size_t> burstLengths(int numBursts, int maxLength) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(maxLength / 10, maxLength);
+    std::vector<size_t> lengths(numBursts);
+    for (int i = 0; i < numBursts; i++) {
+        lengths[i] = dis(gen);
+    }
+    return lengths;
+}
+
+// range(0) bursts of up to range(1) samples, through processBursts() or,
+// as the baseline, reset() + process() + flush() per burst into the same
+// caller buffer, so only the per-burst setup differs
+static void runBurstBenchmark(benchmark::State& state, bool batched) {
+    IQResamplerCPP resampler(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    auto lengths = burstLengths(state.range(0), state.range(1));
+    auto signal = generateIQSignal(state.range(1), 120000, 10000);
+    const std::complex<float>* samples = reinterpret_cast<const std::complex<float>*>(signal.data());
+
+    std::vector<IQBurst> bursts;
+    size_t totalSamples = 0;
+    for (size_t i = 0; i < lengths.size(); i++) {
+        bursts.push_back(IQBurst(samples, lengths[i], (int64_t)i));
+        totalSamples += lengths[i];
+    }
+    std::vector<std::complex<float> > output(resampler.outputSamplesForBursts(bursts.data(), bursts.size()));
+    std::vector<IQBurstOutput> results(bursts.size());
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        if (batched) {
+            resampler.processBursts(bursts.data(), bursts.size(), output.data(), output.size(), results.data());
+        } else {
+            size_t produced = 0;
+            for (const IQBurst& burst : bursts) {
+                resampler.reset();
+                produced += resampler.process(burst.samples, burst.numSamples,
+                                              output.data() + produced, output.size() - produced);
+                produced += resampler.flush(output.data() + produced, output.size() - produced);
+            }
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * totalSamples);
+    state.counters["bursts"] = benchmark::Counter((double)state.iterations() * bursts.size(),
+                                                  benchmark::Counter::kIsRate);
+}
+
+static void BM_CPP_Bursts_Batched(benchmark::State& state) {
+    runBurstBenchmark(state, true);
+}
+BENCHMARK(BM_CPP_Bursts_Batched)->Args({100, 64})->Args({100, 2000});
+
+static void BM_CPP_Bursts_PerCall(benchmark::State& state) {
+    runBurstBenchmark(state, false);
+}
+BENCHMARK(BM_CPP_Bursts_PerCall)->Args({100, 64})->Args({100, 2000});
+
+//==============================================================================
+// Sample Tags: cost of tagging vs untagged blocks
+//==============================================================================
+
+static void BM_CPP_Tagged(benchmark::State& state) {
+    const int tagsPerBlock = state.range(0);
+    IQResamplerCPP resampler(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    auto signal = generateIQSignal(1200, 120000, 10000);
+    const std::complex<float>* input = reinterpret_cast<const std::complex<float>*>(signal.data());
+    std::vector<std::complex<float> > output(resampler.outputSamplesFor(1200) + 1);
+    IQOutputTag tags[64];
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        for (int t = 0; t < tagsPerBlock; t++) {
+            resampler.addTag(resampler.inputPosition() + t * (1200 / tagsPerBlock), t);
+        }
+        resampler.process(input, 1200, output.data(), output.size());
+        resampler.takeTags(tags, 64);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1200);
+}
+BENCHMARK(BM_CPP_Tagged)->Arg(0)->Arg(1)->Arg(16);
+
+//==============================================================================
+// Telemetry: cost of the per-call bookkeeping (two time stamps, relaxed
+// counter updates, one histogram bucket), alone and as a share of
+// process() calls of a given block size. Build with
+// -DENABLE_TELEMETRY=OFF to compare against no telemetry at all.
+//==============================================================================
+
+static void BM_Telemetry_Record(benchmark::State& state) {
+    IQTelemetry telemetry;
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        IQTelemetry::Ticks start = IQTelemetry::now();
+        telemetry.record(start, 1200, 1000);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["enabled"] = IQTelemetry::ENABLED;
+}
+BENCHMARK(BM_Telemetry_Record);
+
+static void BM_CPP_TelemetryOverhead(benchmark::State& state) {
+    const size_t blockSamples = state.range(0);
+    IQResamplerCPP resampler(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    auto signal = generateIQSignal(blockSamples, 120000, 10000);
+    const std::complex<float>* input = reinterpret_cast<const std::complex<float>*>(signal.data());
+    std::vector<std::complex<float> > output(resampler.outputSamplesFor(blockSamples) + 1);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        resampler.process(input, blockSamples, output.data(), output.size());
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * blockSamples);
+
+    // Per-call cost and the share of it the bookkeeping takes
+    IQTelemetrySnapshot s = resampler.telemetry().snapshot();
+    if (s.calls > 0) {
+        IQTelemetry probe;
+        const int probes = 100000;
+        IQTelemetry::Ticks t0 = IQTelemetry::now();
+        for (int i = 0; i < probes; i++) {
+            probe.record(IQTelemetry::now(), blockSamples, 0);
+        }
+        double recordTicks = (double)(IQTelemetry::now() - t0) / probes;
+        double callTicks = (double)s.totalTicks / s.calls;
+        state.counters["call_ns"] = s.meanNs();
+        state.counters["p99_call_ns"] = s.percentileNs(0.99);
+        state.counters["overhead_pct"] = 100.0 * recordTicks / (callTicks + recordTicks);
+    }
+}
+BENCHMARK(BM_CPP_TelemetryOverhead)->ArgName("block")->Arg(16)->Arg(120)->Arg(1200)->Arg(12000);
+
+//==============================================================================
+// Memory Placement: scratch, input and output on the local vs a remote NUMA
+// node, with and without huge pages. Pin the process to one node (e.g.
+// numactl --cpunodebind=0) so "local" stays local for the whole run.
+//==============================================================================
+
+static void BM_CPP_MemoryPlacement(benchmark::State& state) {
+    const bool remote = state.range(0) != 0;
+    const bool hugePages = state.range(1) != 0;
+    const size_t blockSamples = 120000;
+
+    int local = IQArena::currentNumaNode();
+    int nodes = IQArena::numaNodeCount();
+    if (remote && (local < 0 || nodes < 2)) {
+        state.SkipWithError("Needs a second NUMA node");
+        return;
+    }
+    IQMemoryPolicy policy(hugePages, remote ? (local + 1) % nodes : IQMemoryPolicy::LOCAL_NODE);
+
+    IQResamplerCPP resampler(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    resampler.reserve(blockSamples, policy);
+
+    // Stream buffers from an arena with the same placement
+    size_t outputSamples = resampler.outputSamplesFor(blockSamples) + 1;
+    IQArena buffers(IQArena::bytesFor<std::complex<float> >(blockSamples) +
+                    IQArena::bytesFor<std::complex<float> >(outputSamples), policy);
+    std::complex<float>* input = buffers.allocate<std::complex<float> >(blockSamples);
+    std::complex<float>* output = buffers.allocate<std::complex<float> >(outputSamples);
+    auto signal = generateIQSignal(blockSamples, 120000, 10000);
+    std::copy(signal.begin(), signal.end(), reinterpret_cast<float*>(input));
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        resampler.process(input, blockSamples, output, outputSamples);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetItemsProcessed(state.iterations() * blockSamples);
+    state.counters["node"] = buffers.numaNode();
+    state.counters["huge_pages"] = buffers.usesHugePages();
+}
+BENCHMARK(BM_CPP_MemoryPlacement)->ArgNames({"remote", "huge"})
+    ->Args({0, 0})->Args({0, 1})->Args({1, 0})->Args({1, 1});
+
+//==============================================================================
+// Latency Jitter: a pipeline worker woken every 1 ms (120 samples at
+// 120 kHz), with and without pinning to one CPU and SCHED_FIFO +
+// mlockall. Counters are percentiles of the per-block latency (scheduled
+// wake-up to output written) in microseconds. Real-time scheduling needs
+// root or CAP_SYS_NICE; "rt_applied" says whether it took effect.
+//==============================================================================
+
+// CPUs this process may run on, as it started (pinned benchmarks restore
+// the benchmark thread to this set)
+static const std::vector<int>& allowedCpus() {
+    static const std::vector<int> cpus = []() {
+        std::vector<int> list;
+#if defined(__linux__)
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &set)) {
+                    list.push_back(cpu);
+                }
+            }
+        }
+#endif
+        if (list.empty()) {
+            list.push_back(0);
+        }
+        return list;
+    }();
+    return cpus;
+}
+
+// Highest CPU this process may run on (isolated cores are usually last)
+static int lastAllowedCpu() {
+    return allowedCpus().back();
+}
+
+static void BM_CPP_WorkerJitter(benchmark::State& state) {
+    const size_t blockSamples = 120;
+    const size_t numBlocks = 2000;
+
+    IQThreadConfig config;
+    if (state.range(0)) {
+        config.cpus.push_back(lastAllowedCpu());
+    }
+    if (state.range(1)) {
+        config.scheduling = IQThreadConfig::Scheduling::Fifo;
+        config.priority = 80;
+        config.lockMemory = true;
+    }
+
+    auto signal = generateIQSignal(blockSamples * numBlocks, 120000, 10000);
+    const std::complex<float>* input = reinterpret_cast<const std::complex<float>*>(signal.data());
+    IQLatencyRecorder recorder("worker_jitter_pinned" + std::to_string(state.range(0)) +
+                               "_fifo" + std::to_string(state.range(1)), numBlocks);
+    IQThreadStatus status;
+    IQDeadlineStats stats = IQDeadlineStats();
+
+    for (auto _ : state) {
+        IQResamplerCPP resampler(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+        IQRingBuffer in(blockSamples * numBlocks);
+        IQRingBuffer out(blockSamples * numBlocks);
+        in.write(input, blockSamples * numBlocks);
+
+        IQResamplerWorker worker(resampler, in, out, blockSamples, config);
+        worker.setLatencyObserver([&recorder](int64_t latency) { recorder.record(latency); });
+        worker.start();
+        while (worker.stats().blocks < numBlocks) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        worker.stop();
+        status = worker.threadStatus();
+        stats = worker.stats();
+    }
+
+    recorder.report(state);
+    state.counters["missed"] = stats.missedDeadlines;
+    state.counters["rt_applied"] = state.range(1) && status.schedulingApplied && status.memoryLocked;
+}
+BENCHMARK(BM_CPP_WorkerJitter)->ArgNames({"pinned", "fifo"})
+    ->Args({0, 0})->Args({1, 0})->Args({0, 1})->Args({1, 1})
+    ->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+//==============================================================================
+// Paced Latency: a stream fed at its real rate (one block per block
+// period, on an absolute schedule) on the benchmark thread, reporting the
+// tail of the per-block latency instead of the mean: scheduled start to
+// output done ("p*_us", wake-up jitter included) and process() alone
+// ("proc_p*_us"). api 0 is caller-owned buffers (no allocation), api 1
+// the std::vector overload, which allocates its output every block.
+// IQ_LATENCY_CSV=<dir> records every block to CSV (benchmark_latency.h).
+//==============================================================================
+
+static void BM_CPP_PacedLatency(benchmark::State& state) {
+    typedef std::chrono::steady_clock Clock;
+    const size_t blockSamples = state.range(0);
+    const bool vectorApi = state.range(1) != 0;
+    const size_t numBlocks = 2000;  // Enough blocks for a p99.9
+    const int inputRate = 120000;
+    const Clock::duration period = std::chrono::nanoseconds((int64_t)blockSamples * 1000000000 / inputRate);
+
+    auto signal = generateIQSignal(blockSamples, inputRate, 10000);
+    const std::complex<float>* input = reinterpret_cast<const std::complex<float>*>(signal.data());
+    IQLatencyRecorder recorder("paced_latency_block" + std::to_string(blockSamples) +
+                               "_api" + std::to_string(state.range(1)), numBlocks);
+    size_t missed = 0;
+
+    for (auto _ : state) {
+        IQResamplerCPP resampler(inputRate, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+        resampler.reserve(blockSamples);
+        std::vector<std::complex<float> > output(resampler.outputSamplesFor(blockSamples) + 1);
+
+        const Clock::time_point start = Clock::now();
+        for (size_t k = 0; k < numBlocks; k++) {
+            const Clock::time_point scheduled = start + (int64_t)k * period;
+            std::this_thread::sleep_until(scheduled);
+
+            const Clock::time_point begin = Clock::now();
+            if (vectorApi) {
+                auto result = resampler.process(signal);
+                benchmark::DoNotOptimize(result.data());
+            } else {
+                resampler.process(input, blockSamples, output.data(), output.size());
+                benchmark::DoNotOptimize(output.data());
+            }
+            const Clock::time_point done = Clock::now();
+
+            const Clock::duration latency = done - scheduled;
+            missed += latency > period;
+            recorder.record(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count(),
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(done - begin).count());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numBlocks * blockSamples);
+    recorder.report(state);
+    state.counters["missed"] = missed;
+}
+BENCHMARK(BM_CPP_PacedLatency)->ArgNames({"block", "api"})
+    ->Args({120, 0})->Args({120, 1})->Args({480, 0})->Args({480, 1})
+    ->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+//==============================================================================
+// Multi-core Scaling: N threads (powers of two up to every core), each with
+// its own resampler, input and output, built on that thread. The aggregate
+// items_per_second against N x the single-thread figure shows where the
+// streams stop scaling; per_thread_items is the average stream's rate.
+// block 1200 keeps each stream in its private caches, block 262144 (6 MB of
+// buffers per stream) streams through L3 and memory, so contention for
+// shared cache and bandwidth shows up there. pin 1 puts thread i on the
+// i-th allowed CPU. Hardware counters are per thread, so they are not
+// attached here.
+//==============================================================================
+
+// Caller-buffer processing of interleaved I/Q for either backend, and the
+// output (IQ samples) a reused buffer needs for any block of n samples
+static size_t processBlock(IQResamplerCPP& resampler, const std::vector<float>& input, std::vector<float>& output) {
+    return resampler.process(IQSpan<const float>(input), IQSpan<float>(output));
+}
+
+static size_t blockOutputCapacity(const IQResamplerCPP& resampler, size_t n) {
+    return resampler.maxOutputSamplesFor(n);
+}
+
+#ifdef USE_IPP
+static size_t processBlock(IQResamplerIPP& resampler, const std::vector<float>& input, std::vector<float>& output) {
+    return resampler.process(input.data(), input.size() / 2, output.data(), output.size() / 2);
+}
+
+// IPP restarts its time every block, so every block gives the same count
+static size_t blockOutputCapacity(const IQResamplerIPP& resampler, size_t n) {
+    return resampler.outputSamplesFor(n);
+}
+#endif
+
+template <typename Resampler>
+static void runScalingBenchmark(benchmark::State& state, const std::function<Resampler*()>& make) {
+    const size_t blockSamples = state.range(0);
+    const bool pin = state.range(1) != 0;
+
+#if defined(__linux__)
+    cpu_set_t saved;
+    sched_getaffinity(0, sizeof(saved), &saved);
+#endif
+    IQThreadStatus status;
+    if (pin) {
+        IQThreadConfig config;
+        config.cpus.push_back(allowedCpus()[state.thread_index() % allowedCpus().size()]);
+        status = applyThreadConfig(config);
+    }
+
+    // Everything the stream touches is allocated here, on its own thread,
+    // so the timed loop only measures the resampler and memory traffic
+    std::unique_ptr<Resampler> resampler(make());
+    resampler->reserve(blockSamples);
+    auto input = generateIQSignal(blockSamples, 120000, 10000 + 100 * state.thread_index());
+    std::vector<float> output(2 * blockOutputCapacity(*resampler, blockSamples));
+
+    for (auto _ : state) {
+        size_t produced = processBlock(*resampler, input, output);
+        benchmark::DoNotOptimize(produced);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+#if defined(__linux__)
+    // Benchmark thread 0 is the main thread: give it back its CPUs
+    if (pin) {
+        sched_setaffinity(0, sizeof(saved), &saved);
+    }
+#endif
+
+    // Summed over threads: aggregate rate, per-thread average
+    state.SetItemsProcessed(state.iterations() * blockSamples);
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.counters["per_thread_items"] = benchmark::Counter(state.iterations() * blockSamples,
+                                                            benchmark::Counter::kAvgThreadsRate);
+    state.counters["pinned"] = benchmark::Counter(pin && status.affinityApplied,
+                                                  benchmark::Counter::kAvgThreads);
+}
+
+static void scalingArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"block", "pin"})->ArgsProduct({{1200, 262144}, {0, 1}});
+    b->ThreadRange(1, std::max(1u, std::thread::hardware_concurrency()));
+    b->UseRealTime();
+}
+
+static void BM_Scaling_CPP(benchmark::State& state) {
+    runScalingBenchmark<IQResamplerCPP>(state, []() {
+        return new IQResamplerCPP(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    });
+}
+BENCHMARK(BM_Scaling_CPP)->Apply(scalingArgs);
+
+#ifdef USE_IPP
+static void BM_Scaling_IPP(benchmark::State& state) {
+    runScalingBenchmark<IQResamplerIPP>(state, []() { return new IQResamplerIPP(120000, 100000); });
+}
+BENCHMARK(BM_Scaling_IPP)->Apply(scalingArgs);
+#endif
+
+// False sharing: every stream bumps a per-stream counter after each small
+// block (as a monitor's sample count would be). Packed, all counters share
+// one cache line that bounces between cores; padded, each has its own line.
+// Only single-writer relaxed stores, so any slowdown is the line bouncing.
+struct PaddedCounter {
+    alignas(64) std::atomic<uint64_t> value;
+};
+static std::atomic<uint64_t> packedCounters[64];
+static PaddedCounter paddedCounters[64];
+
+static void BM_Scaling_FalseSharing(benchmark::State& state) {
+    const size_t blockSamples = 32;
+    const bool padded = state.range(0) != 0;
+    std::atomic<uint64_t>& counter = padded ? paddedCounters[state.thread_index() % 64].value
+                                            : packedCounters[state.thread_index() % 64];
+
+#if defined(__linux__)
+    cpu_set_t saved;
+    sched_getaffinity(0, sizeof(saved), &saved);
+#endif
+    IQThreadConfig config;
+    config.cpus.push_back(allowedCpus()[state.thread_index() % allowedCpus().size()]);
+    applyThreadConfig(config);
+
+    IQResamplerCPP resampler(120000, 100000, IQFilterDesign::minimumTaps(120000, 100000),
+                             IQResamplerCPP::Mode::Polyphase);
+    auto signal = generateIQSignal(blockSamples, 120000, 10000);
+    const std::complex<float>* input = reinterpret_cast<const std::complex<float>*>(signal.data());
+    std::vector<std::complex<float> > output(resampler.maxOutputSamplesFor(blockSamples));
+
+    for (auto _ : state) {
+        size_t produced = resampler.process(input, blockSamples, output.data(), output.size());
+        counter.store(counter.load(std::memory_order_relaxed) + produced, std::memory_order_relaxed);
+    }
+
+#if defined(__linux__)
+    sched_setaffinity(0, sizeof(saved), &saved);
+#endif
+    state.SetItemsProcessed(state.iterations() * blockSamples);
+    state.counters["per_thread_items"] = benchmark::Counter(state.iterations() * blockSamples,
+                                                            benchmark::Counter::kAvgThreadsRate);
+}
+BENCHMARK(BM_Scaling_FalseSharing)->ArgName("padded")->Arg(0)->Arg(1)
+    ->ThreadRange(1, std::max(1u, std::thread::hardware_concurrency()))->UseRealTime();
+
 //==============================================================================
 // Intel IPP Implementation Benchmarks
 //==============================================================================
@@ -143,7 +975,9 @@ static void BM_IPP_120kTo100k_SmallBlock(benchmark::State& state) {
     IQResamplerIPP resampler(120000, 100000);
     auto input = generateIQSignal(1200, 120000, 10000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -157,7 +991,9 @@ static void BM_IPP_120kTo100k_MediumBlock(benchmark::State& state) {
     IQResamplerIPP resampler(120000, 100000);
     auto input = generateIQSignal(12000, 120000, 10000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -171,7 +1007,9 @@ static void BM_IPP_120kTo100k_LargeBlock(benchmark::State& state) {
     IQResamplerIPP resampler(120000, 100000);
     auto input = generateIQSignal(120000, 120000, 10000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -185,7 +1023,9 @@ static void BM_IPP_48kTo44k(benchmark::State& state) {
     IQResamplerIPP resampler(48000, 44100);
     auto input = generateIQSignal(4800, 48000, 5000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -199,7 +1039,9 @@ static void BM_IPP_Streaming(benchmark::State& state) {
     IQResamplerIPP resampler(120000, 100000);
     auto input = generateIQSignal(1200, 120000, 10000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         for (int i = 0; i < 10; i++) {
             auto output = resampler.process(input);
             benchmark::DoNotOptimize(output);
@@ -215,7 +1057,9 @@ static void BM_IPP_RandomSignal(benchmark::State& state) {
     IQResamplerIPP resampler(120000, 100000);
     auto input = generateRandomIQSignal(12000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -230,7 +1074,9 @@ static void BM_IPP_DifferentRolloff(benchmark::State& state) {
     IQResamplerIPP resampler(120000, 100000, rolloff);
     auto input = generateIQSignal(12000, 120000, 10000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -242,6 +1088,141 @@ BENCHMARK(BM_IPP_DifferentRolloff)->Arg(50)->Arg(70)->Arg(90)->Arg(95);
 
 #endif // USE_IPP
 
+//==============================================================================
+// Quality vs Speed: 120 kHz -> 100 kHz throughput (12000-sample blocks)
+// next to the quality the same configuration delivers (IQQuality, measured
+// once per run against exact tones): snr_db (multi-tone), sfdr_db,
+// ripple_db (passband sweep) and stopband_db (alias sweep). Pick settings
+// on the Pareto front of MSamples/s against these, not on speed alone.
+//==============================================================================
+
+// Time process() on a 10 kHz tone and report the quality of a fresh
+// resampler of the same configuration
+template <typename Resampler>
+static void runQualityBenchmark(benchmark::State& state, const std::function<Resampler*()>& make) {
+    std::unique_ptr<Resampler> resampler(make());
+    auto input = generateIQSignal(12000, 120000, 10000);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler->process(input);
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+
+    IQQualityReport quality = IQQuality::measure([&make]() {
+        std::shared_ptr<Resampler> r(make());
+        return IQQuality::ProcessFunction([r](const std::vector<float>& in) { return r->process(in); });
+    }, 120000, 100000);
+    state.counters["snr_db"] = quality.snrDb;
+    state.counters["sfdr_db"] = quality.sfdrDb;
+    state.counters["ripple_db"] = quality.passbandRippleDb;
+    state.counters["stopband_db"] = quality.stopbandRejectionDb;
+}
+
+// Mode (index into the list below) and prototype taps
+static void BM_Quality_CPP(benchmark::State& state) {
+    const IQResamplerCPP::Mode modes[] = {
+        IQResamplerCPP::Mode::Linear, IQResamplerCPP::Mode::Polyphase,
+        IQResamplerCPP::Mode::LowLatency, IQResamplerCPP::Mode::PolyphaseFFT};
+    const char* names[] = {"Linear", "Polyphase", "LowLatency", "PolyphaseFFT"};
+    IQResamplerCPP::Mode mode = modes[state.range(0)];
+    int taps = state.range(1);
+
+    runQualityBenchmark<IQResamplerCPP>(state, [mode, taps]() {
+        return new IQResamplerCPP(120000, 100000, taps, mode);
+    });
+    state.SetLabel(names[state.range(0)]);
+}
+BENCHMARK(BM_Quality_CPP)->ArgNames({"mode", "taps"})
+    ->Args({0, 127})
+    ->Args({1, 63})->Args({1, 127})->Args({1, 255})->Args({1, 511})
+    ->Args({2, 127})
+    ->Args({3, 2047});
+
+// Spec-driven Kaiser prototype (passband 0.8) for a stopband attenuation
+static void BM_Quality_CPP_Spec(benchmark::State& state) {
+    IQFilterSpec spec(0.8, (double)state.range(0), 0.1);
+    runQualityBenchmark<IQResamplerCPP>(state, [spec]() {
+        return new IQResamplerCPP(120000, 100000, spec);
+    });
+}
+BENCHMARK(BM_Quality_CPP_Spec)->ArgName("atten_db")->Arg(60)->Arg(80)->Arg(100)->Arg(120);
+
+static void BM_Quality_Q15(benchmark::State& state) {
+    int taps = state.range(0);
+    runQualityBenchmark<IQResamplerQ15>(state, [taps]() {
+        return new IQResamplerQ15(120000, 100000, taps);
+    });
+}
+BENCHMARK(BM_Quality_Q15)->ArgName("taps")->Arg(127);
+
+#ifdef USE_IPP
+static void BM_Quality_IPP(benchmark::State& state) {
+    int taps = state.range(0);
+    runQualityBenchmark<IQResamplerIPP>(state, [taps]() {
+        return new IQResamplerIPP(120000, 100000, 0.9f, taps);
+    });
+}
+BENCHMARK(BM_Quality_IPP)->ArgName("taps")->Arg(127);
+#endif
+
+//==============================================================================
+// Kernel Error Budget: each fast kernel against IQResamplerReference running
+// the same prototype in long double, next to its speed. err_db is the rms
+// error relative to the signal (full-band noise), max_err the largest
+// deviation. Run benchmark_cpp_scalar for the plain C++ kernels.
+//==============================================================================
+
+template <typename Resampler>
+static void runErrorBudgetBenchmark(benchmark::State& state, Resampler& resampler,
+                                    const std::vector<float>& prototype, int inputRate, int outputRate) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dis(-0.5f, 0.5f);
+    std::vector<float> input(12000 * 2);
+    for (auto& v : input) {
+        v = dis(gen);
+    }
+
+    // Error budget from a fresh stream, before timing
+    IQResamplerReference reference(inputRate, outputRate, prototype);
+    auto expected = reference.process(input);
+    auto output = resampler.process(input);
+    IQErrorBudget budget = IQResamplerReference::compare(expected.data(), output.data(),
+                                                         std::min(expected.size(), output.size() / 2));
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto out = resampler.process(input);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * (input.size() / 2));
+    state.counters["err_db"] = budget.errorDb;
+    state.counters["max_err"] = budget.maxAbsError;
+}
+
+// Mode: 0 direct, 1 FFT, 2 low latency; ratio: 0 120k->100k, 1 120k->60k
+// (single symmetric branch, folded kernel)
+static void BM_ErrorBudget_CPP(benchmark::State& state) {
+    const IQResamplerCPP::Mode modes[] = {
+        IQResamplerCPP::Mode::PolyphaseDirect, IQResamplerCPP::Mode::PolyphaseFFT,
+        IQResamplerCPP::Mode::LowLatency};
+    const int outputRate = state.range(1) ? 60000 : 100000;
+    IQResamplerCPP resampler(120000, outputRate, state.range(0) == 1 ? 1023 : 127, modes[state.range(0)]);
+    runErrorBudgetBenchmark(state, resampler, resampler.filterCoefficients(), 120000, outputRate);
+}
+BENCHMARK(BM_ErrorBudget_CPP)->ArgNames({"mode", "ratio"})
+    ->Args({0, 0})->Args({1, 0})->Args({2, 0})->Args({0, 1})->Args({1, 1});
+
+static void BM_ErrorBudget_Q15(benchmark::State& state) {
+    IQResamplerQ15 resampler(120000, 100000, 127);
+    IQResamplerCPP floating(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);  // Same prototype
+    runErrorBudgetBenchmark(state, resampler, floating.filterCoefficients(), 120000, 100000);
+}
+BENCHMARK(BM_ErrorBudget_Q15);
+
 //==============================================================================
 // Comparison Benchmarks (Both implementations)
 //==============================================================================
@@ -251,7 +1232,9 @@ static void BM_Comparison_CPP(benchmark::State& state) {
     IQResamplerCPP resampler(120000, 100000);
     auto input = generateIQSignal(blockSize, 120000, 10000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -273,7 +1256,9 @@ static void BM_Comparison_IPP(benchmark::State& state) {
     IQResamplerIPP resampler(120000, 100000);
     auto input = generateIQSignal(blockSize, 120000, 10000);
 
-    for (auto _ : state) {
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
         auto output = resampler.process(input);
         benchmark::DoNotOptimize(output);
     }
@@ -290,4 +1275,122 @@ BENCHMARK(BM_Comparison_IPP)
     ->Arg(24000);
 #endif
 
+//==============================================================================
+// Parameter Sweep: every backend over rate pairs x taps per branch x block
+// sizes, generated rather than hand-written, to find the cliffs between
+// the fixed cases above. Registered only with IQ_SWEEP=1 (several hundred
+// cases per backend); write JSON and turn it into heatmaps with
+//   IQ_SWEEP=1 ./benchmark_cpp --benchmark_filter=Sweep --benchmark_min_time=0.1
+//       --benchmark_out=sweep.json --benchmark_out_format=json
+//   python3 scripts/sweep_heatmap.py sweep.json --out sweep
+//==============================================================================
+
+struct SweepRatio {
+    int inputRate;
+    int outputRate;
+};
+
+// Simple, coprime (L, M up to 441) and strongly decimating/interpolating pairs
+static const SweepRatio SWEEP_RATIOS[] = {
+    {120000, 100000},   // 5/6
+    {100000, 120000},   // 6/5
+    {48000, 44100},     // 147/160
+    {44100, 48000},     // 160/147
+    {8000, 11025},      // 441/320
+    {96000, 44100},     // 147/320
+    {2400000, 48000},   // 1/50
+    {48000, 192000},    // 4/1
+};
+// Taps per polyphase branch, counted at the lower of the two rates: the
+// prototype has branchTaps x max(L, M) taps (IQFilterDesign::minimumTaps at
+// 8), so every ratio gets the same filter span however large L is. IPP's
+// filterLen is already per branch, in input samples: prototype taps / L.
+static const int SWEEP_BRANCH_TAPS[] = {8, 16, 32, 64};
+static const int SWEEP_BLOCKS[] = {64, 1024, 16384, 262144, 1048576};
+
+static void sweepArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"ratio", "branch_taps", "block"});
+    for (size_t r = 0; r < sizeof(SWEEP_RATIOS) / sizeof(SWEEP_RATIOS[0]); r++) {
+        for (int branchTaps : SWEEP_BRANCH_TAPS) {
+            for (int block : SWEEP_BLOCKS) {
+                b->Args({(int64_t)r, branchTaps, block});
+            }
+        }
+    }
+}
+
+// Prototype taps for the sweep's branch-taps axis
+static int sweepPrototypeTaps(const SweepRatio& ratio, int branchTaps) {
+    return IQFilterDesign::minimumTaps(ratio.inputRate, ratio.outputRate) /
+           IQFilterDesign::MIN_TAPS_PER_BRANCH * branchTaps;
+}
+
+// make(inputRate, outputRate, prototypeTaps)
+template <typename Resampler>
+static void runSweepBenchmark(benchmark::State& state,
+                              const std::function<Resampler*(int, int, int)>& make) {
+    const SweepRatio& ratio = SWEEP_RATIOS[state.range(0)];
+    const int branchTaps = state.range(1);
+    const int taps = sweepPrototypeTaps(ratio, branchTaps);
+    const int block = state.range(2);
+    std::unique_ptr<Resampler> resampler(make(ratio.inputRate, ratio.outputRate, taps));
+    auto input = generateIQSignal(block, ratio.inputRate, ratio.inputRate * 0.05f);
+
+    IQPerfCounters perf(state);
+
+    for (auto _ : perf.loop()) {
+        auto output = resampler->process(input);
+        benchmark::DoNotOptimize(output);
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(float));
+    state.SetItemsProcessed(state.iterations() * (int64_t)block);
+
+    // Parameters as numbers, so the JSON needs no name parsing
+    state.counters["input_rate"] = ratio.inputRate;
+    state.counters["output_rate"] = ratio.outputRate;
+    state.counters["branch_taps"] = branchTaps;
+    state.counters["taps"] = taps;
+    state.counters["block"] = block;
+}
+
+static void BM_Sweep_CPP(benchmark::State& state, IQResamplerCPP::Mode mode) {
+    runSweepBenchmark<IQResamplerCPP>(state, [mode](int in, int out, int taps) {
+        return new IQResamplerCPP(in, out, taps, mode);
+    });
+}
+
+static void BM_Sweep_Q15(benchmark::State& state) {
+    runSweepBenchmark<IQResamplerQ15>(state, [](int in, int out, int taps) {
+        return new IQResamplerQ15(in, out, taps);
+    });
+}
+
+#ifdef USE_IPP
+static void BM_Sweep_IPP(benchmark::State& state) {
+    runSweepBenchmark<IQResamplerIPP>(state, [](int in, int out, int taps) {
+        // filterLen is per branch: the prototype taps over L
+        const int upFactor = out / IQFilterDesign::gcd(in, out);
+        return new IQResamplerIPP(in, out, 0.9f, (taps + upFactor - 1) / upFactor);
+    });
+}
+#endif
+
+static bool registerSweepBenchmarks() {
+    const char* env = std::getenv("IQ_SWEEP");
+    if (!env || std::strcmp(env, "1") != 0) {
+        return false;
+    }
+    benchmark::RegisterBenchmark("BM_Sweep_CPP_Direct", BM_Sweep_CPP,
+                                 IQResamplerCPP::Mode::PolyphaseDirect)->Apply(sweepArgs);
+    benchmark::RegisterBenchmark("BM_Sweep_CPP_FFT", BM_Sweep_CPP,
+                                 IQResamplerCPP::Mode::PolyphaseFFT)->Apply(sweepArgs);
+    benchmark::RegisterBenchmark("BM_Sweep_Q15", BM_Sweep_Q15)->Apply(sweepArgs);
+#ifdef USE_IPP
+    benchmark::RegisterBenchmark("BM_Sweep_IPP", BM_Sweep_IPP)->Apply(sweepArgs);
+#endif
+    return true;
+}
+static const bool sweepRegistered = registerSweepBenchmarks();
+
 BENCHMARK_MAIN();
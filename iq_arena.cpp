@@ -0,0 +1,222 @@
+#include "iq_arena.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Huge page size on x86-64 and most AArch64 kernels
+const size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+// Highest NUMA node id the binding mask covers
+const int MAX_NUMA_NODES = 1024;
+
+size_t roundUp(size_t bytes, size_t multiple) {
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+#if defined(__linux__)
+// mbind() / get_mempolicy() through syscall(), so libnuma is not needed
+const int MPOL_PREFERRED_MODE = 1;
+const unsigned long MPOL_F_NODE_FLAG = 1UL << 0;
+const unsigned long MPOL_F_ADDR_FLAG = 1UL << 1;
+
+bool bindToNode(void* addr, size_t bytes, int node) {
+#if defined(SYS_mbind)
+    if (node < 0 || node >= MAX_NUMA_NODES) {
+        return false;
+    }
+    const int bitsPerWord = 8 * sizeof(unsigned long);
+    unsigned long mask[MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = {};
+    mask[node / bitsPerWord] = 1UL << (node % bitsPerWord);
+    return syscall(SYS_mbind, addr, bytes, MPOL_PREFERRED_MODE, mask, (unsigned long)MAX_NUMA_NODES, 0) == 0;
+#else
+    (void)addr;
+    (void)bytes;
+    (void)node;
+    return false;
+#endif
+}
+#endif
+
+} // namespace
+
+const size_t IQArena::ALIGNMENT;
+const int IQMemoryPolicy::ANY_NODE;
+const int IQMemoryPolicy::LOCAL_NODE;
+
+IQArena::IQArena(size_t bytes, const IQMemoryPolicy& policy)
+    : base_(nullptr), allocation_(nullptr), allocationBytes_(0), mapped_(false),
+      hugePages_(false), capacity_(0), used_(0) {
+    map(bytes, policy);
+}
+
+IQArena::IQArena(IQArena&& other) noexcept
+    : base_(nullptr), allocation_(nullptr), allocationBytes_(0), mapped_(false),
+      hugePages_(false), capacity_(0), used_(0) {
+    swap(other);
+}
+
+IQArena& IQArena::operator=(IQArena&& other) noexcept {
+    if (this != &other) {
+        free();
+        swap(other);
+    }
+    return *this;
+}
+
+IQArena::~IQArena() {
+    free();
+}
+
+void IQArena::swap(IQArena& other) noexcept {
+    std::swap(base_, other.base_);
+    std::swap(allocation_, other.allocation_);
+    std::swap(allocationBytes_, other.allocationBytes_);
+    std::swap(mapped_, other.mapped_);
+    std::swap(hugePages_, other.hugePages_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(used_, other.used_);
+    std::swap(policy_, other.policy_);
+}
+
+void IQArena::free() {
+#if defined(__linux__)
+    if (mapped_) {
+        munmap(allocation_, allocationBytes_);
+    } else
+#endif
+    {
+        delete[] static_cast<unsigned char*>(allocation_);
+    }
+    base_ = nullptr;
+    allocation_ = nullptr;
+    allocationBytes_ = 0;
+    mapped_ = false;
+    hugePages_ = false;
+    capacity_ = 0;
+    used_ = 0;
+}
+
+void IQArena::reset(size_t bytes, const IQMemoryPolicy& policy) {
+    IQArena fresh;
+    fresh.map(bytes, policy);
+    swap(fresh);
+}
+
+void IQArena::map(size_t bytes, const IQMemoryPolicy& policy) {
+    policy_ = policy;
+    bytes = roundUp(bytes, ALIGNMENT);
+    if (policy.maxBytes != 0 && bytes > policy.maxBytes) {
+        throw std::bad_alloc();
+    }
+    if (bytes == 0) {
+        return;
+    }
+
+#if defined(__linux__)
+    if (policy.hugePages || policy.numaNode != IQMemoryPolicy::ANY_NODE) {
+        // mmap returns page-aligned memory, which is ALIGNMENT-aligned
+        size_t pageBytes = policy.hugePages ? HUGE_PAGE_BYTES : (size_t)sysconf(_SC_PAGESIZE);
+        size_t mapBytes = roundUp(bytes, pageBytes);
+        void* p = MAP_FAILED;
+        if (policy.hugePages) {
+            p = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            hugePages_ = (p != MAP_FAILED);
+        }
+        if (p == MAP_FAILED) {
+            p = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#if defined(MADV_HUGEPAGE)
+            // No huge pages reserved: ask for transparent huge pages instead
+            if (p != MAP_FAILED && policy.hugePages) {
+                madvise(p, mapBytes, MADV_HUGEPAGE);
+            }
+#endif
+        }
+
+        if (p != MAP_FAILED) {
+            int node = (policy.numaNode == IQMemoryPolicy::LOCAL_NODE) ? currentNumaNode() : policy.numaNode;
+            if (node >= 0) {
+                bindToNode(p, mapBytes, node);
+            }
+
+            // Fault every page in now, under the binding, rather than
+            // during the first (possibly real-time) process() call
+            std::memset(p, 0, mapBytes);
+
+            allocation_ = p;
+            allocationBytes_ = mapBytes;
+            mapped_ = true;
+            base_ = static_cast<unsigned char*>(p);
+            capacity_ = bytes;
+            return;
+        }
+    }
+#endif
+
+    // Ordinary memory, over-allocated so the start can be aligned
+    unsigned char* raw = new unsigned char[bytes + ALIGNMENT];
+    allocation_ = raw;
+    allocationBytes_ = bytes + ALIGNMENT;
+    uintptr_t aligned = roundUp(reinterpret_cast<uintptr_t>(raw), ALIGNMENT);
+    base_ = reinterpret_cast<unsigned char*>(aligned);
+    capacity_ = bytes;
+}
+
+void* IQArena::allocateBytes(size_t bytes) {
+    size_t size = roundUp(bytes, ALIGNMENT);
+    if (size > capacity_ - used_) {
+        throw std::bad_alloc();
+    }
+    void* p = base_ + used_;
+    used_ += size;
+    return p;
+}
+
+int IQArena::numaNode() const {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    if (base_ != nullptr) {
+        int node = -1;
+        if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, base_, MPOL_F_NODE_FLAG | MPOL_F_ADDR_FLAG) == 0) {
+            return node;
+        }
+    }
+#endif
+    return -1;
+}
+
+int IQArena::currentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return (int)node;
+    }
+#endif
+    return -1;
+}
+
+int IQArena::numaNodeCount() {
+    int count = 1;
+#if defined(__linux__)
+    // Node ids may be sparse: count up to the highest one present
+    for (int node = 0; node < MAX_NUMA_NODES; node++) {
+        char path[64];
+        std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", node);
+        if (access(path, F_OK) == 0) {
+            count = node + 1;
+        } else if (node >= 64) {
+            break;
+        }
+    }
+#endif
+    return count;
+}
@@ -0,0 +1,103 @@
+#ifndef IQ_ARENA_H
+#define IQ_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+
+// Where an arena's memory should live. Every placement request degrades
+// gracefully: without reserved huge pages, NUMA support or permission, the
+// block is still allocated, just without that placement. maxBytes is the
+// exception: a block larger than it is refused with std::bad_alloc (e.g.
+// to keep a resampler within a locked-memory budget).
+struct IQMemoryPolicy {
+    static const int ANY_NODE = -1;    // Leave placement to the kernel (first touch)
+    static const int LOCAL_NODE = -2;  // Node of the CPU the allocating thread runs on
+
+    bool hugePages;   // 2 MB pages: MAP_HUGETLB, else transparent huge pages
+    int numaNode;     // NUMA node to prefer, or ANY_NODE / LOCAL_NODE
+    size_t maxBytes;  // Largest block allowed (0: no limit)
+
+    IQMemoryPolicy(bool huge = false, int node = ANY_NODE, size_t limit = 0)
+        : hugePages(huge), numaNode(node), maxBytes(limit) {}
+};
+
+// Fixed-size block of scratch memory for a resampler's working buffers.
+// One allocation up front (sized from the largest block the resampler
+// will see), then buffers are carved off it with a bump pointer, each
+// aligned to a cache line so SIMD loads never split one. Optionally
+// backed by 2 MB huge pages to cut TLB misses on large buffers, and
+// placed on a chosen NUMA node.
+class IQArena {
+public:
+    static const size_t ALIGNMENT = 64;
+
+    explicit IQArena(size_t bytes = 0, const IQMemoryPolicy& policy = IQMemoryPolicy());
+    ~IQArena();
+
+    IQArena(const IQArena&) = delete;
+    IQArena& operator=(const IQArena&) = delete;
+
+    // The block changes owner and stays where it is, so pointers carved
+    // from it remain valid; the source is left empty
+    IQArena(IQArena&& other) noexcept;
+    IQArena& operator=(IQArena&& other) noexcept;
+
+    // Replace the block with a new one of at least bytes. The new block is
+    // allocated before the old one is freed, so when that throws (out of
+    // memory, or over policy.maxBytes) the
+    // arena (and every buffer carved from it) is left untouched. Huge
+    // pages: explicit ones (MAP_HUGETLB) are tried first, then transparent
+    // huge pages (madvise), then ordinary memory. NUMA: the block is bound
+    // to the node with a preferred policy (mbind) and faulted in right
+    // away, so it is placed before the first process() call.
+    void reset(size_t bytes, const IQMemoryPolicy& policy = IQMemoryPolicy());
+
+    // count elements of T from the block, ALIGNMENT-aligned and
+    // uninitialized; std::bad_alloc when the block is exhausted
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocateBytes(count * sizeof(T)));
+    }
+
+    // Space allocate() needs for count elements of T, padding included
+    template <typename T>
+    static size_t bytesFor(size_t count) {
+        return (count * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    // Give every buffer back at once; the block itself is kept
+    void release() { used_ = 0; }
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_; }
+    const IQMemoryPolicy& policy() const { return policy_; }
+
+    // True when the block sits on explicit huge pages
+    bool usesHugePages() const { return hugePages_; }
+
+    // NUMA node the start of the block sits on, -1 when unknown
+    int numaNode() const;
+
+    // NUMA node of the CPU the calling thread is running on (-1 when
+    // unknown), and the number of nodes in the system (1 without NUMA)
+    static int currentNumaNode();
+    static int numaNodeCount();
+
+private:
+    unsigned char* base_;      // Aligned start of the block
+    void* allocation_;         // What was allocated or mapped
+    size_t allocationBytes_;
+    bool mapped_;              // allocation_ came from mmap
+    bool hugePages_;
+    size_t capacity_;
+    size_t used_;
+    IQMemoryPolicy policy_;
+
+    void* allocateBytes(size_t bytes);
+    void map(size_t bytes, const IQMemoryPolicy& policy);  // Into an empty arena
+    void swap(IQArena& other) noexcept;
+    void free();
+};
+
+#endif // IQ_ARENA_H
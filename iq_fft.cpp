@@ -0,0 +1,110 @@
+#include "iq_fft.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// Plain complex multiply (std::complex operator* adds NaN/Inf recovery
+// calls that keep it from vectorizing)
+template <typename Real>
+inline std::complex<Real> cmul(std::complex<Real> a, std::complex<Real> b) {
+    return std::complex<Real>(a.real() * b.real() - a.imag() * b.imag(),
+                              a.real() * b.imag() + a.imag() * b.real());
+}
+
+// Multiply by +j (forward) or -j (inverse)
+template <bool Inverse, typename Real>
+inline std::complex<Real> mulJ(std::complex<Real> a) {
+    return Inverse ? std::complex<Real>(a.imag(), -a.real()) : std::complex<Real>(-a.imag(), a.real());
+}
+
+template <bool Inverse, typename Real>
+inline std::complex<Real> twiddle(std::complex<Real> w) {
+    return Inverse ? std::conj(w) : w;
+}
+
+} // namespace
+
+template <typename Real>
+IQBasicFFT<Real>::IQBasicFFT(int size) : size_(size) {
+    if (size < 1 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("FFT size must be a power of two");
+    }
+
+    twiddles_.resize(size_);
+    for (int k = 0; k < size_; k++) {
+        double theta = 2.0 * M_PI * k / size_;
+        twiddles_[k] = std::complex<Real>((Real)std::cos(theta), (Real)-std::sin(theta));
+    }
+    scratch_.resize(size_);
+}
+
+template <typename Real>
+template <bool Inverse>
+void IQBasicFFT<Real>::transform(std::complex<Real>* data) {
+    typedef std::complex<Real> cf;
+    cf* x = data;
+    cf* y = scratch_.data();
+    int n = size_;  // Length of the sub-transforms at this stage
+    int s = 1;      // Stride between interleaved sub-transforms
+
+    // Radix-4 stages
+    while (n >= 4) {
+        const int n1 = n / 4;
+        for (int p = 0; p < n1; p++) {
+            const cf w1 = twiddle<Inverse, Real>(twiddles_[p * s]);
+            const cf w2 = twiddle<Inverse, Real>(twiddles_[2 * p * s]);
+            const cf w3 = twiddle<Inverse, Real>(twiddles_[3 * p * s]);
+            const cf* xa = x + s * p;
+            const cf* xb = x + s * (p + n1);
+            const cf* xc = x + s * (p + 2 * n1);
+            const cf* xd = x + s * (p + 3 * n1);
+            cf* yp = y + s * 4 * p;
+            for (int q = 0; q < s; q++) {
+                const cf apc = xa[q] + xc[q];
+                const cf amc = xa[q] - xc[q];
+                const cf bpd = xb[q] + xd[q];
+                const cf jbmd = mulJ<Inverse, Real>(xb[q] - xd[q]);
+                yp[q] = apc + bpd;
+                yp[q + s] = cmul(w1, amc - jbmd);
+                yp[q + 2 * s] = cmul(w2, apc - bpd);
+                yp[q + 3 * s] = cmul(w3, amc + jbmd);
+            }
+        }
+        n /= 4;
+        s *= 4;
+        std::swap(x, y);
+    }
+
+    // Final radix-2 stage for odd log2(size)
+    if (n == 2) {
+        for (int q = 0; q < s; q++) {
+            const cf a = x[q];
+            const cf b = x[q + s];
+            y[q] = a + b;
+            y[q + s] = a - b;
+        }
+        std::swap(x, y);
+    }
+
+    if (x != data) {
+        std::copy(x, x + size_, data);
+    }
+}
+
+template <typename Real>
+void IQBasicFFT<Real>::forward(std::complex<Real>* data) {
+    transform<false>(data);
+}
+
+template <typename Real>
+void IQBasicFFT<Real>::inverse(std::complex<Real>* data) {
+    transform<true>(data);
+}
+
+template class IQBasicFFT<float>;
+template class IQBasicFFT<double>;
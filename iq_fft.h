@@ -0,0 +1,38 @@
+#ifndef IQ_FFT_H
+#define IQ_FFT_H
+
+#include <complex>
+#include <vector>
+#include <stdexcept>
+
+// Built-in complex FFT for power-of-two sizes.
+// Stockham autosort radix-4 stages with one radix-2 stage when log2(size)
+// is odd, so no bit-reversal pass and no external dependency.
+// Instantiated for float (IQFFT, the streaming engines) and double
+// (IQFFTDouble, filter design).
+template <typename Real>
+class IQBasicFFT {
+private:
+    int size_;
+    std::vector<std::complex<Real> > twiddles_;  // exp(-j*2*pi*k/size), k < size
+    std::vector<std::complex<Real> > scratch_;
+
+    template <bool Inverse>
+    void transform(std::complex<Real>* data);
+
+public:
+    explicit IQBasicFFT(int size);
+
+    int size() const { return size_; }
+
+    // In-place forward transform (exp(-j) kernel)
+    void forward(std::complex<Real>* data);
+
+    // In-place inverse transform, unnormalized (caller scales by 1/size)
+    void inverse(std::complex<Real>* data);
+};
+
+typedef IQBasicFFT<float> IQFFT;
+typedef IQBasicFFT<double> IQFFTDouble;
+
+#endif // IQ_FFT_H
@@ -0,0 +1,335 @@
+#include "iq_filter_design.h"
+#include "iq_fft.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <string>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// Longest prototype the designer will return
+const int MAX_DESIGN_TAPS = 1 << 20;
+
+struct BandEdges {
+    double passband;  // Cycles per sample at the prototype rate (L x input)
+    double stopband;
+};
+
+BandEdges bandEdges(int upFactor, int downFactor, const IQFilterSpec& spec) {
+    double nyquist = 0.5 / std::max(upFactor, downFactor);
+    BandEdges edges;
+    edges.passband = spec.passbandEdge * nyquist;
+    edges.stopband = 2.0 * nyquist - edges.passband;
+    return edges;
+}
+
+void validateSpec(int upFactor, int downFactor, const IQFilterSpec& spec) {
+    if (upFactor < 1 || downFactor < 1) {
+        throw std::invalid_argument("Resampling factors must be positive");
+    }
+    if (!(spec.passbandEdge > 0.0 && spec.passbandEdge < 1.0)) {
+        throw std::invalid_argument("Passband edge must be in (0, 1)");
+    }
+    if (!(spec.stopbandAttenuationDb > 0.0) || !(spec.passbandRippleDb > 0.0)) {
+        throw std::invalid_argument("Stopband attenuation and passband ripple must be positive");
+    }
+}
+
+// Attenuation (dB) the window must reach: a Kaiser design has the same
+// deviation in both bands, so the tighter of the two specs sets it
+double requiredAttenuation(const IQFilterSpec& spec) {
+    double r = std::pow(10.0, spec.passbandRippleDb / 20.0);
+    double passDelta = (r - 1.0) / (r + 1.0);
+    double stopDelta = std::pow(10.0, -spec.stopbandAttenuationDb / 20.0);
+    return -20.0 * std::log10(std::min(passDelta, stopDelta));
+}
+
+// Kaiser's empirical beta for a given attenuation
+double kaiserBeta(double attenuation) {
+    if (attenuation > 50.0) {
+        return 0.1102 * (attenuation - 8.7);
+    }
+    if (attenuation >= 21.0) {
+        return 0.5842 * std::pow(attenuation - 21.0, 0.4) + 0.07886 * (attenuation - 21.0);
+    }
+    return 0.0;
+}
+
+// Zeroth-order modified Bessel function of the first kind
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+    for (int k = 1; k < 64; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-17) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// Taps for a given branch length; every branch gets the full length
+int tapsForBranch(int upFactor, int branchLen) {
+    return upFactor * branchLen;
+}
+
+} // namespace
+
+std::vector<float> IQFilterDesign::kaiser(int upFactor, int downFactor, const IQFilterSpec& spec,
+                                          int numTaps) {
+    validateSpec(upFactor, downFactor, spec);
+    if (numTaps < 1) {
+        throw std::invalid_argument("Filter must have at least one tap");
+    }
+
+    double cutoff = 0.5 / std::max(upFactor, downFactor);
+    double beta = kaiserBeta(requiredAttenuation(spec));
+    double center = (numTaps - 1) / 2.0;
+    double norm = besselI0(beta);
+
+    std::vector<double> h(numTaps);
+    double sum = 0.0;
+    for (int i = 0; i < numTaps; i++) {
+        double t = i - center;
+
+        // Sinc function
+        double sinc = (t == 0.0) ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+
+        // Kaiser window
+        double x = (numTaps > 1) ? t / center : 0.0;
+        double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - x * x))) / norm;
+        h[i] = sinc * window;
+        sum += h[i];
+    }
+
+    // Normalize to preserve DC gain
+    std::vector<float> taps(numTaps);
+    for (int i = 0; i < numTaps; i++) {
+        taps[i] = (float)(h[i] / sum);
+    }
+    return taps;
+}
+
+const int IQFilterDesign::MIN_TAPS_PER_BRANCH;
+
+int IQFilterDesign::gcd(int a, int b) {
+    while (b != 0) {
+        int temp = b;
+        b = a % b;
+        a = temp;
+    }
+    return a;
+}
+
+std::vector<double> IQFilterDesign::hamming(int upFactor, int downFactor, int numTaps) {
+    // Double precision keeps every tap far from a rounding boundary of the
+    // Q15 grid, so libm and FMA contraction differences cannot change the
+    // quantized bank of IQResamplerQ15
+    double cutoffFreq = 0.5 / std::max(upFactor, downFactor);
+    std::vector<double> taps(numTaps);
+    double sum = 0.0;
+    int center = numTaps / 2;
+
+    for (int i = 0; i < numTaps; i++) {
+        double t = i - center;
+
+        // Sinc function
+        double h;
+        if (t == 0) {
+            h = 2.0 * cutoffFreq;
+        } else {
+            h = std::sin(2.0 * M_PI * cutoffFreq * t) / (M_PI * t);
+        }
+
+        // Hamming window
+        double window = 0.54 - 0.46 * std::cos(2.0 * M_PI * i / (numTaps - 1));
+        taps[i] = h * window;
+        sum += taps[i];
+    }
+
+    // Normalize to preserve DC gain
+    for (int i = 0; i < numTaps; i++) {
+        taps[i] /= sum;
+    }
+    return taps;
+}
+
+int IQFilterDesign::minimumTaps(int inputRate, int outputRate) {
+    if (inputRate <= 0 || outputRate <= 0) {
+        throw std::invalid_argument("Rates must be positive");
+    }
+    int g = gcd(inputRate, outputRate);
+    long long taps = (long long)MIN_TAPS_PER_BRANCH * (std::max(inputRate, outputRate) / g);
+    return (int)std::min(taps, (long long)MAX_DESIGN_TAPS);
+}
+
+void IQFilterDesign::checkTaps(int inputRate, int outputRate, int filterTaps) {
+    int minimum = minimumTaps(inputRate, outputRate);
+    if (filterTaps < minimum) {
+        throw std::invalid_argument("Filter too short for this ratio: " + std::to_string(filterTaps) +
+                                    " taps, at least " + std::to_string(minimum) + " needed");
+    }
+}
+
+std::vector<float> IQFilterDesign::kaiser(int upFactor, int downFactor, const IQFilterSpec& spec) {
+    validateSpec(upFactor, downFactor, spec);
+
+    // Kaiser's length estimate, N - 1 = (A - 7.95) / (14.36 * transition width)
+    BandEdges edges = bandEdges(upFactor, downFactor, spec);
+    double attenuation = requiredAttenuation(spec);
+    double estimate = std::ceil((attenuation - 7.95) / (14.36 * (edges.stopband - edges.passband))) + 1.0;
+    if (estimate > MAX_DESIGN_TAPS) {
+        throw std::invalid_argument("Filter spec needs too many taps");
+    }
+
+    // The estimate is only approximate: walk the branch length from it
+    // until it is the shortest one whose measured response meets spec
+    int branchLen = std::max(1, ((int)estimate + upFactor - 1) / upFactor);
+    std::vector<float> taps = kaiser(upFactor, downFactor, spec, tapsForBranch(upFactor, branchLen));
+
+    if (response(taps, upFactor, downFactor, spec).meetsSpec) {
+        while (branchLen > 1) {
+            std::vector<float> shorter = kaiser(upFactor, downFactor, spec,
+                                                tapsForBranch(upFactor, branchLen - 1));
+            if (!response(shorter, upFactor, downFactor, spec).meetsSpec) {
+                break;
+            }
+            taps.swap(shorter);
+            branchLen--;
+        }
+    } else {
+        do {
+            branchLen++;
+            if (tapsForBranch(upFactor, branchLen) > MAX_DESIGN_TAPS) {
+                throw std::invalid_argument("Filter spec needs too many taps");
+            }
+            taps = kaiser(upFactor, downFactor, spec, tapsForBranch(upFactor, branchLen));
+        } while (!response(taps, upFactor, downFactor, spec).meetsSpec);
+    }
+    return taps;
+}
+
+std::vector<float> IQFilterDesign::minimumPhase(const std::vector<float>& taps) {
+    if (taps.empty()) {
+        throw std::invalid_argument("Filter must have at least one tap");
+    }
+    typedef std::complex<double> cd;
+
+    // Large transform so the cepstrum does not alias
+    int size = 1024;
+    while (size < 32 * (int)taps.size()) {
+        size *= 2;
+    }
+    IQFFTDouble fft(size);
+
+    std::vector<cd> spectrum(size, cd(0.0, 0.0));
+    for (size_t i = 0; i < taps.size(); i++) {
+        spectrum[i] = cd(taps[i], 0.0);
+    }
+    fft.forward(spectrum.data());
+
+    // Log magnitude, floored well below any stopband so zeros stay finite
+    double peak = 0.0;
+    for (int k = 0; k < size; k++) {
+        peak = std::max(peak, std::abs(spectrum[k]));
+    }
+    double floor = peak * 1e-10;
+    std::vector<cd> cepstrum(size);
+    for (int k = 0; k < size; k++) {
+        cepstrum[k] = cd(std::log(std::max(std::abs(spectrum[k]), floor)), 0.0);
+    }
+    fft.inverse(cepstrum.data());
+
+    // Fold the anti-causal half of the real cepstrum onto the causal half
+    for (int n = 0; n < size; n++) {
+        double weight = (n == 0 || n == size / 2) ? 1.0 : (n < size / 2 ? 2.0 : 0.0);
+        cepstrum[n] = cd(cepstrum[n].real() * weight / size, 0.0);
+    }
+    fft.forward(cepstrum.data());
+    for (int k = 0; k < size; k++) {
+        cepstrum[k] = std::exp(cepstrum[k]);
+    }
+    fft.inverse(cepstrum.data());
+
+    // Keep the original length; normalize to preserve DC gain
+    std::vector<float> result(taps.size());
+    double sum = 0.0;
+    for (size_t i = 0; i < taps.size(); i++) {
+        sum += cepstrum[i].real();
+    }
+    for (size_t i = 0; i < taps.size(); i++) {
+        result[i] = (float)(cepstrum[i].real() / sum);
+    }
+    return result;
+}
+
+double IQFilterDesign::groupDelay(const std::vector<float>& taps) {
+    double moment = 0.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < taps.size(); i++) {
+        moment += (double)i * taps[i];
+        sum += taps[i];
+    }
+    if (sum == 0.0) {
+        throw std::invalid_argument("Filter has no DC gain");
+    }
+    return moment / sum;
+}
+
+IQFilterResponse IQFilterDesign::response(const std::vector<float>& taps, int upFactor, int downFactor,
+                                          const IQFilterSpec& spec, double inputRate) {
+    validateSpec(upFactor, downFactor, spec);
+    if (taps.empty()) {
+        throw std::invalid_argument("Filter must have at least one tap");
+    }
+
+    // Zero-padded FFT with ~16 bins per sidelobe so ripple peaks are not missed
+    int size = 4096;
+    while (size < 16 * (int)taps.size()) {
+        size *= 2;
+    }
+    std::vector<std::complex<float> > spectrum(size, std::complex<float>(0.0f, 0.0f));
+    for (size_t i = 0; i < taps.size(); i++) {
+        spectrum[i] = std::complex<float>(taps[i], 0.0f);
+    }
+    IQFFT fft(size);
+    fft.forward(spectrum.data());
+
+    BandEdges edges = bandEdges(upFactor, downFactor, spec);
+    double prototypeRate = inputRate * upFactor;
+
+    IQFilterResponse result;
+    result.passbandEdgeHz = edges.passband * prototypeRate;
+    result.stopbandEdgeHz = edges.stopband * prototypeRate;
+    result.frequencyHz.resize(size / 2 + 1);
+    result.magnitudeDb.resize(size / 2 + 1);
+
+    double passMax = -1e300;
+    double passMin = 1e300;
+    double stopMax = -1e300;
+    for (int k = 0; k <= size / 2; k++) {
+        double f = (double)k / size;
+        double db = 20.0 * std::log10(std::max((double)std::abs(spectrum[k]), 1e-15));
+        result.frequencyHz[k] = f * prototypeRate;
+        result.magnitudeDb[k] = db;
+
+        if (f <= edges.passband) {
+            passMax = std::max(passMax, db);
+            passMin = std::min(passMin, db);
+        } else if (f >= edges.stopband) {
+            stopMax = std::max(stopMax, db);
+        }
+    }
+
+    result.passbandRippleDb = passMax - passMin;
+    result.stopbandAttenuationDb = -stopMax;
+    result.meetsSpec = result.passbandRippleDb <= spec.passbandRippleDb &&
+                       result.stopbandAttenuationDb >= spec.stopbandAttenuationDb;
+    return result;
+}
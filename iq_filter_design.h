@@ -0,0 +1,79 @@
+#ifndef IQ_FILTER_DESIGN_H
+#define IQ_FILTER_DESIGN_H
+
+#include <vector>
+#include <stdexcept>
+
+// Anti-aliasing filter requirements for a resampling ratio.
+// Band edges are relative to the narrower Nyquist band, min(in, out) / 2.
+// The stopband starts at the mirror of the passband edge, so aliases and
+// images of the passband only land in the transition band.
+struct IQFilterSpec {
+    double passbandEdge;           // Fraction of min(in, out) / 2 kept flat, in (0, 1)
+    double stopbandAttenuationDb;  // Minimum alias/image rejection (dB)
+    double passbandRippleDb;       // Peak-to-peak passband ripple allowed (dB)
+
+    IQFilterSpec(double passband = 0.8, double stopbandDb = 80.0, double rippleDb = 0.1)
+        : passbandEdge(passband), stopbandAttenuationDb(stopbandDb), passbandRippleDb(rippleDb) {}
+};
+
+// Achieved response of a prototype filter, measured on a dense FFT grid
+struct IQFilterResponse {
+    double passbandEdgeHz;         // Band edges at the input sample rate
+    double stopbandEdgeHz;
+    double passbandRippleDb;       // Achieved peak-to-peak ripple
+    double stopbandAttenuationDb;  // Achieved worst-case rejection
+    bool meetsSpec;
+
+    // Magnitude (dB, unity DC gain = 0 dB) from 0 to half the prototype rate
+    std::vector<double> frequencyHz;
+    std::vector<double> magnitudeDb;
+};
+
+// Spec-driven prototype design for an L/M polyphase resampler. The
+// prototype runs at L x input rate and has unity DC gain, like the
+// windowed-sinc filters generated by the resamplers.
+class IQFilterDesign {
+public:
+    static const int MIN_TAPS_PER_BRANCH = 8;
+
+    // Greatest common divisor, for reducing inputRate / outputRate to L / M
+    static int gcd(int a, int b);
+
+    // Hamming-windowed sinc of numTaps taps, cut off at the narrower
+    // Nyquist band: the filterTaps prototype of every resampler backend.
+    // Designed in double precision; the float engines round it
+    static std::vector<double> hamming(int upFactor, int downFactor, int numTaps);
+
+    // Fewest taps a windowed-sinc prototype for inputRate -> outputRate
+    // (the filterTaps of the resampler constructors) may have:
+    // MIN_TAPS_PER_BRANCH x max(L, M), so every polyphase branch gets that
+    // many taps and the window spans that many samples at the lower rate.
+    // Shorter prototypes leave branches (nearly) empty and do not filter.
+    static int minimumTaps(int inputRate, int outputRate);
+
+    // std::invalid_argument when filterTaps is below minimumTaps()
+    static void checkTaps(int inputRate, int outputRate, int filterTaps);
+
+    // Kaiser-windowed sinc with the fewest taps per polyphase branch that
+    // meets spec (checked against the measured response)
+    static std::vector<float> kaiser(int upFactor, int downFactor, const IQFilterSpec& spec);
+
+    // Kaiser-windowed sinc of a fixed length, with the window shaped for spec
+    static std::vector<float> kaiser(int upFactor, int downFactor, const IQFilterSpec& spec,
+                                     int numTaps);
+
+    // Minimum-phase filter with (nearly) the same magnitude response and
+    // length, via the folded real cepstrum; unity DC gain
+    static std::vector<float> minimumPhase(const std::vector<float>& taps);
+
+    // Group delay at DC in taps, sum(n * h[n]) / sum(h[n]); (N - 1) / 2 for
+    // linear-phase filters
+    static double groupDelay(const std::vector<float>& taps);
+
+    // Measure a prototype against spec; inputRate only labels frequencies
+    static IQFilterResponse response(const std::vector<float>& taps, int upFactor, int downFactor,
+                                     const IQFilterSpec& spec, double inputRate = 1.0);
+};
+
+#endif // IQ_FILTER_DESIGN_H
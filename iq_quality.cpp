@@ -0,0 +1,281 @@
+#include "iq_quality.h"
+#include "iq_fft.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+typedef std::complex<double> cd;
+
+// Irregular spacing for tone sets, so intermodulation products do not
+// land on other tones
+const double GOLDEN_FRACTION = 0.6180339887498949;
+
+// Tone whose fit and residual are analysed
+struct ToneFit {
+    std::vector<cd> amplitudes;
+    std::vector<cd> residual;
+    double residualPower;  // Mean |residual|^2
+};
+
+// Resample a sum of tones (Hz at the input rate) with a fresh resampler
+// and return the analysis window of the output
+std::vector<cd> resampleTones(const IQQuality::Factory& factory, int inputRate, int outputRate,
+                              const std::vector<double>& frequencies, const std::vector<double>& phases,
+                              double amplitude, const IQQualityOptions& options) {
+    size_t outputs = options.settleSamples + options.analysisSamples;
+    size_t numInput = (size_t)std::ceil((double)outputs * inputRate / outputRate) + 64;
+
+    std::vector<float> input(numInput * 2);
+    for (size_t i = 0; i < numInput; i++) {
+        cd sum(0.0, 0.0);
+        for (size_t k = 0; k < frequencies.size(); k++) {
+            sum += std::polar(amplitude, 2.0 * M_PI * frequencies[k] * i / inputRate + phases[k]);
+        }
+        input[i * 2] = (float)sum.real();
+        input[i * 2 + 1] = (float)sum.imag();
+    }
+
+    IQQuality::ProcessFunction process = factory();
+    std::vector<float> output = process(input);
+    if (output.size() / 2 < outputs) {
+        throw std::runtime_error("Resampler returned too few samples to analyse");
+    }
+
+    std::vector<cd> window(options.analysisSamples);
+    for (size_t i = 0; i < window.size(); i++) {
+        size_t j = options.settleSamples + i;
+        window[i] = cd(output[j * 2], output[j * 2 + 1]);
+    }
+    return window;
+}
+
+// Fit tones (Hz at the output rate) and keep what is left
+ToneFit fitAndRemove(const std::vector<cd>& signal, const std::vector<double>& frequencies, int outputRate) {
+    std::vector<double> cycles(frequencies.size());
+    for (size_t k = 0; k < frequencies.size(); k++) {
+        cycles[k] = frequencies[k] / outputRate;
+    }
+
+    ToneFit fit;
+    fit.amplitudes = IQQuality::fitTones(signal.data(), signal.size(), cycles);
+    fit.residual = signal;
+    double power = 0.0;
+    for (size_t i = 0; i < signal.size(); i++) {
+        for (size_t k = 0; k < cycles.size(); k++) {
+            fit.residual[i] -= fit.amplitudes[k] * std::polar(1.0, 2.0 * M_PI * cycles[k] * i);
+        }
+        power += std::norm(fit.residual[i]);
+    }
+    fit.residualPower = power / signal.size();
+    return fit;
+}
+
+// 4-term Blackman-Harris window (-92 dB sidelobes)
+double blackmanHarris(size_t i, size_t n) {
+    double x = 2.0 * M_PI * i / n;
+    return 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2.0 * x) - 0.01168 * std::cos(3.0 * x);
+}
+
+// Windowed spectrum of a residual; bin k holds |X_k|^2
+std::vector<double> powerSpectrum(const std::vector<cd>& residual, double& windowSum, double& windowPower) {
+    const size_t n = residual.size();
+    std::vector<cd> spectrum(n);
+    windowSum = 0.0;
+    windowPower = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double w = blackmanHarris(i, n);
+        spectrum[i] = residual[i] * w;
+        windowSum += w;
+        windowPower += w * w;
+    }
+    IQFFTDouble fft((int)n);
+    fft.forward(spectrum.data());
+
+    std::vector<double> power(n);
+    for (size_t k = 0; k < n; k++) {
+        power[k] = std::norm(spectrum[k]);
+    }
+    return power;
+}
+
+// Frequency (Hz) of FFT bin k of n at rate
+double binFrequency(size_t k, size_t n, int rate) {
+    double bin = (k < n / 2) ? (double)k : (double)k - (double)n;
+    return bin * rate / n;
+}
+
+double toDb(double ratio) {
+    return 10.0 * std::log10(ratio);
+}
+
+} // namespace
+
+std::vector<cd> IQQuality::fitTones(const cd* signal, size_t count, const std::vector<double>& frequencies) {
+    const size_t k = frequencies.size();
+
+    // Normal equations G a = b: G[r][c] = sum_n exp(j 2 pi (f_c - f_r) n),
+    // b[r] = sum_n y[n] exp(-j 2 pi f_r n)
+    std::vector<cd> g(k * k);
+    std::vector<cd> b(k, cd(0.0, 0.0));
+    for (size_t r = 0; r < k; r++) {
+        for (size_t c = 0; c < k; c++) {
+            double delta = frequencies[c] - frequencies[r];
+            cd z = std::polar(1.0, 2.0 * M_PI * delta);
+            g[r * k + c] = (std::abs(1.0 - z) < 1e-12)
+                ? cd((double)count, 0.0)
+                : (1.0 - std::polar(1.0, 2.0 * M_PI * delta * count)) / (1.0 - z);
+        }
+        for (size_t i = 0; i < count; i++) {
+            b[r] += signal[i] * std::polar(1.0, -2.0 * M_PI * frequencies[r] * i);
+        }
+    }
+
+    // Gaussian elimination with partial pivoting
+    for (size_t col = 0; col < k; col++) {
+        size_t pivot = col;
+        for (size_t r = col + 1; r < k; r++) {
+            if (std::abs(g[r * k + col]) > std::abs(g[pivot * k + col])) {
+                pivot = r;
+            }
+        }
+        if (std::abs(g[pivot * k + col]) == 0.0) {
+            throw std::invalid_argument("Tone frequencies must be distinct");
+        }
+        if (pivot != col) {
+            for (size_t c = 0; c < k; c++) {
+                std::swap(g[col * k + c], g[pivot * k + c]);
+            }
+            std::swap(b[col], b[pivot]);
+        }
+        for (size_t r = col + 1; r < k; r++) {
+            cd factor = g[r * k + col] / g[col * k + col];
+            for (size_t c = col; c < k; c++) {
+                g[r * k + c] -= factor * g[col * k + c];
+            }
+            b[r] -= factor * b[col];
+        }
+    }
+
+    std::vector<cd> a(k);
+    for (size_t r = k; r-- > 0;) {
+        cd sum = b[r];
+        for (size_t c = r + 1; c < k; c++) {
+            sum -= g[r * k + c] * a[c];
+        }
+        a[r] = sum / g[r * k + r];
+    }
+    return a;
+}
+
+IQQualityReport IQQuality::measure(const Factory& factory, int inputRate, int outputRate,
+                                   const IQQualityOptions& options) {
+    const size_t n = options.analysisSamples;
+    if (n < 64 || (n & (n - 1)) != 0) {
+        throw std::invalid_argument("Analysis length must be a power of two of at least 64");
+    }
+    if (!(options.passbandEdge > 0.0 && options.passbandEdge < 1.0)) {
+        throw std::invalid_argument("Passband edge must be in (0, 1)");
+    }
+    if (options.sweepTones < 2 || options.multiTones < 1) {
+        throw std::invalid_argument("Need at least two sweep tones and one multi-tone");
+    }
+
+    const double nyquist = 0.5 * std::min(inputRate, outputRate);
+    const double wideNyquist = 0.5 * std::max(inputRate, outputRate);
+    const double passband = options.passbandEdge * nyquist;
+    const double stopStart = std::min((2.0 - options.passbandEdge) * nyquist, 0.5 * (nyquist + wideNyquist));
+    const std::vector<double> zeroPhase(1, 0.0);
+    const double amplitude = options.amplitude;
+
+    IQQualityReport report;
+
+    // Multi-tone SNR: tones spread irregularly over the passband, with
+    // Schroeder phases to keep the peak at the requested amplitude
+    {
+        const int k = options.multiTones;
+        std::vector<double> frequencies(k);
+        std::vector<double> phases(k);
+        for (int i = 0; i < k; i++) {
+            double u = std::fmod(0.5 + i * GOLDEN_FRACTION, 1.0);
+            frequencies[i] = passband * (2.0 * u - 1.0);
+            phases[i] = M_PI * i * i / k;
+        }
+        std::vector<cd> out = resampleTones(factory, inputRate, outputRate, frequencies, phases,
+                                            amplitude / k, options);
+        ToneFit fit = fitAndRemove(out, frequencies, outputRate);
+        double signal = 0.0;
+        for (int i = 0; i < k; i++) {
+            signal += std::norm(fit.amplitudes[i]);
+        }
+        report.snrDb = toDb(signal / fit.residualPower);
+    }
+
+    // SFDR: one tone, largest spur of what remains
+    {
+        std::vector<double> frequency(1, (1.0 - GOLDEN_FRACTION) * passband);
+        std::vector<cd> out = resampleTones(factory, inputRate, outputRate, frequency, zeroPhase,
+                                            amplitude, options);
+        ToneFit fit = fitAndRemove(out, frequency, outputRate);
+        double windowSum, windowPower;
+        std::vector<double> spectrum = powerSpectrum(fit.residual, windowSum, windowPower);
+        double spur = *std::max_element(spectrum.begin(), spectrum.end()) / (windowSum * windowSum);
+        report.sfdrDb = toDb(std::norm(fit.amplitudes[0]) / spur);
+    }
+
+    // Passband sweep: ripple, and image rejection when interpolating
+    double minGain = std::numeric_limits<double>::max();
+    double maxGain = 0.0;
+    double worstImages = std::numeric_limits<double>::max();
+    for (int i = 0; i < options.sweepTones; i++) {
+        std::vector<double> frequency(1, passband * i / (options.sweepTones - 1));
+        std::vector<cd> out = resampleTones(factory, inputRate, outputRate, frequency, zeroPhase,
+                                            amplitude, options);
+        ToneFit fit = fitAndRemove(out, frequency, outputRate);
+        double gain = std::abs(fit.amplitudes[0]) / amplitude;
+        minGain = std::min(minGain, gain);
+        maxGain = std::max(maxGain, gain);
+
+        if (outputRate > inputRate) {
+            double windowSum, windowPower;
+            std::vector<double> spectrum = powerSpectrum(fit.residual, windowSum, windowPower);
+            double images = 0.0;
+            for (size_t b = 0; b < n; b++) {
+                if (std::abs(binFrequency(b, n, outputRate)) >= stopStart) {
+                    images += spectrum[b];
+                }
+            }
+            images /= n * windowPower;
+            worstImages = std::min(worstImages, toDb(std::norm(fit.amplitudes[0]) / images));
+        }
+    }
+    report.passbandRippleDb = 20.0 * std::log10(maxGain / minGain);
+
+    // Stopband sweep when decimating: whatever comes out is aliasing
+    if (outputRate < inputRate) {
+        const double stopEnd = 0.98 * wideNyquist;
+        double worst = std::numeric_limits<double>::max();
+        for (int i = 0; i < options.sweepTones; i++) {
+            std::vector<double> frequency(1, stopStart + (stopEnd - stopStart) * i / (options.sweepTones - 1));
+            std::vector<cd> out = resampleTones(factory, inputRate, outputRate, frequency, zeroPhase,
+                                                amplitude, options);
+            double power = 0.0;
+            for (size_t j = 0; j < out.size(); j++) {
+                power += std::norm(out[j]);
+            }
+            worst = std::min(worst, toDb(amplitude * amplitude * out.size() / power));
+        }
+        report.stopbandRejectionDb = worst;
+    } else if (outputRate > inputRate) {
+        report.stopbandRejectionDb = worstImages;
+    } else {
+        report.stopbandRejectionDb = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return report;
+}
@@ -0,0 +1,67 @@
+#ifndef IQ_QUALITY_H
+#define IQ_QUALITY_H
+
+#include <complex>
+#include <functional>
+#include <vector>
+#include <stdexcept>
+
+// Test-signal settings for IQQuality::measure(). Band edges follow
+// IQFilterSpec: fractions of the narrower Nyquist band, min(in, out) / 2.
+struct IQQualityOptions {
+    double passbandEdge;     // Passband swept for ripple, and holding the SNR tones
+    int sweepTones;          // Single tones per swept band (passband and stopband)
+    int multiTones;          // Tones in the multi-tone SNR signal
+    double amplitude;        // Peak amplitude of every test signal
+    size_t settleSamples;    // Outputs discarded while the filter fills
+    size_t analysisSamples;  // Outputs analysed per test, a power of two
+
+    IQQualityOptions()
+        : passbandEdge(0.8), sweepTones(24), multiTones(7), amplitude(0.5),
+          settleSamples(4096), analysisSamples(8192) {}
+};
+
+// Quality of a resampler, measured against the exact (double precision)
+// tones its output should contain. All figures in dB; larger is better
+// except for ripple.
+struct IQQualityReport {
+    // Multi-tone passband signal: tone power over everything else (noise,
+    // aliases, images, distortion) after fitting each tone's gain and phase
+    double snrDb;
+
+    // Single passband tone: tone power over the largest spur in the output
+    // spectrum (Blackman-Harris window, tone removed first)
+    double sfdrDb;
+
+    // Swept passband tones: peak-to-peak gain variation
+    double passbandRippleDb;
+
+    // Swept tones, worst case. Decimation: tones between the output and
+    // input Nyquist frequencies, output power relative to the tone.
+    // Interpolation: passband tones, image power between the input and
+    // output Nyquist frequencies relative to the tone. NaN when the rates
+    // are equal. The sweep starts at (2 - passbandEdge) x the narrower
+    // Nyquist, or halfway to the wider one if that is closer.
+    double stopbandRejectionDb;
+};
+
+// Resampler-agnostic quality measurement: tones in, least-squares fit of
+// the same tones at the output rate, residual analysed in double.
+class IQQuality {
+public:
+    // Resample interleaved float IQ (one call, whole signal)
+    typedef std::function<std::vector<float>(const std::vector<float>&)> ProcessFunction;
+
+    // Fresh resampler per test signal, so no test sees another's history
+    typedef std::function<ProcessFunction()> Factory;
+
+    static IQQualityReport measure(const Factory& factory, int inputRate, int outputRate,
+                                   const IQQualityOptions& options = IQQualityOptions());
+
+    // Least-squares complex amplitudes of tones at frequencies (cycles per
+    // sample) in signal[0..count), fitted jointly
+    static std::vector<std::complex<double> > fitTones(const std::complex<double>* signal, size_t count,
+                                                       const std::vector<double>& frequencies);
+};
+
+#endif // IQ_QUALITY_H
@@ -5,6 +5,7 @@
 // This file includes the separate implementation files for Pure C++ and IPP
 
 #include "iq_resampler_cpp.h"
+#include "iq_resampler_q15.h"
 
 #ifdef USE_IPP
 #include "iq_resampler_ipp.h"
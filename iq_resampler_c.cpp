@@ -0,0 +1,280 @@
+#include "iq_resampler_c.h"
+#include "iq_resampler_cpp.h"
+#ifdef USE_IPP
+#include "iq_resampler_ipp.h"
+#endif
+#include <complex>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+struct iq_resampler {
+    iq_backend_t backend;
+    std::unique_ptr<IQResamplerCPP> cpp;
+#ifdef USE_IPP
+    std::unique_ptr<IQResamplerIPP> ipp;
+#endif
+};
+
+namespace {
+
+const char* const BACKEND_NAMES[] = {"linear", "polyphase", "polyphase_direct", "polyphase_fft",
+                                     "low_latency", "ipp"};
+const int NUM_BACKENDS = sizeof(BACKEND_NAMES) / sizeof(BACKEND_NAMES[0]);
+
+// Enums from C or an FFI can hold any int
+bool knownBackend(iq_backend_t backend) {
+    return (int)backend >= 0 && (int)backend < NUM_BACKENDS;
+}
+
+thread_local std::string lastError;
+
+iq_status_t fail(iq_status_t status, const char* message) {
+    lastError = message;
+    return status;
+}
+
+// Run f, turning the exceptions of the C++ API into status codes
+template <typename F>
+iq_status_t guarded(F f) {
+    try {
+        f();
+        return IQ_OK;
+    } catch (const std::length_error& e) {
+        return fail(IQ_ERROR_BUFFER_TOO_SMALL, e.what());
+    } catch (const std::invalid_argument& e) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, e.what());
+    } catch (const std::bad_alloc&) {
+        return fail(IQ_ERROR_OUT_OF_MEMORY, "out of memory");
+    } catch (const std::exception& e) {
+        return fail(IQ_ERROR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(IQ_ERROR_INTERNAL, "unknown error");
+    }
+}
+
+IQResamplerCPP::Mode cppMode(iq_backend_t backend) {
+    switch (backend) {
+    case IQ_BACKEND_LINEAR:
+        return IQResamplerCPP::Mode::Linear;
+    case IQ_BACKEND_POLYPHASE_DIRECT:
+        return IQResamplerCPP::Mode::PolyphaseDirect;
+    case IQ_BACKEND_POLYPHASE_FFT:
+        return IQResamplerCPP::Mode::PolyphaseFFT;
+    case IQ_BACKEND_LOW_LATENCY:
+        return IQResamplerCPP::Mode::LowLatency;
+    default:
+        return IQResamplerCPP::Mode::Polyphase;
+    }
+}
+
+// Interleaved float I/Q as complex samples (same layout, no copy)
+const std::complex<float>* asComplex(const float* p) {
+    return reinterpret_cast<const std::complex<float>*>(p);
+}
+
+std::complex<float>* asComplex(float* p) {
+    return reinterpret_cast<std::complex<float>*>(p);
+}
+
+} // namespace
+
+extern "C" {
+
+int iq_backend_available(iq_backend_t backend) {
+    if (backend == IQ_BACKEND_IPP) {
+#ifdef USE_IPP
+        return 1;
+#else
+        return 0;
+#endif
+    }
+    return knownBackend(backend);
+}
+
+const char* iq_backend_name(iq_backend_t backend) {
+    return knownBackend(backend) ? BACKEND_NAMES[backend] : "unknown";
+}
+
+int iq_backend_from_name(const char* name) {
+    if (name) {
+        for (int b = 0; b < NUM_BACKENDS; b++) {
+            if (std::strcmp(name, BACKEND_NAMES[b]) == 0) {
+                return b;
+            }
+        }
+    }
+    return -1;
+}
+
+int iq_resampler_abi_version(void) {
+    return IQ_RESAMPLER_ABI_VERSION;
+}
+
+const char* iq_status_string(iq_status_t status) {
+    switch (status) {
+    case IQ_OK:
+        return "ok";
+    case IQ_ERROR_INVALID_ARGUMENT:
+        return "invalid argument";
+    case IQ_ERROR_UNSUPPORTED:
+        return "unsupported";
+    case IQ_ERROR_BUFFER_TOO_SMALL:
+        return "buffer too small";
+    case IQ_ERROR_OUT_OF_MEMORY:
+        return "out of memory";
+    case IQ_ERROR_INTERNAL:
+        return "internal error";
+    }
+    return "unknown status";
+}
+
+const char* iq_last_error(void) {
+    return lastError.c_str();
+}
+
+int iq_minimum_filter_taps(int input_rate, int output_rate) {
+    if (input_rate <= 0 || output_rate <= 0) {
+        return 0;
+    }
+    return IQFilterDesign::minimumTaps(input_rate, output_rate);
+}
+
+iq_status_t iq_resampler_create(iq_resampler_t** out, int input_rate, int output_rate, int filter_taps,
+                                iq_backend_t backend) {
+    if (!out) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, "Handle pointer is null");
+    }
+    *out = nullptr;
+    if (input_rate <= 0 || output_rate <= 0) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, "Rates must be positive");
+    }
+    if (filter_taps <= 0) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, "Filter length must be positive");
+    }
+    if (!knownBackend(backend)) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, "Unknown backend");
+    }
+    if (!iq_backend_available(backend)) {
+        return fail(IQ_ERROR_UNSUPPORTED, "Backend not built into this library");
+    }
+
+    return guarded([&]() {
+        std::unique_ptr<iq_resampler> r(new iq_resampler());
+        r->backend = backend;
+#ifdef USE_IPP
+        if (backend == IQ_BACKEND_IPP) {
+            r->ipp.reset(new IQResamplerIPP(input_rate, output_rate, 0.9f, filter_taps));
+        }
+#endif
+        if (backend != IQ_BACKEND_IPP) {
+            r->cpp.reset(new IQResamplerCPP(input_rate, output_rate, filter_taps, cppMode(backend)));
+        }
+        *out = r.release();
+    });
+}
+
+void iq_resampler_destroy(iq_resampler_t* resampler) {
+    delete resampler;
+}
+
+iq_status_t iq_resampler_process(iq_resampler_t* resampler, const float* input, size_t num_input,
+                                 float* output, size_t output_capacity, size_t* num_output) {
+    if (!resampler || !num_output || (num_input > 0 && !input) || (output_capacity > 0 && !output)) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, "Null pointer");
+    }
+    *num_output = 0;
+    return guarded([&]() {
+#ifdef USE_IPP
+        if (resampler->ipp) {
+            *num_output = resampler->ipp->process(input, num_input, output, output_capacity);
+            return;
+        }
+#endif
+        if (num_input > 0) {
+            *num_output = resampler->cpp->process(asComplex(input), num_input, asComplex(output),
+                                                  output_capacity);
+        }
+    });
+}
+
+iq_status_t iq_resampler_flush(iq_resampler_t* resampler, float* output, size_t output_capacity,
+                               size_t* num_output) {
+    if (!resampler || !num_output || (output_capacity > 0 && !output)) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, "Null pointer");
+    }
+    *num_output = 0;
+    return guarded([&]() {
+        if (resampler->cpp) {
+            *num_output = resampler->cpp->flush(asComplex(output), output_capacity);
+        }
+    });
+}
+
+iq_status_t iq_resampler_reset(iq_resampler_t* resampler) {
+    if (!resampler) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, "Null pointer");
+    }
+    return guarded([&]() {
+#ifdef USE_IPP
+        if (resampler->ipp) {
+            resampler->ipp->reset();
+        }
+#endif
+        if (resampler->cpp) {
+            resampler->cpp->reset();
+        }
+    });
+}
+
+iq_status_t iq_resampler_reserve(iq_resampler_t* resampler, size_t max_input) {
+    if (!resampler) {
+        return fail(IQ_ERROR_INVALID_ARGUMENT, "Null pointer");
+    }
+    return guarded([&]() {
+#ifdef USE_IPP
+        if (resampler->ipp) {
+            resampler->ipp->reserve(max_input);
+        }
+#endif
+        if (resampler->cpp) {
+            resampler->cpp->reserve(max_input);
+        }
+    });
+}
+
+size_t iq_resampler_output_samples_for(const iq_resampler_t* resampler, size_t num_input) {
+    if (!resampler) {
+        return 0;
+    }
+#ifdef USE_IPP
+    if (resampler->ipp) {
+        return resampler->ipp->outputSamplesFor(num_input);
+    }
+#endif
+    return resampler->cpp->outputSamplesFor(num_input);
+}
+
+size_t iq_resampler_flush_samples(const iq_resampler_t* resampler) {
+    return (resampler && resampler->cpp) ? resampler->cpp->outputSamplesForFlush() : 0;
+}
+
+double iq_resampler_group_delay(const iq_resampler_t* resampler) {
+    if (!resampler) {
+        return 0.0;
+    }
+#ifdef USE_IPP
+    if (resampler->ipp) {
+        return resampler->ipp->groupDelay();
+    }
+#endif
+    return resampler->cpp->groupDelay();
+}
+
+iq_backend_t iq_resampler_backend(const iq_resampler_t* resampler) {
+    return resampler ? resampler->backend : IQ_BACKEND_POLYPHASE;
+}
+
+} // extern "C"
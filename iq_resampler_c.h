@@ -0,0 +1,140 @@
+#ifndef IQ_RESAMPLER_C_H
+#define IQ_RESAMPLER_C_H
+
+/*
+ * C interface to the resampler (libiqresampler), for C programs and FFI
+ * bindings. A resampler is an opaque handle; samples are interleaved
+ * float I/Q in caller-owned buffers, read and written in place (no
+ * copies), and every count is in IQ samples (one I/Q pair). Functions
+ * never throw: they return an iq_status_t, and iq_last_error() describes
+ * the most recent failure on the calling thread.
+ *
+ *     iq_resampler_t* r;
+ *     if (iq_resampler_create(&r, 120000, 100000, 127, IQ_BACKEND_POLYPHASE) != IQ_OK) ...
+ *     size_t n;
+ *     iq_resampler_process(r, in, numIn, out, iq_resampler_output_samples_for(r, numIn), &n);
+ *     iq_resampler_flush(r, out, iq_resampler_flush_samples(r), &n);
+ *     iq_resampler_destroy(r);
+ *
+ * One handle is used by one thread at a time; separate handles are
+ * independent.
+ */
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(IQ_RESAMPLER_SHARED)
+#if defined(IQ_RESAMPLER_C_BUILD)
+#define IQ_RESAMPLER_API __declspec(dllexport)
+#else
+#define IQ_RESAMPLER_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define IQ_RESAMPLER_API __attribute__((visibility("default")))
+#else
+#define IQ_RESAMPLER_API
+#endif
+
+/* ABI version. The major number is the shared library's SONAME
+ * (libiqresampler.so.1) and changes with every incompatible change to
+ * this header; the minor number counts compatible additions, the patch
+ * number fixes. CMakeLists.txt reads the library VERSION from here. */
+#define IQ_RESAMPLER_ABI_MAJOR 1
+#define IQ_RESAMPLER_ABI_MINOR 0
+#define IQ_RESAMPLER_ABI_PATCH 0
+#define IQ_RESAMPLER_ABI_VERSION \
+    (IQ_RESAMPLER_ABI_MAJOR * 10000 + IQ_RESAMPLER_ABI_MINOR * 100 + IQ_RESAMPLER_ABI_PATCH)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct iq_resampler iq_resampler_t;
+
+/* Resampling engine, chosen per handle at runtime. The first five are the
+ * IQResamplerCPP modes; IQ_BACKEND_IPP is only available when the library
+ * was built with USE_IPP (see iq_backend_available()). */
+typedef enum {
+    IQ_BACKEND_LINEAR = 0,
+    IQ_BACKEND_POLYPHASE = 1,        /* direct form, FFT for long filters */
+    IQ_BACKEND_POLYPHASE_DIRECT = 2,
+    IQ_BACKEND_POLYPHASE_FFT = 3,
+    IQ_BACKEND_LOW_LATENCY = 4,      /* minimum-phase prototype */
+    IQ_BACKEND_IPP = 5               /* Intel IPP; restarts its time every block, no flush */
+} iq_backend_t;
+
+typedef enum {
+    IQ_OK = 0,
+    IQ_ERROR_INVALID_ARGUMENT = -1,  /* null pointer, bad rate or filter length */
+    IQ_ERROR_UNSUPPORTED = -2,       /* backend not built into this library */
+    IQ_ERROR_BUFFER_TOO_SMALL = -3,  /* output capacity below what the call produces */
+    IQ_ERROR_OUT_OF_MEMORY = -4,
+    IQ_ERROR_INTERNAL = -5
+} iq_status_t;
+
+/* Backend metadata: whether this build has it, its name ("polyphase",
+ * "ipp", ...), and the backend with that name (-1 when unknown), so a
+ * backend can come from a configuration string */
+IQ_RESAMPLER_API int iq_backend_available(iq_backend_t backend);
+IQ_RESAMPLER_API const char* iq_backend_name(iq_backend_t backend);
+IQ_RESAMPLER_API int iq_backend_from_name(const char* name);
+
+/* IQ_RESAMPLER_ABI_VERSION of the library actually loaded. A caller built
+ * against this header can require
+ * iq_resampler_abi_version() / 10000 == IQ_RESAMPLER_ABI_MAJOR and
+ * iq_resampler_abi_version() >= IQ_RESAMPLER_ABI_VERSION */
+IQ_RESAMPLER_API int iq_resampler_abi_version(void);
+
+IQ_RESAMPLER_API const char* iq_status_string(iq_status_t status);
+
+/* Message of the last failed call on this thread ("" when none) */
+IQ_RESAMPLER_API const char* iq_last_error(void);
+
+/* Fewest filter_taps iq_resampler_create() accepts for the polyphase
+ * backends at this ratio (8 x max(L, M) for the reduced ratio L/M, e.g.
+ * 1280 for 48000 -> 44100), 0 for invalid rates */
+IQ_RESAMPLER_API int iq_minimum_filter_taps(int input_rate, int output_rate);
+
+/* Create a resampler from input_rate to output_rate (Hz) with a
+ * filter_taps-tap prototype (ignored by IQ_BACKEND_LINEAR; at least
+ * iq_minimum_filter_taps() for the other C++ backends). *out is set to
+ * the handle, or to NULL on failure. */
+IQ_RESAMPLER_API iq_status_t iq_resampler_create(iq_resampler_t** out, int input_rate, int output_rate,
+                                                 int filter_taps, iq_backend_t backend);
+
+/* Free the handle (NULL is ignored) */
+IQ_RESAMPLER_API void iq_resampler_destroy(iq_resampler_t* resampler);
+
+/* Resample num_input IQ samples into output, which must hold
+ * iq_resampler_output_samples_for(num_input) samples. *num_output receives
+ * the samples written. input and output must not overlap. */
+IQ_RESAMPLER_API iq_status_t iq_resampler_process(iq_resampler_t* resampler, const float* input,
+                                                  size_t num_input, float* output, size_t output_capacity,
+                                                  size_t* num_output);
+
+/* End of stream: write the outputs still held back by the filter delay
+ * (iq_resampler_flush_samples() of them), then reset for the next stream */
+IQ_RESAMPLER_API iq_status_t iq_resampler_flush(iq_resampler_t* resampler, float* output,
+                                                size_t output_capacity, size_t* num_output);
+
+/* Drop the filter state and start a new stream */
+IQ_RESAMPLER_API iq_status_t iq_resampler_reset(iq_resampler_t* resampler);
+
+/* Size the scratch buffers for blocks of up to max_input samples, so
+ * process and flush do not allocate */
+IQ_RESAMPLER_API iq_status_t iq_resampler_reserve(iq_resampler_t* resampler, size_t max_input);
+
+/* Exact output count of the next process call for num_input samples, and
+ * of the next flush */
+IQ_RESAMPLER_API size_t iq_resampler_output_samples_for(const iq_resampler_t* resampler, size_t num_input);
+IQ_RESAMPLER_API size_t iq_resampler_flush_samples(const iq_resampler_t* resampler);
+
+/* Algorithmic delay in input samples */
+IQ_RESAMPLER_API double iq_resampler_group_delay(const iq_resampler_t* resampler);
+
+IQ_RESAMPLER_API iq_backend_t iq_resampler_backend(const iq_resampler_t* resampler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQ_RESAMPLER_C_H */
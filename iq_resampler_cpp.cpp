@@ -1,42 +1,31 @@
 #include "iq_resampler_cpp.h"
 #include <algorithm>
+#include <utility>
 
-void IQResamplerCPP::generateFilter(int numTaps, float cutoffFreq) {
-    filter_.resize(numTaps);
-    float sum = 0.0f;
-    int center = numTaps / 2;
+// SIMD kernels follow the target flags; build with -DIQ_RESAMPLER_SCALAR
+// to get the plain C++ kernels (for benchmarking them against SIMD)
+#if !defined(IQ_RESAMPLER_SCALAR) && defined(__AVX__)
+#define IQ_KERNEL_AVX 1
+#elif !defined(IQ_RESAMPLER_SCALAR) && defined(__SSE__)
+#define IQ_KERNEL_SSE 1
+#endif
 
-    for (int i = 0; i < numTaps; i++) {
-        float t = i - center;
+#if defined(IQ_KERNEL_AVX) || defined(IQ_KERNEL_SSE)
+#include <immintrin.h>
+#endif
 
-        // Sinc function
-        float h;
-        if (t == 0) {
-            h = 2.0f * cutoffFreq;
-        } else {
-            h = std::sin(2.0f * M_PI * cutoffFreq * t) / (M_PI * t);
-        }
+namespace {
 
-        // Hamming window
-        float window = 0.54f - 0.46f * std::cos(2.0f * M_PI * i / (numTaps - 1));
-        filter_[i] = h * window;
-        sum += filter_[i];
-    }
+// Zero padding fed through the filter by flush(), in blocks of this size
+const int FLUSH_BLOCK_SAMPLES = 64;
+const std::complex<float> FLUSH_ZEROS[FLUSH_BLOCK_SAMPLES] = {};
 
-    // Normalize to preserve DC gain
-    for (int i = 0; i < numTaps; i++) {
-        filter_[i] /= sum;
-    }
-}
+// Tags that fit without calling reserveTags()
+const size_t DEFAULT_TAG_CAPACITY = 64;
 
-int IQResamplerCPP::gcd(int a, int b) {
-    while (b != 0) {
-        int temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
-}
+} // namespace
+
+const size_t IQResamplerCPP::DEFAULT_MAX_BLOCK_SAMPLES;
 
 float IQResamplerCPP::interpolate(const std::vector<float>& signal, float position) {
     float result = 0.0f;
@@ -66,90 +55,995 @@ float IQResamplerCPP::interpolate(const std::vector<float>& signal, float positi
     return result;
 }
 
-IQResamplerCPP::IQResamplerCPP(int inputRate, int outputRate, int filterTaps)
-    : inputRate_(inputRate), outputRate_(outputRate), inputPos_(0) {
+void IQResamplerCPP::buildPolyphaseBank() {
+    branchLen_ = (filterLen_ + upFactor_ - 1) / upFactor_;
+    bank_.assign((size_t)upFactor_ * branchLen_, 0.0f);
+
+    // Branch p holds taps p, p + L, p + 2L, ... scaled by L to restore the
+    // gain lost to zero-stuffing
+    for (int p = 0; p < upFactor_; p++) {
+        float* taps = &bank_[(size_t)p * branchLen_];
+        for (int k = 0; k < branchLen_; k++) {
+            int idx = p + k * upFactor_;
+            if (idx < filterLen_) {
+                taps[branchLen_ - 1 - k] = filter_[idx] * upFactor_;
+            }
+        }
+    }
+
+    // A single branch (no interpolation) is the linear-phase prototype
+    // itself. Float rounding in the design can leave mirrored taps an ulp
+    // apart, so near-symmetric banks are made exactly symmetric.
+    symmetricBank_ = false;
+    if (upFactor_ == 1 && branchLen_ > 1) {
+        float peak = 0.0f;
+        for (int k = 0; k < branchLen_; k++) {
+            peak = std::max(peak, std::abs(bank_[k]));
+        }
+        symmetricBank_ = true;
+        for (int k = 0; k < branchLen_ / 2 && symmetricBank_; k++) {
+            symmetricBank_ = std::abs(bank_[k] - bank_[branchLen_ - 1 - k]) <= 1e-6f * peak;
+        }
+        if (symmetricBank_) {
+            int half = branchLen_ / 2;
+            foldBank_.assign((half + 7) / 8 * 8, 0.0f);
+            for (int k = 0; k < half; k++) {
+                float mean = 0.5f * (bank_[k] + bank_[branchLen_ - 1 - k]);
+                bank_[k] = mean;
+                bank_[branchLen_ - 1 - k] = mean;
+                foldBank_[k] = mean;
+            }
+        }
+    }
+}
+
+IQResamplerCPP::IQResamplerCPP(int inputRate, int outputRate, int filterTaps, Mode mode)
+    : inputRate_(inputRate), outputRate_(outputRate), mode_(mode), branchLen_(0),
+      symmetricBank_(false), foldSymmetric_(true), stateI_(nullptr), stateQ_(nullptr), stateLen_(0),
+      maxBlock_(0), workI_(nullptr), workQ_(nullptr), convertBuf_(nullptr), stageBuf_(nullptr),
+      inputPos_(0), outputPos_(0), phase_(0), nextIndex_(0), groupDelay_(0.0), tagHead_(0),
+      tagCapacity_(0), pullInput_(nullptr), pullChunk_(0), pullPending_(nullptr), pullPendingLen_(0),
+      pendingStart_(0), pendingCount_(0) {
 
     // Simplify the ratio
-    int g = gcd(inputRate, outputRate);
+    int g = IQFilterDesign::gcd(inputRate, outputRate);
     upFactor_ = outputRate / g;
     downFactor_ = inputRate / g;
 
     filterLen_ = filterTaps;
+    if (mode != Mode::Linear) {
+        IQFilterDesign::checkTaps(inputRate, outputRate, filterTaps);
+    }
 
     // Generate anti-aliasing filter
-    float cutoff = 0.5f / std::max(upFactor_, downFactor_);
-    generateFilter(filterLen_, cutoff);
+    std::vector<double> prototype = IQFilterDesign::hamming(upFactor_, downFactor_, filterLen_);
+    filter_.assign(prototype.begin(), prototype.end());
+
+    init();
+}
+
+IQResamplerCPP::IQResamplerCPP(int inputRate, int outputRate, const IQFilterSpec& spec, Mode mode)
+    : inputRate_(inputRate), outputRate_(outputRate), mode_(mode), branchLen_(0),
+      symmetricBank_(false), foldSymmetric_(true), stateI_(nullptr), stateQ_(nullptr), stateLen_(0),
+      maxBlock_(0), workI_(nullptr), workQ_(nullptr), convertBuf_(nullptr), stageBuf_(nullptr),
+      inputPos_(0), outputPos_(0), phase_(0), nextIndex_(0), groupDelay_(0.0), tagHead_(0),
+      tagCapacity_(0), pullInput_(nullptr), pullChunk_(0), pullPending_(nullptr), pullPendingLen_(0),
+      pendingStart_(0), pendingCount_(0) {
+
+    // Simplify the ratio
+    int g = IQFilterDesign::gcd(inputRate, outputRate);
+    upFactor_ = outputRate / g;
+    downFactor_ = inputRate / g;
+
+    // Shortest Kaiser prototype that meets spec
+    filter_ = IQFilterDesign::kaiser(upFactor_, downFactor_, spec);
+    filterLen_ = (int)filter_.size();
+
+    init();
+}
+
+IQResamplerCPP::IQResamplerCPP(const IQResamplerCPP& other)
+    : inputRate_(other.inputRate_), outputRate_(other.outputRate_), upFactor_(other.upFactor_),
+      downFactor_(other.downFactor_), filter_(other.filter_), filterLen_(other.filterLen_),
+      mode_(other.mode_), bank_(other.bank_), branchLen_(other.branchLen_),
+      symmetricBank_(other.symmetricBank_), foldSymmetric_(other.foldSymmetric_),
+      foldBank_(other.foldBank_),
+      fftEngine_(other.fftEngine_ ? new IQResamplerFFT(*other.fftEngine_) : nullptr),
+      stateI_(other.stateI_), stateQ_(other.stateQ_), stateLen_(other.stateLen_),
+      maxBlock_(0), workI_(nullptr), workQ_(nullptr), convertBuf_(nullptr), stageBuf_(nullptr),
+      inputPos_(other.inputPos_), outputPos_(other.outputPos_), phase_(other.phase_),
+      nextIndex_(other.nextIndex_), groupDelay_(other.groupDelay_), pendingTags_(other.pendingTags_),
+      tagHead_(other.tagHead_), readyTags_(other.readyTags_), tagCapacity_(other.tagCapacity_),
+      inputSource_(other.inputSource_), pullInput_(nullptr), pullChunk_(0),
+      pullPending_(other.pullPending_), pullPendingLen_(other.pullPendingLen_),
+      pendingStart_(other.pendingStart_), pendingCount_(other.pendingCount_) {
+
+    // History and pending pull outputs are read from other's arena while
+    // place() carves them from this one's
+    place(other.maxBlock_, other.pullChunk_, other.arena_.policy());
+    pendingTags_.reserve(tagCapacity_);
+    readyTags_.reserve(tagCapacity_);
+}
+
+IQResamplerCPP& IQResamplerCPP::operator=(const IQResamplerCPP& other) {
+    if (this != &other) {
+        *this = IQResamplerCPP(other);
+    }
+    return *this;
+}
+
+IQFilterResponse IQResamplerCPP::filterResponse(const IQFilterSpec& spec) const {
+    return IQFilterDesign::response(filter_, upFactor_, downFactor_, spec, inputRate_);
+}
+
+void IQResamplerCPP::init() {
+    if (mode_ == Mode::LowLatency) {
+        filter_ = IQFilterDesign::minimumPhase(filter_);
+    }
 
     // Initialize state buffers
-    stateI_.resize(filterLen_, 0.0f);
-    stateQ_.resize(filterLen_, 0.0f);
+    if (mode_ != Mode::Linear) {
+        buildPolyphaseBank();
+        if (mode_ == Mode::PolyphaseFFT ||
+            (mode_ == Mode::Polyphase && branchLen_ >= FFT_CROSSOVER_BRANCH_TAPS)) {
+            fftEngine_.reset(new IQResamplerFFT(inputRate_, outputRate_, filter_));
+        }
+        stateLen_ = branchLen_ - 1;
+
+        // Prototype taps are 1 / L input samples apart
+        groupDelay_ = IQFilterDesign::groupDelay(filter_) / upFactor_;
+    } else {
+        // Linear interpolation only needs the previous block's last sample
+        stateLen_ = 1;
+        groupDelay_ = 0.0;
+    }
+
+    // One input sample yields at most ceil(L / M) outputs
+    pullPendingLen_ = (upFactor_ + downFactor_ - 1) / downFactor_;
+
+    // All scratch up front, so processing never allocates
+    reserve(DEFAULT_MAX_BLOCK_SAMPLES);
+    reserveTags(DEFAULT_TAG_CAPACITY);
 }
 
-std::vector<float> IQResamplerCPP::process(const std::vector<float>& input) {
-    if (input.size() % 2 != 0) {
-        throw std::invalid_argument("Input size must be even (I/Q pairs)");
+namespace {
+
+// Store one output value in the requested sample format
+inline void storeOutput(float value, float /*scale*/, float* dst) {
+    *dst = value;
+}
+
+inline void storeOutput(float value, float scale, int16_t* dst) {
+    float scaled = value * scale;
+    if (scaled >= 32767.0f) {
+        *dst = 32767;
+    } else if (scaled <= -32768.0f) {
+        *dst = -32768;
+    } else {
+        *dst = (int16_t)std::lrint(scaled);
     }
+}
 
-    int numInputSamples = input.size() / 2;
+#if defined(IQ_KERNEL_AVX)
+inline float horizontalSum(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+    return _mm_cvtss_f32(lo);
+}
+#elif defined(IQ_KERNEL_SSE)
+inline float horizontalSum(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 0x55));
+    return _mm_cvtss_f32(v);
+}
+#endif
 
-    // Separate I and Q
-    std::vector<float> inI(stateI_.size() + numInputSamples);
-    std::vector<float> inQ(stateQ_.size() + numInputSamples);
+// Dot product of one filter branch with the I and Q windows, sharing
+// each coefficient load between both channels
+inline void dotProductIQ(const float* xI, const float* xQ, const float* h, int n,
+                         float& outI, float& outQ) {
+    int j = 0;
+    float sumI = 0.0f;
+    float sumQ = 0.0f;
+
+#if defined(IQ_KERNEL_AVX)
+    __m256 accI = _mm256_setzero_ps();
+    __m256 accQ = _mm256_setzero_ps();
+    for (; j + 8 <= n; j += 8) {
+        __m256 c = _mm256_loadu_ps(h + j);
+#if defined(__FMA__)
+        accI = _mm256_fmadd_ps(_mm256_loadu_ps(xI + j), c, accI);
+        accQ = _mm256_fmadd_ps(_mm256_loadu_ps(xQ + j), c, accQ);
+#else
+        accI = _mm256_add_ps(accI, _mm256_mul_ps(_mm256_loadu_ps(xI + j), c));
+        accQ = _mm256_add_ps(accQ, _mm256_mul_ps(_mm256_loadu_ps(xQ + j), c));
+#endif
+    }
+    sumI = horizontalSum(accI);
+    sumQ = horizontalSum(accQ);
+#elif defined(IQ_KERNEL_SSE)
+    __m128 accI = _mm_setzero_ps();
+    __m128 accQ = _mm_setzero_ps();
+    for (; j + 4 <= n; j += 4) {
+        __m128 c = _mm_loadu_ps(h + j);
+        accI = _mm_add_ps(accI, _mm_mul_ps(_mm_loadu_ps(xI + j), c));
+        accQ = _mm_add_ps(accQ, _mm_mul_ps(_mm_loadu_ps(xQ + j), c));
+    }
+    sumI = horizontalSum(accI);
+    sumQ = horizontalSum(accQ);
+#endif
+
+    for (; j < n; j++) {
+        sumI += xI[j] * h[j];
+        sumQ += xQ[j] * h[j];
+    }
 
+    outI = sumI;
+    outQ = sumQ;
+}
+
+#if defined(IQ_KERNEL_AVX)
+// Load 8 floats starting at p in reverse order
+inline __m256 loadReversed(const float* p) {
+#if defined(__AVX2__)
+    return _mm256_permutevar8x32_ps(_mm256_loadu_ps(p), _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+#else
+    __m256 v = _mm256_permute_ps(_mm256_loadu_ps(p), 0x1B);
+    return _mm256_permute2f128_ps(v, v, 0x01);
+#endif
+}
+#elif defined(IQ_KERNEL_SSE)
+inline __m128 loadReversed(const float* p) {
+    __m128 v = _mm_loadu_ps(p);
+    return _mm_shuffle_ps(v, v, 0x1B);
+}
+#endif
+
+// Same as dotProductIQ for a symmetric branch of n taps: mirrored samples
+// are added first, so only half the taps are multiplied. fold holds the
+// first n / 2 taps zero-padded to a multiple of 8, so the SIMD loop needs
+// no scalar tail; centre is the middle tap of odd-length branches.
+inline void dotProductIQSymmetric(const float* xI, const float* xQ, const float* fold, float centre,
+                                  int n, float& outI, float& outQ) {
+    const int half = n / 2;
+    int j = 0;
+    float sumI = 0.0f;
+    float sumQ = 0.0f;
+
+    // The padded last block reads past the middle of the window (times a
+    // zero tap); the length checks keep those reads inside the window
+#if defined(IQ_KERNEL_AVX)
+    if (n >= 16) {
+        __m256 accI = _mm256_setzero_ps();
+        __m256 accQ = _mm256_setzero_ps();
+        for (; j < half; j += 8) {
+            __m256 c = _mm256_loadu_ps(fold + j);
+            __m256 pairI = _mm256_add_ps(_mm256_loadu_ps(xI + j), loadReversed(xI + n - 8 - j));
+            __m256 pairQ = _mm256_add_ps(_mm256_loadu_ps(xQ + j), loadReversed(xQ + n - 8 - j));
+#if defined(__FMA__)
+            accI = _mm256_fmadd_ps(pairI, c, accI);
+            accQ = _mm256_fmadd_ps(pairQ, c, accQ);
+#else
+            accI = _mm256_add_ps(accI, _mm256_mul_ps(pairI, c));
+            accQ = _mm256_add_ps(accQ, _mm256_mul_ps(pairQ, c));
+#endif
+        }
+        sumI = horizontalSum(accI);
+        sumQ = horizontalSum(accQ);
+    }
+#elif defined(IQ_KERNEL_SSE)
+    if (n >= 8) {
+        __m128 accI = _mm_setzero_ps();
+        __m128 accQ = _mm_setzero_ps();
+        for (; j < half; j += 4) {
+            __m128 c = _mm_loadu_ps(fold + j);
+            __m128 pairI = _mm_add_ps(_mm_loadu_ps(xI + j), loadReversed(xI + n - 4 - j));
+            __m128 pairQ = _mm_add_ps(_mm_loadu_ps(xQ + j), loadReversed(xQ + n - 4 - j));
+            accI = _mm_add_ps(accI, _mm_mul_ps(pairI, c));
+            accQ = _mm_add_ps(accQ, _mm_mul_ps(pairQ, c));
+        }
+        sumI = horizontalSum(accI);
+        sumQ = horizontalSum(accQ);
+    }
+#endif
+
+    for (; j < half; j++) {
+        sumI += (xI[j] + xI[n - 1 - j]) * fold[j];
+        sumQ += (xQ[j] + xQ[n - 1 - j]) * fold[j];
+    }
+
+    if (n % 2 != 0) {
+        sumI += xI[half] * centre;
+        sumQ += xQ[half] * centre;
+    }
+
+    outI = sumI;
+    outQ = sumQ;
+}
+
+// View interleaved input as complex<float>, converting into scratch
+// only when needed
+inline const std::complex<float>* asComplexInput(const float* input, size_t numSamples, float scale,
+                                                 std::complex<float>* scratch) {
+    if (scale == 1.0f) {
+        return reinterpret_cast<const std::complex<float>*>(input);
+    }
+    for (size_t i = 0; i < numSamples; i++) {
+        scratch[i] = std::complex<float>(input[i * 2] * scale, input[i * 2 + 1] * scale);
+    }
+    return scratch;
+}
+
+template <typename T>
+inline const std::complex<float>* asComplexInput(const T* input, size_t numSamples, float scale,
+                                                 std::complex<float>* scratch) {
+    for (size_t i = 0; i < numSamples; i++) {
+        scratch[i] = std::complex<float>((float)input[i * 2] * scale, (float)input[i * 2 + 1] * scale);
+    }
+    return scratch;
+}
+
+// Where the FFT engine should write: straight into float output, or into
+// the staging scratch for formats that need conversion
+inline std::complex<float>* asComplexOutput(float* output, std::complex<float>* /*scratch*/) {
+    return reinterpret_cast<std::complex<float>*>(output);
+}
+
+inline std::complex<float>* asComplexOutput(int16_t* /*output*/, std::complex<float>* scratch) {
+    return scratch;
+}
+
+} // namespace
+
+template <typename T>
+void IQResamplerCPP::loadInput(const T* input, int numInputSamples, float scale, float* inI, float* inQ) {
     // Copy state
-    for (size_t i = 0; i < stateI_.size(); i++) {
+    for (size_t i = 0; i < stateLen_; i++) {
         inI[i] = stateI_[i];
         inQ[i] = stateQ_[i];
     }
 
-    // Copy new input
+    // Copy new input, converting to float in the same pass
+    float* dstI = inI + stateLen_;
+    float* dstQ = inQ + stateLen_;
     for (int i = 0; i < numInputSamples; i++) {
-        inI[stateI_.size() + i] = input[i * 2];
-        inQ[stateQ_.size() + i] = input[i * 2 + 1];
+        dstI[i] = (float)input[i * 2] * scale;
+        dstQ[i] = (float)input[i * 2 + 1] * scale;
+    }
+}
+
+size_t IQResamplerCPP::outputSamplesFor(size_t numInputSamples) const {
+    if (fftEngine_) {
+        return fftEngine_->outputSamplesFor(numInputSamples);
+    }
+    return outputSamplesAt(nextIndex_, phase_, numInputSamples);
+}
+
+size_t IQResamplerCPP::maxOutputSamplesFor(size_t numInputSamples) const {
+    // ceil(n x L / M) outputs, plus one when the first lands on the
+    // block's first sample
+    return (numInputSamples * upFactor_ + downFactor_ - 1) / downFactor_ + 1;
+}
+
+size_t IQResamplerCPP::outputSamplesAt(int nextIndex, int phase, size_t numInputSamples) const {
+    if (mode_ != Mode::Linear) {
+        // Outputs land on input indices nextIndex, nextIndex + M/L, ...
+        long long span = (long long)numInputSamples - nextIndex;
+        if (span <= 0) {
+            return 0;
+        }
+        long long upsampled = span * upFactor_ - phase;
+        return (size_t)((upsampled + downFactor_ - 1) / downFactor_);
+    }
+    // Linear: outputs at upsampled positions m = nextIndex*L + phase +
+    // k*M, up to the last sample (n - 1)*L
+    long long first = (long long)nextIndex * upFactor_ + phase;
+    long long last = ((long long)numInputSamples - 1) * upFactor_;
+    if (last < first) {
+        return 0;
+    }
+    return (size_t)((last - first) / downFactor_ + 1);
+}
+
+size_t IQResamplerCPP::inputSamplesNeededFor(size_t numOutputSamples) const {
+    if (fftEngine_) {
+        return fftEngine_->inputSamplesNeededFor(numOutputSamples);
+    }
+    if (numOutputSamples == 0) {
+        return 0;
+    }
+
+    // Upsampled position of the last requested output and the input sample
+    // (plus the one after it for Linear between samples) it waits for
+    long long m = (long long)nextIndex_ * upFactor_ + phase_ + (long long)(numOutputSamples - 1) * downFactor_;
+    long long idx = (m >= 0) ? m / upFactor_ : -((-m + upFactor_ - 1) / upFactor_);
+    long long needed = idx + 1;
+    if (mode_ == Mode::Linear && m % upFactor_ != 0) {
+        needed++;
     }
+    return (size_t)std::max(0LL, needed);
+}
 
-    // Calculate output size
-    int numOutputSamples = (int)((long long)numInputSamples * outputRate_ / inputRate_);
-    std::vector<float> output;
-    output.reserve(numOutputSamples * 2 + 10);
+template <typename T, typename OutT>
+size_t IQResamplerCPP::processInterleaved(const T* input, size_t numSamples, float inScale,
+                                          OutT* output, float outScale) {
+    const IQTelemetry::Ticks start = IQTelemetry::now();
 
-    // Resample with proper interpolation
-    float ratio = (float)inputRate_ / (float)outputRate_;
+    // Blocks longer than the scratch is sized for go through in pieces
+    size_t produced = 0;
+    size_t offset = 0;
+    do {
+        size_t n = std::min(numSamples - offset, maxBlock_);
+        produced += fftEngine_ ? processFFT(input + offset * 2, n, inScale, output + produced * 2, outScale)
+                               : resampleBlock(input + offset * 2, n, inScale, output + produced * 2, outScale);
+        offset += n;
+    } while (offset < numSamples);
+
+    inputPos_ += numSamples;
+    outputPos_ += produced;
+    if (tagHead_ < pendingTags_.size()) {
+        releaseTags();
+    }
+    telemetry_.record(start, numSamples, produced);
+    return produced;
+}
 
-    for (int i = 0; i < numOutputSamples; i++) {
-        float inputPos = (float)stateI_.size() + i * ratio;
+template <typename T, typename OutT>
+size_t IQResamplerCPP::resampleBlock(const T* input, size_t numSamples, float inScale,
+                                     OutT* output, float outScale) {
+    int numInputSamples = (int)numSamples;
 
-        if (inputPos < inI.size() - filterLen_/2) {
-            // Linear interpolation for speed (can use sinc for quality)
-            int idx = (int)inputPos;
-            float frac = inputPos - idx;
+    // Separate I and Q
+    float* inI = workI_;
+    float* inQ = workQ_;
+    const size_t workLen = stateLen_ + numInputSamples;
+    loadInput(input, numInputSamples, inScale, inI, inQ);
 
-            float valI, valQ;
-            if (idx + 1 < (int)inI.size()) {
-                valI = inI[idx] * (1.0f - frac) + inI[idx + 1] * frac;
-                valQ = inQ[idx] * (1.0f - frac) + inQ[idx + 1] * frac;
-            } else {
-                valI = inI[idx];
-                valQ = inQ[idx];
-            }
+    size_t produced = 0;
+
+    if (mode_ != Mode::Linear) {
+        int idx = nextIndex_;
+        int phase = phase_;
+        produced = filterBlock(inI, inQ, numInputSamples, idx, phase, output, outScale);
+        nextIndex_ = idx - numInputSamples;
+        phase_ = phase;
+
+        // Keep the last branchLen_ - 1 samples as history
+        size_t tail = workLen - stateLen_;
+        std::copy(inI + tail, inI + workLen, stateI_);
+        std::copy(inQ + tail, inQ + workLen, stateQ_);
+        return produced;
+    }
+
+    // Linear interpolation: output n sits at input position n*M/L, i.e.
+    // sample idx plus phase / L of the way to idx + 1. inI[0] holds the
+    // previous block's last sample, so sample idx is inI[idx + 1]. An output
+    // is emitted as soon as both its samples (one on exact positions) exist.
+    int idx = nextIndex_;
+    int phase = phase_;
+    const float invUp = 1.0f / upFactor_;
+    while (idx + (phase != 0 ? 1 : 0) < numInputSamples) {
+        float frac = phase * invUp;
+        int pos = idx + 1;
+
+        float valI, valQ;
+        if (phase != 0) {
+            valI = inI[pos] * (1.0f - frac) + inI[pos + 1] * frac;
+            valQ = inQ[pos] * (1.0f - frac) + inQ[pos + 1] * frac;
+        } else {
+            valI = inI[pos];
+            valQ = inQ[pos];
+        }
+
+        storeOutput(valI, outScale, &output[produced * 2]);
+        storeOutput(valQ, outScale, &output[produced * 2 + 1]);
+        produced++;
+
+        phase += downFactor_;
+        idx += phase / upFactor_;
+        phase %= upFactor_;
+    }
+    nextIndex_ = idx - numInputSamples;
+    phase_ = phase;
+
+    // Keep the last sample (unchanged for empty blocks)
+    if (numInputSamples > 0) {
+        stateI_[0] = inI[workLen - 1];
+        stateQ_[0] = inQ[workLen - 1];
+    }
+
+    return produced;
+}
+
+template <typename OutT>
+size_t IQResamplerCPP::filterBlock(const float* inI, const float* inQ, int numInputSamples,
+                                   int& idx, int& phase, OutT* output, float outScale) const {
+    // Output n sits at upsampled index n*M, i.e. input index idx with
+    // branch phase; its window is inI[idx .. idx + branchLen_ - 1]
+    size_t produced = 0;
+    const bool fold = usesSymmetricFolding();
+    while (idx < numInputSamples) {
+        float valI, valQ;
+        if (fold) {
+            dotProductIQSymmetric(&inI[idx], &inQ[idx], foldBank_.data(), bank_[branchLen_ / 2],
+                                  branchLen_, valI, valQ);
+        } else {
+            dotProductIQ(&inI[idx], &inQ[idx], &bank_[(size_t)phase * branchLen_],
+                         branchLen_, valI, valQ);
+        }
+        storeOutput(valI, outScale, &output[produced * 2]);
+        storeOutput(valQ, outScale, &output[produced * 2 + 1]);
+        produced++;
+
+        phase += downFactor_;
+        idx += phase / upFactor_;
+        phase %= upFactor_;
+    }
+    return produced;
+}
+
+template <typename T, typename OutT>
+size_t IQResamplerCPP::processFFT(const T* input, size_t numInputSamples, float inScale,
+                                  OutT* output, float outScale) {
+    // Float IQ is already complex<float> in memory; other formats convert
+    const std::complex<float>* in = asComplexInput(input, numInputSamples, inScale, convertBuf_);
+    std::complex<float>* out = asComplexOutput(output, stageBuf_);
 
-            output.push_back(valI);
-            output.push_back(valQ);
+    size_t produced = fftEngine_->process(in, numInputSamples, out);
+    if (out == stageBuf_) {
+        for (size_t i = 0; i < produced; i++) {
+            storeOutput(stageBuf_[i].real(), outScale, &output[i * 2]);
+            storeOutput(stageBuf_[i].imag(), outScale, &output[i * 2 + 1]);
         }
     }
+    return produced;
+}
 
-    // Update state with last samples
-    int stateSize = std::min((int)stateI_.size(), numInputSamples);
-    for (int i = 0; i < stateSize; i++) {
-        stateI_[i] = input[(numInputSamples - stateSize + i) * 2];
-        stateQ_[i] = input[(numInputSamples - stateSize + i) * 2 + 1];
+template <typename T, typename OutT>
+std::vector<OutT> IQResamplerCPP::processVector(const std::vector<T>& input,
+                                                float inScale, float outScale) {
+    if (input.size() % 2 != 0) {
+        throw std::invalid_argument("Input size must be even (I/Q pairs)");
     }
 
+    size_t numInputSamples = input.size() / 2;
+    std::vector<OutT> output(outputSamplesFor(numInputSamples) * 2);
+    size_t produced = processInterleaved(input.data(), numInputSamples, inScale,
+                                         output.data(), outScale);
+    output.resize(produced * 2);
     return output;
 }
 
+std::vector<float> IQResamplerCPP::process(const std::vector<float>& input) {
+    return processVector<float, float>(input, 1.0f, 1.0f);
+}
+
+std::vector<float> IQResamplerCPP::process(const std::vector<int16_t>& input, float scale) {
+    return processVector<int16_t, float>(input, scale, 1.0f);
+}
+
+std::vector<float> IQResamplerCPP::process(const std::vector<int8_t>& input, float scale) {
+    return processVector<int8_t, float>(input, scale, 1.0f);
+}
+
+std::vector<int16_t> IQResamplerCPP::processSC16(const std::vector<float>& input, float outScale) {
+    return processVector<float, int16_t>(input, 1.0f, outScale);
+}
+
+std::vector<int16_t> IQResamplerCPP::processSC16(const std::vector<int16_t>& input,
+                                                 float inScale, float outScale) {
+    return processVector<int16_t, int16_t>(input, inScale, outScale);
+}
+
+std::vector<int16_t> IQResamplerCPP::processSC16(const std::vector<int8_t>& input,
+                                                 float inScale, float outScale) {
+    return processVector<int8_t, int16_t>(input, inScale, outScale);
+}
+
+size_t IQResamplerCPP::process(const std::complex<float>* input, size_t numInputSamples,
+                               std::complex<float>* output, size_t outputCapacity) {
+    if (numInputSamples > 0 && input == nullptr) {
+        throw std::invalid_argument("Input pointer is null");
+    }
+    if (outputSamplesFor(numInputSamples) > outputCapacity) {
+        telemetry_.recordOverrun();
+        throw std::length_error("Output buffer too small");
+    }
+
+    // std::complex<float> is layout-compatible with float[2], so the
+    // caller's buffers are used as interleaved IQ in place
+    return processInterleaved(reinterpret_cast<const float*>(input), numInputSamples, 1.0f,
+                              reinterpret_cast<float*>(output), 1.0f);
+}
+
+size_t IQResamplerCPP::process(IQSpan<const std::complex<float> > input,
+                               IQSpan<std::complex<float> > output) {
+    return process(input.data(), input.size(), output.data(), output.size());
+}
+
+size_t IQResamplerCPP::process(IQSpan<const float> input, IQSpan<float> output) {
+    if (input.size() % 2 != 0) {
+        throw std::invalid_argument("Input size must be even (I/Q pairs)");
+    }
+    return process(reinterpret_cast<const std::complex<float>*>(input.data()), input.size() / 2,
+                   reinterpret_cast<std::complex<float>*>(output.data()), output.size() / 2);
+}
+
+void IQResamplerCPP::reserve(size_t maxInputSamples, const IQMemoryPolicy& policy) {
+    if (maxInputSamples == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+    place(maxInputSamples, pullChunk_, policy);
+}
+
+void IQResamplerCPP::place(size_t maxInputSamples, size_t pullChunk, const IQMemoryPolicy& policy) {
+    typedef std::complex<float> cf;
+
+    // Direct form works on I/Q buffers of history + block; the FFT engine
+    // keeps its own history and needs complex staging per sample instead
+    const size_t workLen = fftEngine_ ? 0 : stateLen_ + maxInputSamples;
+    const size_t convertLen = fftEngine_ ? maxInputSamples : 0;
+    const size_t stageLen = fftEngine_ ? maxOutputSamplesFor(maxInputSamples) : 0;
+
+    // Everything is carved from a new block, and history and undelivered
+    // pull outputs copied over, before it replaces the old one: a failed
+    // reserve leaves the resampler usable at its old block size
+    IQArena next(2 * IQArena::bytesFor<float>(stateLen_) + 2 * IQArena::bytesFor<float>(workLen) +
+                 IQArena::bytesFor<cf>(convertLen) + IQArena::bytesFor<cf>(stageLen) +
+                 IQArena::bytesFor<cf>(pullChunk) + IQArena::bytesFor<cf>(pullPendingLen_), policy);
+    float* stateI = next.allocate<float>(stateLen_);
+    float* stateQ = next.allocate<float>(stateLen_);
+    float* workI = next.allocate<float>(workLen);
+    float* workQ = next.allocate<float>(workLen);
+    cf* convertBuf = next.allocate<cf>(convertLen);
+    cf* stageBuf = next.allocate<cf>(stageLen);
+    cf* pullInput = next.allocate<cf>(pullChunk);
+    cf* pullPending = next.allocate<cf>(pullPendingLen_);
+    if (stateI_) {
+        std::copy(stateI_, stateI_ + stateLen_, stateI);
+        std::copy(stateQ_, stateQ_ + stateLen_, stateQ);
+        std::copy(pullPending_, pullPending_ + pullPendingLen_, pullPending);
+    } else {
+        std::fill(stateI, stateI + stateLen_, 0.0f);
+        std::fill(stateQ, stateQ + stateLen_, 0.0f);
+    }
+    if (fftEngine_) {
+        fftEngine_->reserve(maxInputSamples, policy);
+    }
+
+    arena_ = std::move(next);
+    stateI_ = stateI;
+    stateQ_ = stateQ;
+    workI_ = fftEngine_ ? nullptr : workI;
+    workQ_ = fftEngine_ ? nullptr : workQ;
+    convertBuf_ = fftEngine_ ? convertBuf : nullptr;
+    stageBuf_ = fftEngine_ ? stageBuf : nullptr;
+    pullInput_ = pullInput;
+    pullChunk_ = pullChunk;
+    pullPending_ = pullPending;
+    maxBlock_ = maxInputSamples;
+}
+
+void IQResamplerCPP::setInputSource(InputSource source, size_t chunkSamples) {
+    if (!source) {
+        throw std::invalid_argument("Input source is empty");
+    }
+    if (chunkSamples == 0) {
+        throw std::invalid_argument("Chunk size must be positive");
+    }
+    place(maxBlock_, chunkSamples, arena_.policy());
+    inputSource_ = source;
+    pendingStart_ = 0;
+    pendingCount_ = 0;
+}
+
+void IQResamplerCPP::setInputSource(IQRingBuffer& ring, size_t chunkSamples) {
+    IQRingBuffer* source = &ring;
+    setInputSource([source](std::complex<float>* dst, size_t maxSamples) {
+        return source->read(dst, maxSamples);
+    }, chunkSamples);
+}
+
+size_t IQResamplerCPP::pull(std::complex<float>* output, size_t numOutputSamples) {
+    if (!inputSource_) {
+        throw std::logic_error("No input source registered");
+    }
+    if (numOutputSamples > 0 && output == nullptr) {
+        throw std::invalid_argument("Output pointer is null");
+    }
+
+    // Outputs left over from the previous request come first
+    size_t produced = std::min(pendingCount_, numOutputSamples);
+    std::copy(pullPending_ + pendingStart_, pullPending_ + pendingStart_ + produced, output);
+    pendingStart_ += produced;
+    pendingCount_ -= produced;
+
+    while (produced < numOutputSamples) {
+        size_t remaining = numOutputSamples - produced;
+        size_t request = std::min(inputSamplesNeededFor(remaining), pullChunk_);
+        size_t got = std::min(inputSource_(pullInput_, request), request);
+        if (got == 0) {
+            telemetry_.recordUnderrun();
+            break;
+        }
+
+        size_t count = outputSamplesFor(got);
+        if (count <= remaining) {
+            produced += process(pullInput_, got, output + produced, remaining);
+            continue;
+        }
+
+        // The last sample completes more outputs than were asked for: run
+        // the samples before it straight into output, then keep the
+        // overflow of the last one for the next request
+        produced += process(pullInput_, got - 1, output + produced, remaining);
+        size_t last = process(pullInput_ + got - 1, 1, pullPending_, pullPendingLen_);
+        size_t used = numOutputSamples - produced;
+        std::copy(pullPending_, pullPending_ + used, output + produced);
+        produced += used;
+        pendingStart_ = used;
+        pendingCount_ = last - used;
+    }
+    return produced;
+}
+
+size_t IQResamplerCPP::pull(IQSpan<std::complex<float> > output) {
+    return pull(output.data(), output.size());
+}
+
+size_t IQResamplerCPP::flushPadding() const {
+    // Zero padding that pushes the last input sample through the delay
+    return (size_t)std::ceil(groupDelay_ - 1e-6);
+}
+
+size_t IQResamplerCPP::outputSamplesForFlush() const {
+    return pendingCount_ + outputSamplesFor(flushPadding());
+}
+
+size_t IQResamplerCPP::flush(std::complex<float>* output, size_t outputCapacity) {
+    if (outputSamplesForFlush() > outputCapacity) {
+        throw std::length_error("Output buffer too small");
+    }
+
+    // Outputs an earlier pull() produced but did not hand out come first
+    size_t produced = pendingCount_;
+    std::copy(pullPending_ + pendingStart_, pullPending_ + pendingStart_ + produced, output);
+
+    size_t padding = flushPadding();
+    while (padding > 0) {
+        size_t n = std::min(padding, (size_t)FLUSH_BLOCK_SAMPLES);
+        produced += process(FLUSH_ZEROS, n, output + produced, outputCapacity - produced);
+        padding -= n;
+    }
+
+    reset();
+    return produced;
+}
+
+size_t IQResamplerCPP::flush(IQSpan<std::complex<float> > output) {
+    return flush(output.data(), output.size());
+}
+
+std::vector<float> IQResamplerCPP::flush() {
+    std::vector<float> output(outputSamplesForFlush() * 2);
+    size_t produced = flush(reinterpret_cast<std::complex<float>*>(output.data()), output.size() / 2);
+    output.resize(produced * 2);
+    return output;
+}
+
+void IQResamplerCPP::prime(const std::complex<float>* history, size_t count) {
+    if (count > 0 && history == nullptr) {
+        throw std::invalid_argument("History pointer is null");
+    }
+    reset();
+    if (fftEngine_) {
+        fftEngine_->prime(history, count);
+        return;
+    }
+
+    // Newest sample goes last, where the next block's history ends
+    size_t n = std::min(count, stateLen_);
+    size_t offset = stateLen_ - n;
+    for (size_t i = 0; i < n; i++) {
+        stateI_[offset + i] = history[count - n + i].real();
+        stateQ_[offset + i] = history[count - n + i].imag();
+    }
+}
+
+void IQResamplerCPP::prime(IQSpan<const std::complex<float> > history) {
+    prime(history.data(), history.size());
+}
+
+size_t IQResamplerCPP::outputSamplesForBursts(const IQBurst* bursts, size_t numBursts,
+                                              bool flushEach) const {
+    // Every burst starts from phase 0; flushing is the same as processing
+    // the zero padding along with the burst
+    size_t padding = flushEach ? flushPadding() : 0;
+    size_t total = 0;
+    for (size_t b = 0; b < numBursts; b++) {
+        total += outputSamplesAt(0, 0, bursts[b].numSamples + padding);
+    }
+    return total;
+}
+
+size_t IQResamplerCPP::processBursts(const IQBurst* bursts, size_t numBursts,
+                                     std::complex<float>* output, size_t outputCapacity,
+                                     IQBurstOutput* results, bool flushEach) {
+    if (numBursts > 0 && (bursts == nullptr || results == nullptr)) {
+        throw std::invalid_argument("Burst list is null");
+    }
+    // Every burst is checked before any output or state is touched
+    for (size_t b = 0; b < numBursts; b++) {
+        if (bursts[b].numSamples > 0 && bursts[b].samples == nullptr) {
+            throw std::invalid_argument("Input pointer is null");
+        }
+        if (bursts[b].historySamples > 0 && bursts[b].history == nullptr) {
+            throw std::invalid_argument("History pointer is null");
+        }
+    }
+    if (outputSamplesForBursts(bursts, numBursts, flushEach) > outputCapacity) {
+        throw std::length_error("Output buffer too small");
+    }
+
+    const IQTelemetry::Ticks start = IQTelemetry::now();
+    const size_t padding = flushEach ? flushPadding() : 0;
+    const bool direct = (mode_ != Mode::Linear && !fftEngine_);
+
+    size_t produced = 0;
+    size_t batchedInput = 0;
+    size_t batchedOutput = 0;
+    bool lastBatched = false;
+    int idx = 0;
+    int phase = 0;
+    for (size_t b = 0; b < numBursts; b++) {
+        const IQBurst& burst = bursts[b];
+        results[b].offset = produced;
+        results[b].timestamp = burst.timestamp;
+
+        const size_t n = burst.numSamples + padding;
+        lastBatched = direct && n <= maxBlock_;
+        if (!lastBatched) {
+            // Linear, the FFT engine and bursts longer than the scratch go
+            // through the stream calls
+            prime(burst.history, burst.historySamples);
+            produced += process(burst.samples, burst.numSamples, output + produced, outputCapacity - produced);
+            if (flushEach) {
+                produced += flush(output + produced, outputCapacity - produced);
+            }
+            results[b].numSamples = produced - results[b].offset;
+            continue;
+        }
+
+        // Swap in the burst's history (zero-extended) where the saved state
+        // would go, then the burst and its flush padding, in one block
+        const size_t h = std::min(burst.historySamples, stateLen_);
+        const std::complex<float>* history = burst.history + (burst.historySamples - h);
+        std::fill(workI_, workI_ + stateLen_ - h, 0.0f);
+        std::fill(workQ_, workQ_ + stateLen_ - h, 0.0f);
+        float* dstI = workI_ + stateLen_ - h;
+        float* dstQ = workQ_ + stateLen_ - h;
+        for (size_t i = 0; i < h; i++) {
+            dstI[i] = history[i].real();
+            dstQ[i] = history[i].imag();
+        }
+        dstI = workI_ + stateLen_;
+        dstQ = workQ_ + stateLen_;
+        for (size_t i = 0; i < burst.numSamples; i++) {
+            dstI[i] = burst.samples[i].real();
+            dstQ[i] = burst.samples[i].imag();
+        }
+        std::fill(dstI + burst.numSamples, dstI + n, 0.0f);
+        std::fill(dstQ + burst.numSamples, dstQ + n, 0.0f);
+
+        idx = 0;
+        phase = 0;
+        size_t count = filterBlock(workI_, workQ_, (int)n, idx, phase,
+                                   reinterpret_cast<float*>(output + produced), 1.0f);
+        produced += count;
+        results[b].numSamples = count;
+        batchedInput += n;
+        batchedOutput += count;
+    }
+
+    if (lastBatched) {
+        // Leave the stream as prime() + process() (+ flush()) of the last
+        // burst would have
+        reset();
+        if (!flushEach) {
+            const IQBurst& last = bursts[numBursts - 1];
+            std::copy(workI_ + last.numSamples, workI_ + last.numSamples + stateLen_, stateI_);
+            std::copy(workQ_ + last.numSamples, workQ_ + last.numSamples + stateLen_, stateQ_);
+            nextIndex_ = idx - (int)last.numSamples;
+            phase_ = phase;
+            inputPos_ = last.numSamples;
+            outputPos_ = results[numBursts - 1].numSamples;
+        }
+    }
+    if (batchedInput > 0) {
+        telemetry_.record(start, batchedInput, batchedOutput);
+    }
+    return produced;
+}
+
+void IQResamplerCPP::reserveTags(size_t maxTags) {
+    pendingTags_.reserve(maxTags);
+    readyTags_.reserve(maxTags);
+    tagCapacity_ = std::max(tagCapacity_, maxTags);
+}
+
+void IQResamplerCPP::addTag(uint64_t inputIndex, int64_t payload) {
+    if (tagHead_ < pendingTags_.size() && inputIndex < pendingTags_.back().index) {
+        throw std::invalid_argument("Tags must be added in input order");
+    }
+    if (pendingTags_.size() - tagHead_ + readyTags_.size() >= tagCapacity_) {
+        throw std::length_error("Tag buffer full");
+    }
+
+    // Reuse the pending buffer from the front once it has drained
+    if (tagHead_ == pendingTags_.size()) {
+        pendingTags_.clear();
+        tagHead_ = 0;
+    } else if (pendingTags_.size() == tagCapacity_) {
+        pendingTags_.erase(pendingTags_.begin(), pendingTags_.begin() + tagHead_);
+        tagHead_ = 0;
+    }
+
+    IQTag tag;
+    tag.index = inputIndex;
+    tag.payload = payload;
+    pendingTags_.push_back(tag);
+
+    // A tag on an input sample whose output is already out is ready now
+    releaseTags();
+}
+
+double IQResamplerCPP::tagPosition(uint64_t index) const {
+    // Input sample i is shown by output (i + delay) * L / M; the integer
+    // part of i * L / M is exact, so long streams keep full precision
+    uint64_t scaled = index * (uint64_t)upFactor_;
+    uint64_t whole = scaled / downFactor_;
+    double fraction = ((double)(scaled % downFactor_) + groupDelay_ * upFactor_) / downFactor_;
+    return (double)whole + fraction;
+}
+
+void IQResamplerCPP::releaseTags() {
+    while (tagHead_ < pendingTags_.size()) {
+        const IQTag& tag = pendingTags_[tagHead_];
+        double position = tagPosition(tag.index);
+        if (std::floor(position) >= (double)outputPos_) {
+            break;
+        }
+        IQOutputTag ready;
+        ready.position = position;
+        ready.inputIndex = tag.index;
+        ready.payload = tag.payload;
+        readyTags_.push_back(ready);
+        tagHead_++;
+    }
+}
+
+size_t IQResamplerCPP::takeTags(IQOutputTag* tags, size_t maxTags) {
+    size_t n = std::min(maxTags, readyTags_.size());
+    std::copy(readyTags_.begin(), readyTags_.begin() + n, tags);
+    readyTags_.erase(readyTags_.begin(), readyTags_.begin() + n);
+    return n;
+}
+
 void IQResamplerCPP::reset() {
-    std::fill(stateI_.begin(), stateI_.end(), 0.0f);
-    std::fill(stateQ_.begin(), stateQ_.end(), 0.0f);
+    std::fill(stateI_, stateI_ + stateLen_, 0.0f);
+    std::fill(stateQ_, stateQ_ + stateLen_, 0.0f);
     inputPos_ = 0;
+    outputPos_ = 0;
+    pendingTags_.clear();
+    tagHead_ = 0;
+    phase_ = 0;
+    nextIndex_ = 0;
+    pendingStart_ = 0;
+    pendingCount_ = 0;
+    if (fftEngine_) {
+        fftEngine_->reset();
+    }
 }
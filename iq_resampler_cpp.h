@@ -3,14 +3,89 @@
 
 #include <vector>
 #include <cmath>
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <stdexcept>
 
+#include "iq_arena.h"
+#include "iq_span.h"
+#include "iq_filter_design.h"
+#include "iq_ring_buffer.h"
+#include "iq_resampler_fft.h"
+#include "iq_telemetry.h"
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// One burst of a gated/packetized signal for IQResamplerCPP::processBursts()
+struct IQBurst {
+    const std::complex<float>* samples;
+    size_t numSamples;
+    int64_t timestamp;  // Caller's time of samples[0], passed through
+
+    // Optional samples just before the burst (e.g. the guard interval),
+    // used to prime the filter history instead of zeros
+    const std::complex<float>* history;
+    size_t historySamples;
+
+    IQBurst(const std::complex<float>* data = nullptr, size_t count = 0, int64_t time = 0)
+        : samples(data), numSamples(count), timestamp(time), history(nullptr), historySamples(0) {}
+};
+
+// Where a burst's outputs landed in the processBursts() output buffer.
+// Output offset is aligned with samples[0] of the burst, delayed by
+// groupDelay() input samples.
+struct IQBurstOutput {
+    size_t offset;
+    size_t numSamples;
+    int64_t timestamp;
+};
+
+// Caller data attached to one input sample (e.g. a hardware timestamp).
+// index counts input samples since the stream started (reset() or prime()).
+struct IQTag {
+    uint64_t index;
+    int64_t payload;
+};
+
+// A tag as it comes out of the resampler: position is the fractional
+// output sample index (since the stream started) that shows the tagged
+// input sample, including the filter's group delay
+struct IQOutputTag {
+    double position;
+    uint64_t inputIndex;
+    int64_t payload;
+};
+
 // Pure C++ Implementation
 class IQResamplerCPP {
+public:
+    // Resampling algorithm
+    //   Linear:          linear interpolation between input samples (fastest)
+    //   Polyphase:       polyphase FIR using the windowed-sinc prototype filter;
+    //                    direct form, or overlap-save FFT once each branch has
+    //                    at least FFT_CROSSOVER_BRANCH_TAPS taps
+    //   PolyphaseDirect: polyphase FIR, always direct form
+    //   PolyphaseFFT:    polyphase FIR, always overlap-save FFT (IQResamplerFFT)
+    //   LowLatency:      polyphase FIR, direct form, with a minimum-phase
+    //                    version of the prototype (same magnitude response,
+    //                    a fraction of the group delay)
+    enum class Mode { Linear, Polyphase, PolyphaseDirect, PolyphaseFFT, LowLatency };
+
+    // Taps per polyphase branch at which Mode::Polyphase switches to the
+    // FFT engine (measured with BM_CPP_LongFilter_*)
+    static const int FFT_CROSSOVER_BRANCH_TAPS = 192;
+
+    // Block size the scratch arena is sized for until reserve() is called
+    static const size_t DEFAULT_MAX_BLOCK_SAMPLES = 8192;
+
+    // Pull-mode input: write up to maxSamples IQ samples to dst and return
+    // how many were written (0 when no input is available)
+    typedef std::function<size_t(std::complex<float>* dst, size_t maxSamples)> InputSource;
+
 private:
     int inputRate_;
     int outputRate_;
@@ -18,27 +93,290 @@ private:
     int downFactor_;
     std::vector<float> filter_;
     int filterLen_;
+    Mode mode_;
+
+    // Polyphase filter bank: upFactor_ branches of branchLen_ taps each,
+    // stored time-reversed so each output is a contiguous dot product
+    std::vector<float> bank_;
+    int branchLen_;
+    bool symmetricBank_;  // Single symmetric branch: mirrored taps can be folded
+    bool foldSymmetric_;
+    std::vector<float> foldBank_;  // First half of that branch, zero-padded to 8n taps
+
+    // Frequency-domain engine for long filters (null when direct form is used)
+    std::unique_ptr<IQResamplerFFT> fftEngine_;
+
+    // Streaming history (the last stateLen_ input samples), carved from
+    // the arena with the scratch below
+    float* stateI_;
+    float* stateQ_;
+    size_t stateLen_;
+
+    // Scratch for one block of at most maxBlock_ samples, carved from the
+    // arena: I/Q working buffers (history + block), and complex staging
+    // for integer formats going through the FFT engine. Longer blocks are
+    // processed in pieces, so process() never allocates.
+    IQArena arena_;
+    size_t maxBlock_;
+    float* workI_;
+    float* workQ_;
+    std::complex<float>* convertBuf_;
+    std::complex<float>* stageBuf_;
+    uint64_t inputPos_;   // Input samples since the stream started
+    uint64_t outputPos_;  // Output samples since the stream started
+    int phase_;      // Polyphase branch (Linear: fraction x L) of the next output
+    int nextIndex_;  // Input index (in the next block) of the next output
+    double groupDelay_;
+
+    // Tags waiting for their output (in index order, from tagHead_) and
+    // tags ready to take; capacity is reserved up front
+    std::vector<IQTag> pendingTags_;
+    size_t tagHead_;
+    std::vector<IQOutputTag> readyTags_;
+    size_t tagCapacity_;
 
-    // State for streaming
-    std::vector<float> stateI_;
-    std::vector<float> stateQ_;
-    int inputPos_;
+    // Pull mode, buffers carved from the arena
+    InputSource inputSource_;
+    std::complex<float>* pullInput_;    // One chunk of pulled input
+    size_t pullChunk_;
+    std::complex<float>* pullPending_;  // Outputs produced beyond a request
+    size_t pullPendingLen_;             // ceil(L / M): the most one input sample yields
+    size_t pendingStart_;
+    size_t pendingCount_;
 
-    // Generate low-pass filter for anti-aliasing
-    void generateFilter(int numTaps, float cutoffFreq);
+    IQTelemetry telemetry_;
 
-    // GCD for simplifying ratio
-    int gcd(int a, int b);
+    // Fractional output index showing input sample index
+    double tagPosition(uint64_t index) const;
+
+    // Move pending tags the output has reached to the ready list
+    void releaseTags();
+
+    // Outputs for numInputSamples starting from the given phase state
+    size_t outputSamplesAt(int nextIndex, int phase, size_t numInputSamples) const;
+
+    // Zero padding flush() feeds through the filter
+    size_t flushPadding() const;
 
     // Interpolate using sinc filter
     float interpolate(const std::vector<float>& signal, float position);
 
+    // Split the prototype filter into the polyphase bank
+    void buildPolyphaseBank();
+
+    // Set up the bank, FFT engine and state buffers for filter_
+    void init();
+
+    // Carve history, scratch and pull buffers (chunk of pullChunk samples)
+    // from a new arena placed by policy, keeping state and pending outputs
+    void place(size_t maxInputSamples, size_t pullChunk, const IQMemoryPolicy& policy);
+
+    // Split interleaved IQ into I/Q working buffers (after the saved state),
+    // converting and scaling integer samples on the way in
+    template <typename T>
+    void loadInput(const T* input, int numInputSamples, float scale, float* inI, float* inQ);
+
+    // Resample interleaved IQ into interleaved output (room for
+    // outputSamplesFor() pairs), returning the number of IQ samples written;
+    // advances the stream positions and releases tags the output covers
+    template <typename T, typename OutT>
+    size_t processInterleaved(const T* input, size_t numInputSamples, float inScale,
+                              OutT* output, float outScale);
+
+    // The filtering itself, direct form
+    template <typename T, typename OutT>
+    size_t resampleBlock(const T* input, size_t numInputSamples, float inScale,
+                         OutT* output, float outScale);
+
+    // Polyphase kernel over split I/Q (history first), from input index
+    // idx at branch phase; leaves both at the first output past the block
+    template <typename OutT>
+    size_t filterBlock(const float* inI, const float* inQ, int numInputSamples,
+                       int& idx, int& phase, OutT* output, float outScale) const;
+
+    // Same, through the FFT engine
+    template <typename T, typename OutT>
+    size_t processFFT(const T* input, size_t numInputSamples, float inScale,
+                      OutT* output, float outScale);
+
+    template <typename T, typename OutT>
+    std::vector<OutT> processVector(const std::vector<T>& input, float inScale, float outScale);
+
 public:
-    IQResamplerCPP(int inputRate, int outputRate, int filterTaps = 127);
+    // Windowed-sinc prototype of filterTaps taps in all, not per branch
+    // (ignored by Mode::Linear); std::invalid_argument below
+    // IQFilterDesign::minimumTaps(inputRate, outputRate), e.g. 1280 for
+    // 48 kHz -> 44.1 kHz, where the default 127 leaves branches empty
+    IQResamplerCPP(int inputRate, int outputRate, int filterTaps = 127, Mode mode = Mode::Linear);
+
+    // Polyphase resampler with the shortest Kaiser prototype that meets spec
+    // for this ratio (see IQFilterDesign)
+    IQResamplerCPP(int inputRate, int outputRate, const IQFilterSpec& spec,
+                   Mode mode = Mode::Polyphase);
+
+    // A copy has the same filter, stream state, tags and input source, in
+    // its own arena placed with the source's memory policy; its telemetry
+    // starts from zero
+    IQResamplerCPP(const IQResamplerCPP& other);
+    IQResamplerCPP& operator=(const IQResamplerCPP& other);
+    IQResamplerCPP(IQResamplerCPP&& other) = default;
+    IQResamplerCPP& operator=(IQResamplerCPP&& other) = default;
 
     // Process IQ data using direct resampling
     std::vector<float> process(const std::vector<float>& input);
 
+    // Process interleaved SC16 / SC8 IQ data; samples are multiplied by
+    // scale while they are loaded, so no float copy of the input is made
+    std::vector<float> process(const std::vector<int16_t>& input, float scale = 1.0f / 32768.0f);
+    std::vector<float> process(const std::vector<int8_t>& input, float scale = 1.0f / 128.0f);
+
+    // Same as process(), but output is SC16: samples are multiplied by
+    // outScale, rounded and saturated to [-32768, 32767]. Every overload
+    // defaults to the same full scale as the SC16 input: 1.0 <-> 32768
+    // (so +1.0 saturates to 32767), and SC16 in gives SC16 out at unity gain
+    std::vector<int16_t> processSC16(const std::vector<float>& input, float outScale = 32768.0f);
+    std::vector<int16_t> processSC16(const std::vector<int16_t>& input,
+                                     float inScale = 1.0f / 32768.0f, float outScale = 32768.0f);
+    std::vector<int16_t> processSC16(const std::vector<int8_t>& input,
+                                     float inScale = 1.0f / 128.0f, float outScale = 32768.0f);
+
+    // Process IQ data in caller-owned buffers without copying; output must
+    // hold every sample this call produces (std::length_error otherwise).
+    // Returns the number of IQ samples written.
+    size_t process(const std::complex<float>* input, size_t numInputSamples,
+                   std::complex<float>* output, size_t outputCapacity);
+    size_t process(IQSpan<const std::complex<float> > input, IQSpan<std::complex<float> > output);
+
+    // Same, for interleaved float I/Q spans (sizes count floats)
+    size_t process(IQSpan<const float> input, IQSpan<float> output);
+
+    // Size the scratch arena for blocks of up to maxInputSamples
+    // (DEFAULT_MAX_BLOCK_SAMPLES from the constructor); longer blocks are
+    // split into pieces of that size with identical output. policy puts
+    // the arena on huge pages and/or a NUMA node (LOCAL_NODE: the node of
+    // the thread calling reserve(), so call it from the stream's thread);
+    // the arena also holds the streaming history and pull-mode buffers,
+    // and the FFT engine's spectra, scratch and history get the same
+    // placement.
+    // After this, process(), pull(), flush(), prime() and processBursts()
+    // do not allocate (the std::vector overloads still allocate the
+    // vector they return).
+    void reserve(size_t maxInputSamples, const IQMemoryPolicy& policy = IQMemoryPolicy());
+    size_t maxBlockSamples() const { return maxBlock_; }
+    const IQArena& arena() const { return arena_; }
+
+    // Pull mode: register where input comes from, then ask for an exact
+    // number of outputs with pull(). Input is read in chunks of at most
+    // chunkSamples, never more than the requested outputs need; the chunk
+    // buffer is carved here (with the placement of the last reserve()), so
+    // pull() itself does not allocate. A ring
+    // buffer must outlive the resampler (or a later setInputSource call).
+    void setInputSource(InputSource source, size_t chunkSamples = 512);
+    void setInputSource(IQRingBuffer& ring, size_t chunkSamples = 512);
+
+    // Fill output with numOutputSamples IQ samples, drawing input from the
+    // registered source as needed. Returns fewer only if the source runs
+    // dry (returns 0); the next pull() continues where this one stopped.
+    size_t pull(std::complex<float>* output, size_t numOutputSamples);
+    size_t pull(IQSpan<std::complex<float> > output);
+
+    // End of stream: emit the outputs still held back by the filter delay
+    // (pending pull() outputs first, then ceil(groupDelay()) input samples
+    // of zero padding), then reset for the next stream. Output must hold
+    // outputSamplesForFlush() samples (std::length_error otherwise).
+    // Does not allocate; returns the number of IQ samples written.
+    size_t flush(std::complex<float>* output, size_t outputCapacity);
+    size_t flush(IQSpan<std::complex<float> > output);
+    std::vector<float> flush();
+    size_t outputSamplesForFlush() const;
+
+    // Start of stream: reset, then load the last count samples of history
+    // into the filter state as if they had already been processed, so the
+    // first outputs have no startup transient (missing older history stays
+    // zero). Does not allocate.
+    void prime(const std::complex<float>* history, size_t count);
+    void prime(IQSpan<const std::complex<float> > history);
+
+    // Resample a batch of independent bursts back-to-back into one output
+    // buffer: each burst starts from prime() with its history (zeros when
+    // none) and, with flushEach, ends with flush() so its tail is kept.
+    // In direct form the bank and bounds are set up once and each burst is
+    // one kernel pass over history + burst + padding, swapping only the
+    // history between bursts (no per-burst reset, flush blocks or
+    // telemetry); Linear, the FFT engine and bursts longer than the
+    // reserved block go burst by burst through prime()/process()/flush().
+    // Afterwards the stream is as those calls on the last burst leave it.
+    // results receives one entry per burst. Output must hold
+    // outputSamplesForBursts() samples (std::length_error otherwise); a
+    // burst with null samples or history for a non-zero count throws
+    // std::invalid_argument. Both are checked before anything is written.
+    // Does not allocate; returns the total number of IQ samples written.
+    size_t processBursts(const IQBurst* bursts, size_t numBursts,
+                         std::complex<float>* output, size_t outputCapacity,
+                         IQBurstOutput* results, bool flushEach = true);
+    size_t outputSamplesForBursts(const IQBurst* bursts, size_t numBursts,
+                                  bool flushEach = true) const;
+
+    // Sample tags: attach payloads to input samples (index relative to the
+    // stream start; inputPosition() is the index of the next sample given
+    // to process()) in non-decreasing index order. Once process() has
+    // produced the output sample at floor(position), the tag can be
+    // taken with takeTags(). Tags live in buffers sized by reserveTags()
+    // (64 by default); addTag() throws std::length_error when they are
+    // full. Untagged blocks pay only a position update per call. reset()
+    // and prime() drop tags whose outputs were never produced.
+    void addTag(uint64_t inputIndex, int64_t payload);
+    size_t takeTags(IQOutputTag* tags, size_t maxTags);
+    size_t readyTags() const { return readyTags_.size(); }
+    void reserveTags(size_t maxTags);
+    uint64_t inputPosition() const { return inputPos_; }
+    uint64_t outputPosition() const { return outputPos_; }
+
+    // Exact number of IQ samples the next process() call will return for
+    // numInputSamples of input, given the current phase state
+    size_t outputSamplesFor(size_t numInputSamples) const;
+
+    // Most IQ samples any process() call can return for numInputSamples,
+    // whatever the phase state: the size for a buffer reused every block
+    size_t maxOutputSamplesFor(size_t numInputSamples) const;
+
+    // Fewest input samples the next process() call needs to return at
+    // least numOutputSamples
+    size_t inputSamplesNeededFor(size_t numOutputSamples) const;
+
+    int inputRate() const { return inputRate_; }
+    int outputRate() const { return outputRate_; }
+
+    // Algorithmic delay in input samples: group delay of the prototype at
+    // DC (0 for Linear). Every output is emitted by the process() call that
+    // delivers the last input sample it depends on, so this is the whole
+    // latency added on top of block buffering.
+    double groupDelay() const { return groupDelay_; }
+
+    // True when long filters are running through the FFT engine
+    bool usesFFT() const { return fftEngine_ != nullptr; }
+
+    // Symmetric single-branch banks (decimation-only ratios) pre-add
+    // mirrored samples and do half the multiplies. On by default; the
+    // switch exists to benchmark the generic kernel on the same filter.
+    bool usesSymmetricFolding() const { return symmetricBank_ && foldSymmetric_ && !fftEngine_; }
+    void setSymmetricFolding(bool enabled) { foldSymmetric_ = enabled; }
+
+    // Prototype filter (at upFactor x the input rate) and its polyphase split
+    const std::vector<float>& filterCoefficients() const { return filter_; }
+    int branchTaps() const { return (filterLen_ + upFactor_ - 1) / upFactor_; }
+
+    // Runtime statistics: every block through the filter (process(), and
+    // the blocks pull() and flush() run) is timed and counted; pull()
+    // running dry counts an underrun, an output buffer too small for
+    // process() an overrun. Not cleared by reset(). Read snapshot() from
+    // any thread; compiled out with IQ_NO_TELEMETRY.
+    const IQTelemetry& telemetry() const { return telemetry_; }
+    IQTelemetry& telemetry() { return telemetry_; }
+
+    // Achieved response of the prototype, measured against spec
+    IQFilterResponse filterResponse(const IQFilterSpec& spec = IQFilterSpec()) const;
+
     void reset();
 };
 
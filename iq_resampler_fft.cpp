@@ -0,0 +1,353 @@
+#include "iq_resampler_fft.h"
+#include "iq_filter_design.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+typedef std::complex<float> cf;
+
+inline cf cmul(cf a, cf b) {
+    return cf(a.real() * b.real() - a.imag() * b.imag(),
+              a.real() * b.imag() + a.imag() * b.real());
+}
+
+} // namespace
+
+const size_t IQResamplerFFT::DEFAULT_MAX_BLOCK_SAMPLES;
+
+int IQResamplerFFT::chooseFFTSize(int branchLen) {
+    // Frames of ~4x the branch length keep ~75% of each FFT as new samples
+    int size = 64;
+    while (size < 4 * branchLen) {
+        size *= 2;
+    }
+    return size;
+}
+
+int IQResamplerFFT::chooseFoldFactor(int upFactor, int downFactor, int fftSize) {
+    // Largest power of two dividing M, limited so the per-offset branch
+    // spectra (L x fold x N) stay within a few MB
+    int fold = std::min(downFactor & -downFactor, fftSize);
+    while (fold > 1 && (long long)upFactor * fold * fftSize > (1LL << 20)) {
+        fold /= 2;
+    }
+    return fold;
+}
+
+IQResamplerFFT::IQResamplerFFT(int inputRate, int outputRate, int filterTaps)
+    : inputRate_(inputRate), outputRate_(outputRate),
+      upFactor_(outputRate / IQFilterDesign::gcd(inputRate, outputRate)),
+      downFactor_(inputRate / IQFilterDesign::gcd(inputRate, outputRate)),
+      filterLen_(filterTaps),
+      branchLen_((filterTaps + upFactor_ - 1) / upFactor_),
+      fftSize_(chooseFFTSize(branchLen_)),
+      blockLen_(fftSize_ - branchLen_ + 1),
+      foldFactor_(chooseFoldFactor(upFactor_, downFactor_, fftSize_)),
+      fft_(fftSize_),
+      foldedFft_(fftSize_ / foldFactor_),
+      maxBlock_(0), branchSpectra_(nullptr), bank_(nullptr), directMaxOutputs_(0),
+      frame_(nullptr), branchOut_(nullptr),
+      state_(nullptr), work_(nullptr), phase_(0), nextIndex_(0) {
+    IQFilterDesign::checkTaps(inputRate, outputRate, filterTaps);
+
+    // Generate anti-aliasing filter
+    std::vector<double> prototype = IQFilterDesign::hamming(upFactor_, downFactor_, filterLen_);
+    filter_.assign(prototype.begin(), prototype.end());
+
+    init();
+}
+
+IQResamplerFFT::IQResamplerFFT(int inputRate, int outputRate, const std::vector<float>& prototype)
+    : inputRate_(inputRate), outputRate_(outputRate),
+      upFactor_(outputRate / IQFilterDesign::gcd(inputRate, outputRate)),
+      downFactor_(inputRate / IQFilterDesign::gcd(inputRate, outputRate)),
+      filter_(prototype),
+      filterLen_((int)prototype.size()),
+      branchLen_((filterLen_ + upFactor_ - 1) / upFactor_),
+      fftSize_(chooseFFTSize(branchLen_)),
+      blockLen_(fftSize_ - branchLen_ + 1),
+      foldFactor_(chooseFoldFactor(upFactor_, downFactor_, fftSize_)),
+      fft_(fftSize_),
+      foldedFft_(fftSize_ / foldFactor_),
+      maxBlock_(0), branchSpectra_(nullptr), bank_(nullptr), directMaxOutputs_(0),
+      frame_(nullptr), branchOut_(nullptr),
+      state_(nullptr), work_(nullptr), phase_(0), nextIndex_(0) {
+
+    init();
+}
+
+IQResamplerFFT::IQResamplerFFT(const IQResamplerFFT& other)
+    : inputRate_(other.inputRate_), outputRate_(other.outputRate_),
+      upFactor_(other.upFactor_), downFactor_(other.downFactor_),
+      filter_(other.filter_), filterLen_(other.filterLen_), branchLen_(other.branchLen_),
+      fftSize_(other.fftSize_), blockLen_(other.blockLen_), foldFactor_(other.foldFactor_),
+      fft_(other.fft_), foldedFft_(other.foldedFft_),
+      maxBlock_(0), branchSpectra_(other.branchSpectra_), bank_(other.bank_),
+      directMaxOutputs_(other.directMaxOutputs_), frame_(nullptr), branchOut_(nullptr),
+      branchFirst_(other.branchFirst_), branchShift_(other.branchShift_),
+      state_(other.state_), work_(nullptr), phase_(other.phase_), nextIndex_(other.nextIndex_) {
+
+    // Spectra, bank and history are read from other's arena while
+    // reserve() carves them from this one's
+    reserve(other.maxBlock_, other.arena_.policy());
+}
+
+IQResamplerFFT& IQResamplerFFT::operator=(const IQResamplerFFT& other) {
+    if (this != &other) {
+        *this = IQResamplerFFT(other);
+    }
+    return *this;
+}
+
+void IQResamplerFFT::init() {
+    if (filterLen_ < 1) {
+        throw std::invalid_argument("Filter must have at least one tap");
+    }
+
+    // Spectra, scratch and zeroed history, in ordinary memory until the
+    // owner calls reserve() with a policy
+    branchFirst_.resize(upFactor_);
+    branchShift_.resize(upFactor_);
+    reserve(DEFAULT_MAX_BLOCK_SAMPLES);
+
+    // Branch p holds taps p, p + L, p + 2L, ... scaled by L. Store its
+    // spectrum once per output offset modulo the fold factor (the offset
+    // becomes a phase ramp), with the 1/N of the inverse FFT folded in,
+    // and the taps themselves reversed for the direct form.
+    std::vector<cf> taps(fftSize_);
+    for (int p = 0; p < upFactor_; p++) {
+        std::fill(taps.begin(), taps.end(), cf(0.0f, 0.0f));
+        float* reversed = &bank_[(size_t)p * branchLen_];
+        for (int k = 0; k < branchLen_; k++) {
+            int idx = p + k * upFactor_;
+            float tap = idx < filterLen_ ? filter_[idx] * upFactor_ : 0.0f;
+            taps[k] = cf(tap / fftSize_, 0.0f);
+            reversed[branchLen_ - 1 - k] = tap;
+        }
+        fft_.forward(taps.data());
+
+        for (int shift = 0; shift < foldFactor_; shift++) {
+            cf* spectrum = &branchSpectra_[((size_t)p * foldFactor_ + shift) * fftSize_];
+            for (int k = 0; k < fftSize_; k++) {
+                double theta = 2.0 * M_PI * (double)k * shift / fftSize_;
+                spectrum[k] = cmul(taps[k], cf((float)std::cos(theta), (float)std::sin(theta)));
+            }
+        }
+    }
+
+    // A frame costs a forward transform plus an inverse one per branch it
+    // uses, ~N log2 N operations each; the direct form costs branchLen_
+    // per output. Blocks that do not fill a frame (pull() chunks, the
+    // single-sample overflow step) take the cheaper of the two.
+    const long long frameOutputs = ((long long)blockLen_ * upFactor_ + downFactor_ - 1) / downFactor_;
+    const double transforms = 1.0 + (double)std::min((long long)upFactor_, frameOutputs);
+    directMaxOutputs_ = (size_t)(transforms * fftSize_ * std::log2((double)fftSize_) / branchLen_);
+}
+
+size_t IQResamplerFFT::outputSamplesFor(size_t numInputSamples) const {
+    // Outputs land on input indices nextIndex_, nextIndex_ + M/L, ...
+    long long span = (long long)numInputSamples - nextIndex_;
+    if (span <= 0) {
+        return 0;
+    }
+    long long upsampled = span * upFactor_ - phase_;
+    return (size_t)((upsampled + downFactor_ - 1) / downFactor_);
+}
+
+size_t IQResamplerFFT::inputSamplesNeededFor(size_t numOutputSamples) const {
+    if (numOutputSamples == 0) {
+        return 0;
+    }
+    // The last requested output lands on input index floor(m / L)
+    long long m = (long long)nextIndex_ * upFactor_ + phase_ + (long long)(numOutputSamples - 1) * downFactor_;
+    return (size_t)(m / upFactor_ + 1);
+}
+
+cf IQResamplerFFT::directOutput(const cf* window, int phase) const {
+    const float* taps = &bank_[(size_t)phase * branchLen_];
+    float accI = 0.0f;
+    float accQ = 0.0f;
+    for (int j = 0; j < branchLen_; j++) {
+        accI += taps[j] * window[j].real();
+        accQ += taps[j] * window[j].imag();
+    }
+    return cf(accI, accQ);
+}
+
+size_t IQResamplerFFT::processFrame(const cf* work, int start, int available,
+                                    int& idx, int& phase, cf* output) {
+    const int foldedSize = fftSize_ / foldFactor_;
+    const int historyLen = branchLen_ - 1;
+    const int limit = std::min(start + blockLen_, available - historyLen);
+
+    // Find which branches this frame needs and where their first output sits
+    std::fill(branchFirst_.begin(), branchFirst_.end(), -1);
+    {
+        int i = idx;
+        int p = phase;
+        while (i < limit) {
+            if (branchFirst_[p] < 0) {
+                branchFirst_[p] = i + historyLen - start;
+            }
+            p += downFactor_;
+            i += p / upFactor_;
+            p %= upFactor_;
+        }
+    }
+
+    // Transform the frame (zero-padded past the end of the input)
+    int copyLen = std::min(fftSize_, available - start);
+    std::copy(work + start, work + start + copyLen, frame_);
+    std::fill(frame_ + copyLen, frame_ + fftSize_, cf(0.0f, 0.0f));
+    fft_.forward(frame_);
+
+    // Filter each needed branch, shift its outputs onto multiples of the
+    // fold factor and fold the spectrum to decimate before the inverse FFT
+    for (int p = 0; p < upFactor_; p++) {
+        if (branchFirst_[p] < 0) {
+            continue;
+        }
+        const int shift = branchFirst_[p] & (foldFactor_ - 1);
+        const cf* spectrum = &branchSpectra_[((size_t)p * foldFactor_ + shift) * fftSize_];
+        cf* folded = &branchOut_[(size_t)p * foldedSize];
+
+        for (int k = 0; k < foldedSize; k++) {
+            folded[k] = cmul(frame_[k], spectrum[k]);
+        }
+        for (int r = 1; r < foldFactor_; r++) {
+            const int base = r * foldedSize;
+            for (int k = 0; k < foldedSize; k++) {
+                folded[k] += cmul(frame_[base + k], spectrum[base + k]);
+            }
+        }
+
+        foldedFft_.inverse(folded);
+        branchShift_[p] = shift;
+    }
+
+    // Emit outputs in order
+    size_t produced = 0;
+    while (idx < limit) {
+        int pos = idx + historyLen - start;
+        output[produced++] = branchOut_[(size_t)phase * foldedSize + (pos - branchShift_[phase]) / foldFactor_];
+
+        phase += downFactor_;
+        idx += phase / upFactor_;
+        phase %= upFactor_;
+    }
+    return produced;
+}
+
+size_t IQResamplerFFT::process(const cf* input, size_t numInputSamples, cf* output) {
+    // Blocks longer than the scratch is sized for go through in pieces
+    size_t produced = 0;
+    size_t offset = 0;
+    do {
+        size_t n = std::min(numInputSamples - offset, maxBlock_);
+        produced += processBlock(input + offset, n, output + produced);
+        offset += n;
+    } while (offset < numInputSamples);
+    return produced;
+}
+
+size_t IQResamplerFFT::processBlock(const cf* input, size_t numInputSamples, cf* output) {
+    const int numInput = (int)numInputSamples;
+    const int historyLen = branchLen_ - 1;
+    const int workLen = historyLen + numInput;
+
+    // History followed by the new block
+    std::copy(state_, state_ + historyLen, work_);
+    std::copy(input, input + numInput, work_ + historyLen);
+
+    size_t produced = 0;
+    int idx = nextIndex_;
+    int phase = phase_;
+    if (numInput < blockLen_ && outputSamplesFor(numInputSamples) < directMaxOutputs_) {
+        // Too few outputs to pay for a frame transform: output idx's
+        // window is work_[idx .. idx + branchLen_ - 1]
+        while (idx < numInput) {
+            output[produced++] = directOutput(work_ + idx, phase);
+            phase += downFactor_;
+            idx += phase / upFactor_;
+            phase %= upFactor_;
+        }
+    } else {
+        while (idx < numInput) {
+            // Start each frame at the window of the next pending output
+            produced += processFrame(work_, idx, workLen, idx, phase, output + produced);
+        }
+    }
+    nextIndex_ = idx - numInput;
+    phase_ = phase;
+
+    // Keep the last branchLen_ - 1 samples as history
+    std::copy(work_ + workLen - historyLen, work_ + workLen, state_);
+    return produced;
+}
+
+std::vector<float> IQResamplerFFT::process(const std::vector<float>& input) {
+    if (input.size() % 2 != 0) {
+        throw std::invalid_argument("Input size must be even (I/Q pairs)");
+    }
+
+    size_t numInputSamples = input.size() / 2;
+    std::vector<float> output(outputSamplesFor(numInputSamples) * 2);
+    size_t produced = process(reinterpret_cast<const cf*>(input.data()), numInputSamples,
+                              reinterpret_cast<cf*>(output.data()));
+    output.resize(produced * 2);
+    return output;
+}
+
+void IQResamplerFFT::reserve(size_t maxInputSamples, const IQMemoryPolicy& policy) {
+    if (maxInputSamples == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+
+    const size_t spectraLen = (size_t)upFactor_ * foldFactor_ * fftSize_;
+    const size_t bankLen = (size_t)upFactor_ * branchLen_;
+    const size_t branchOutLen = (size_t)upFactor_ * (fftSize_ / foldFactor_);
+    const size_t historyLen = branchLen_ - 1;
+    const size_t workLen = historyLen + maxInputSamples;
+
+    // Carve everything from a new block and copy spectra and history over
+    // before it replaces the old one, so a failed reserve changes nothing
+    IQArena next(IQArena::bytesFor<cf>(spectraLen) + IQArena::bytesFor<float>(bankLen) +
+                 IQArena::bytesFor<cf>(fftSize_) + IQArena::bytesFor<cf>(branchOutLen) +
+                 IQArena::bytesFor<cf>(historyLen) + IQArena::bytesFor<cf>(workLen), policy);
+    cf* spectra = next.allocate<cf>(spectraLen);
+    float* bank = next.allocate<float>(bankLen);
+    cf* frame = next.allocate<cf>(fftSize_);
+    cf* branchOut = next.allocate<cf>(branchOutLen);
+    cf* state = next.allocate<cf>(historyLen);
+    cf* work = next.allocate<cf>(workLen);
+    if (branchSpectra_) {
+        std::copy(branchSpectra_, branchSpectra_ + spectraLen, spectra);
+        std::copy(bank_, bank_ + bankLen, bank);
+        std::copy(state_, state_ + historyLen, state);
+    } else {
+        std::fill(state, state + historyLen, cf(0.0f, 0.0f));
+    }
+
+    arena_ = std::move(next);
+    branchSpectra_ = spectra;
+    bank_ = bank;
+    frame_ = frame;
+    branchOut_ = branchOut;
+    state_ = state;
+    work_ = work;
+    maxBlock_ = maxInputSamples;
+}
+
+void IQResamplerFFT::reset() {
+    std::fill(state_, state_ + branchLen_ - 1, cf(0.0f, 0.0f));
+    phase_ = 0;
+    nextIndex_ = 0;
+}
+
+void IQResamplerFFT::prime(const cf* history, size_t count) {
+    reset();
+    const size_t historyLen = branchLen_ - 1;
+    size_t n = std::min(count, historyLen);
+    std::copy(history + count - n, history + count, state_ + historyLen - n);
+}
@@ -0,0 +1,128 @@
+#ifndef IQ_RESAMPLER_FFT_H
+#define IQ_RESAMPLER_FFT_H
+
+#include <vector>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+
+#include "iq_arena.h"
+#include "iq_fft.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Frequency-domain (overlap-save) Implementation
+// Same filter design and output timing as IQResamplerCPP in Polyphase
+// mode, but each polyphase branch is applied as a spectrum multiply and the
+// decimation by M is done by folding FFT bins, so cost grows with
+// log(taps) instead of taps. Pays off for long (sharp) filters.
+class IQResamplerFFT {
+private:
+    int inputRate_;
+    int outputRate_;
+    int upFactor_;
+    int downFactor_;
+    std::vector<float> filter_;
+    int filterLen_;
+    int branchLen_;    // Taps per polyphase branch
+
+    int fftSize_;      // Overlap-save frame length
+    int blockLen_;     // New input samples per frame
+    int foldFactor_;   // Power-of-two part of M folded in the frequency domain
+    IQFFT fft_;        // fftSize_ points
+    IQFFT foldedFft_;  // fftSize_ / foldFactor_ points
+
+    // Branch spectra, frame scratch and streaming history, carved from the
+    // arena so they follow the memory policy given to reserve()
+    IQArena arena_;
+    size_t maxBlock_;  // Longest block work_ holds; longer ones go in pieces
+
+    // Branch spectra (upFactor_ x foldFactor_ x fftSize_): one copy per
+    // output offset modulo the fold factor, pre-scaled by 1/fftSize_
+    std::complex<float>* branchSpectra_;
+
+    // The same branches in the time domain (upFactor_ x branchLen_,
+    // time-reversed), for blocks too short to be worth a frame transform
+    float* bank_;
+    size_t directMaxOutputs_;  // Blocks shorter than a frame with fewer outputs use the direct form
+
+    // Per-frame scratch
+    std::complex<float>* frame_;      // fftSize_
+    std::complex<float>* branchOut_;  // upFactor_ x (fftSize_ / foldFactor_)
+    std::vector<int> branchFirst_;    // First frame position per branch, -1 if unused
+    std::vector<int> branchShift_;    // Position offset modulo foldFactor_
+
+    // State for streaming
+    std::complex<float>* state_;  // Last branchLen_ - 1 input samples
+    std::complex<float>* work_;   // History + block of up to maxBlock_ samples
+    int phase_;      // Polyphase branch of the next output
+    int nextIndex_;  // Input index (in the next block) of the next output
+
+    // Build the branch spectra and scratch buffers from filter_
+    void init();
+
+    // Filter one frame starting at work[start] and emit its outputs
+    size_t processFrame(const std::complex<float>* work, int start, int available,
+                        int& idx, int& phase, std::complex<float>* output);
+
+    // Direct-form output of branch phase over window[0 .. branchLen_ - 1]
+    std::complex<float> directOutput(const std::complex<float>* window, int phase) const;
+
+    // process() for a block of at most maxBlock_ samples
+    size_t processBlock(const std::complex<float>* input, size_t numInputSamples,
+                        std::complex<float>* output);
+
+    static int chooseFFTSize(int branchLen);
+    static int chooseFoldFactor(int upFactor, int downFactor, int fftSize);
+
+public:
+    // Block size the scratch is sized for until reserve() is called
+    static const size_t DEFAULT_MAX_BLOCK_SAMPLES = 8192;
+
+    // filterTaps as for IQResamplerCPP: the whole prototype, at least
+    // IQFilterDesign::minimumTaps(inputRate, outputRate)
+    IQResamplerFFT(int inputRate, int outputRate, int filterTaps = 127);
+
+    // Use a caller-designed prototype (e.g. from IQFilterDesign) running at
+    // outputRate / gcd x the input rate, with unity DC gain
+    IQResamplerFFT(int inputRate, int outputRate, const std::vector<float>& prototype);
+
+    // A copy has the same filter and stream state in its own arena, placed
+    // with the source's memory policy
+    IQResamplerFFT(const IQResamplerFFT& other);
+    IQResamplerFFT& operator=(const IQResamplerFFT& other);
+    IQResamplerFFT(IQResamplerFFT&& other) = default;
+    IQResamplerFFT& operator=(IQResamplerFFT&& other) = default;
+
+    // Process IQ data
+    std::vector<float> process(const std::vector<float>& input);
+
+    // Process caller-owned buffers; output must hold outputSamplesFor()
+    // samples. Returns the number of IQ samples written.
+    size_t process(const std::complex<float>* input, size_t numInputSamples,
+                   std::complex<float>* output);
+
+    // Exact number of outputs the next numInputSamples will produce
+    size_t outputSamplesFor(size_t numInputSamples) const;
+
+    // Fewest input samples the next call needs to produce numOutputSamples
+    size_t inputSamplesNeededFor(size_t numOutputSamples) const;
+
+    int fftSize() const { return fftSize_; }
+
+    // Size the scratch for blocks of up to maxInputSamples (longer blocks
+    // are split with identical output) and move spectra, scratch and
+    // history into memory placed by policy; state is kept
+    void reserve(size_t maxInputSamples, const IQMemoryPolicy& policy = IQMemoryPolicy());
+    const IQArena& arena() const { return arena_; }
+
+    void reset();
+
+    // Reset, then load the last count samples of history as if they had
+    // already been processed (missing older history stays zero)
+    void prime(const std::complex<float>* history, size_t count);
+};
+
+#endif // IQ_RESAMPLER_FFT_H
@@ -2,6 +2,8 @@
 
 #ifdef USE_IPP
 
+const size_t IQResamplerIPP::DEFAULT_MAX_BLOCK_SAMPLES;
+
 void IQResamplerIPP::cleanup() {
     if (pSpecI_) {
         ippsFree(pSpecI_);
@@ -23,8 +25,9 @@ int IQResamplerIPP::gcd(int a, int b) {
 }
 
 IQResamplerIPP::IQResamplerIPP(int inputRate, int outputRate, float rolloff, int filterLen)
-    : inputRate_(inputRate), outputRate_(outputRate), filterLen_(filterLen),
-      pSpecI_(nullptr), pSpecQ_(nullptr) {
+    : inputRate_(inputRate), outputRate_(outputRate), filterLen_(filterLen), windowLen_(filterLen),
+      pSpecI_(nullptr), pSpecQ_(nullptr), maxBlock_(0),
+      inI_(nullptr), inQ_(nullptr), outI_(nullptr), outQ_(nullptr) {
 
     // Simplify ratio
     int g = gcd(inputRate, outputRate);
@@ -44,6 +47,7 @@ IQResamplerIPP::IQResamplerIPP(int inputRate, int outputRate, float rolloff, int
     if (status != ippStsNoErr) {
         throw std::runtime_error("IPP ResamplePolyphaseFixedGetSize failed for I channel");
     }
+    windowLen_ = lenI;
 
     // Allocate and initialize I channel
     pSpecI_ = (IppsResamplingPolyphaseFixed_32f*)ippsMalloc_8u(specSizeI);
@@ -96,6 +100,24 @@ IQResamplerIPP::IQResamplerIPP(int inputRate, int outputRate, float rolloff, int
         cleanup();
         throw std::runtime_error("IPP ResamplePolyphaseFixedInit failed for Q channel");
     }
+
+    reserve(DEFAULT_MAX_BLOCK_SAMPLES);
+}
+
+void IQResamplerIPP::reserve(size_t maxInputSamples, const IQMemoryPolicy& policy) {
+    if (maxInputSamples == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+    maxBlock_ = maxInputSamples;
+
+    // Same output bound process() hands to IPP
+    size_t outLen = (size_t)((long long)maxInputSamples * outputRate_ / inputRate_) + filterLen_;
+    arena_.reset(2 * IQArena::bytesFor<Ipp32f>(maxInputSamples) + 2 * IQArena::bytesFor<Ipp32f>(outLen),
+                 policy);
+    inI_ = arena_.allocate<Ipp32f>(maxInputSamples);
+    inQ_ = arena_.allocate<Ipp32f>(maxInputSamples);
+    outI_ = arena_.allocate<Ipp32f>(outLen);
+    outQ_ = arena_.allocate<Ipp32f>(outLen);
 }
 
 IQResamplerIPP::~IQResamplerIPP() {
@@ -107,24 +129,42 @@ std::vector<float> IQResamplerIPP::process(const std::vector<float>& input) {
         throw std::invalid_argument("Input size must be even (I/Q pairs)");
     }
 
-    int numInputSamples = input.size() / 2;
+    // This overload allocates anyway, so a block past reserve() grows the
+    // scratch here rather than failing
+    size_t numInputSamples = input.size() / 2;
+    if (numInputSamples > maxBlock_) {
+        reserve(numInputSamples, arena_.policy());
+    }
+    std::vector<float> output(outputSamplesFor(numInputSamples) * 2);
+    size_t produced = process(input.data(), numInputSamples, output.data(), output.size() / 2);
+    output.resize(produced * 2);
+    return output;
+}
+
+size_t IQResamplerIPP::process(const float* input, size_t numInputSamples, float* output,
+                               size_t outputCapacity) {
     if (numInputSamples == 0) {
-        return std::vector<float>();
+        return 0;
+    }
+    if (outputCapacity < outputSamplesFor(numInputSamples)) {
+        throw std::length_error("Output buffer too small for this block");
     }
 
-    // Separate I and Q
-    std::vector<float> inI(numInputSamples);
-    std::vector<float> inQ(numInputSamples);
+    // IPP restarts its time at 0 on every call, so a block cannot be split
+    // into pieces, and growing the scratch here would allocate mid-stream
+    if (numInputSamples > maxBlock_) {
+        throw std::length_error("Block larger than reserve()");
+    }
 
-    for (int i = 0; i < numInputSamples; i++) {
+    // Separate I and Q
+    Ipp32f* inI = inI_;
+    Ipp32f* inQ = inQ_;
+    for (size_t i = 0; i < numInputSamples; i++) {
         inI[i] = input[i * 2];
         inQ[i] = input[i * 2 + 1];
     }
-
-    // Calculate expected output size
-    int outLen = (int)((long long)numInputSamples * outputRate_ / inputRate_) + filterLen_;
-    std::vector<float> outI(outLen);
-    std::vector<float> outQ(outLen);
+    Ipp32f* outI = outI_;
+    Ipp32f* outQ = outQ_;
 
     IppStatus status;
     int outLenI = 0, outLenQ = 0;
@@ -132,8 +172,8 @@ std::vector<float> IQResamplerIPP::process(const std::vector<float>& input) {
 
     // Process I channel
     status = ippsResamplePolyphaseFixed_32f(
-        inI.data(), numInputSamples,
-        outI.data(),
+        inI, (int)numInputSamples,
+        outI,
         1.0f,  // norm factor
         &timeI,  // time/phase tracking
         &outLenI,
@@ -146,8 +186,8 @@ std::vector<float> IQResamplerIPP::process(const std::vector<float>& input) {
 
     // Process Q channel
     status = ippsResamplePolyphaseFixed_32f(
-        inQ.data(), numInputSamples,
-        outQ.data(),
+        inQ, (int)numInputSamples,
+        outQ,
         1.0f,  // norm factor
         &timeQ,  // time/phase tracking
         &outLenQ,
@@ -158,16 +198,37 @@ std::vector<float> IQResamplerIPP::process(const std::vector<float>& input) {
         throw std::runtime_error("IPP ResamplePolyphaseFixed failed (Q channel)");
     }
 
-    // Interleave I and Q (use the minimum length)
-    int actualOutLen = std::min(outLenI, outLenQ);
-    std::vector<float> output(actualOutLen * 2);
+    // Both channels run the same spec from time 0, so they agree; more
+    // than the caller has room for is an error, never a silent drop
+    if (outLenI != outLenQ) {
+        throw std::runtime_error("IPP ResamplePolyphaseFixed returned different I/Q lengths");
+    }
+    size_t produced = (size_t)outLenI;
+    if (produced > outputCapacity) {
+        throw std::length_error("Output buffer too small for this block");
+    }
 
-    for (int i = 0; i < actualOutLen; i++) {
+    // Interleave I and Q
+    for (size_t i = 0; i < produced; i++) {
         output[i * 2] = outI[i];
         output[i * 2 + 1] = outQ[i];
     }
 
-    return output;
+    return produced;
+}
+
+size_t IQResamplerIPP::outputSamplesFor(size_t numInputSamples) const {
+    // Output k sits at input time k*M/L; count those at or below
+    // numInputSamples, the last one for floating-point time landing short
+    return (size_t)((long long)numInputSamples * upFactor_ / downFactor_ + 1);
+}
+
+size_t IQResamplerIPP::inputSamplesNeededFor(size_t numOutputSamples) const {
+    if (numOutputSamples == 0) {
+        return 0;
+    }
+    // Output n - 1 needs its time (n - 1)*M/L below the input length
+    return (size_t)((long long)(numOutputSamples - 1) * downFactor_ / upFactor_ + 1);
 }
 
 void IQResamplerIPP::reset() {
@@ -6,6 +6,7 @@
 
 #ifdef USE_IPP
 #include <ipp.h>
+#include "iq_arena.h"
 
 // Intel IPP Implementation
 class IQResamplerIPP {
@@ -15,10 +16,20 @@ private:
     int upFactor_;
     int downFactor_;
     int filterLen_;
+    int windowLen_;  // Filter length in input samples, as rounded by IPP
 
     IppsResamplingPolyphaseFixed_32f* pSpecI_;
     IppsResamplingPolyphaseFixed_32f* pSpecQ_;
 
+    // Split I/Q input and output for blocks of up to maxBlock_ samples,
+    // carved from the arena
+    IQArena arena_;
+    size_t maxBlock_;
+    Ipp32f* inI_;
+    Ipp32f* inQ_;
+    Ipp32f* outI_;
+    Ipp32f* outQ_;
+
     void cleanup();
     int gcd(int a, int b);
 
@@ -26,9 +37,42 @@ public:
     IQResamplerIPP(int inputRate, int outputRate, float rolloff = 0.9f, int filterLen = 127);
     ~IQResamplerIPP();
 
+    // Block size the arena is sized for until reserve() is called
+    static const size_t DEFAULT_MAX_BLOCK_SAMPLES = 8192;
+
     // Process IQ data
     std::vector<float> process(const std::vector<float>& input);
 
+    // Same, from and into caller-owned interleaved I/Q buffers (counts in
+    // IQ samples); output must hold outputSamplesFor(numInputSamples)
+    // samples (std::length_error otherwise, also when IPP returns more
+    // than outputCapacity). Never allocates: a block longer than
+    // maxBlockSamples() throws std::length_error, since IPP cannot take it
+    // in pieces. Returns the samples written.
+    size_t process(const float* input, size_t numInputSamples, float* output, size_t outputCapacity);
+
+    // Size the scratch arena for blocks of up to maxInputSamples, placed
+    // per policy (huge pages, NUMA node); the vector overload of process()
+    // grows it for a longer block, the pointer overload does not
+    void reserve(size_t maxInputSamples, const IQMemoryPolicy& policy = IQMemoryPolicy());
+    size_t maxBlockSamples() const { return maxBlock_; }
+
+    // Upper bound on the IQ samples process() returns for numInputSamples.
+    // IPP computes outputs at input times 0, M/L, 2M/L, ... below
+    // numInputSamples (time restarts at 0 on every call), accumulated in
+    // floating point, so an output whose exact time is numInputSamples may
+    // still be produced: one more than the exact count when M divides
+    // numInputSamples x L, the exact count otherwise.
+    size_t outputSamplesFor(size_t numInputSamples) const;
+
+    // Fewest input samples that put numOutputSamples output times below
+    // the block end, so process() returns at least numOutputSamples
+    size_t inputSamplesNeededFor(size_t numOutputSamples) const;
+
+    // Algorithmic delay in input samples: IPP centres its window on each
+    // output time, so an output waits for half the window of newer input
+    double groupDelay() const { return windowLen_ / 2.0; }
+
     void reset();
 };
 
@@ -0,0 +1,357 @@
+#include "iq_resampler_q15.h"
+#include "iq_filter_design.h"
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Round and saturate a value to Q15
+inline int16_t saturateQ15(long value) {
+    if (value > 32767) return 32767;
+    if (value < -32768) return -32768;
+    return (int16_t)value;
+}
+
+#if defined(__AVX2__)
+inline int32_t horizontalSum(__m256i v) {
+    __m128i lo = _mm256_castsi256_si128(v);
+    __m128i hi = _mm256_extracti128_si256(v, 1);
+    lo = _mm_add_epi32(lo, hi);
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(lo);
+}
+#elif defined(__SSE2__)
+inline int32_t horizontalSum(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+#endif
+
+// Q15 x Q15 dot product of one filter branch with the I and Q windows.
+// pmaddwd multiplies 16-bit pairs and adds adjacent products into int32
+// lanes; the scalar tail wraps the same way so every path is bit-exact.
+inline void dotProductIQ(const int16_t* xI, const int16_t* xQ, const int16_t* h, int n,
+                         int32_t& outI, int32_t& outQ) {
+    int j = 0;
+    uint32_t sumI = 0;
+    uint32_t sumQ = 0;
+
+#if defined(__AVX2__)
+    __m256i accI = _mm256_setzero_si256();
+    __m256i accQ = _mm256_setzero_si256();
+    for (; j + 16 <= n; j += 16) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(h + j));
+        accI = _mm256_add_epi32(accI, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(xI + j)), c));
+        accQ = _mm256_add_epi32(accQ, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(xQ + j)), c));
+    }
+    sumI = (uint32_t)horizontalSum(accI);
+    sumQ = (uint32_t)horizontalSum(accQ);
+#elif defined(__SSE2__)
+    __m128i accI = _mm_setzero_si128();
+    __m128i accQ = _mm_setzero_si128();
+    for (; j + 8 <= n; j += 8) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(h + j));
+        accI = _mm_add_epi32(accI, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(xI + j)), c));
+        accQ = _mm_add_epi32(accQ, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(xQ + j)), c));
+    }
+    sumI = (uint32_t)horizontalSum(accI);
+    sumQ = (uint32_t)horizontalSum(accQ);
+#endif
+
+    for (; j < n; j++) {
+        sumI += (uint32_t)((int32_t)xI[j] * h[j]);
+        sumQ += (uint32_t)((int32_t)xQ[j] * h[j]);
+    }
+
+    outI = (int32_t)sumI;
+    outQ = (int32_t)sumQ;
+}
+
+// Convert an accumulator with shift extra fraction bits back to Q15,
+// rounding half up
+inline int16_t accumulatorToQ15(int32_t acc, int shift) {
+    return saturateQ15(((long)acc + (1L << (shift - 1))) >> shift);
+}
+
+// Input sample to Q15: float is rounded and saturated, SC16 already is
+// Q15 and SC8 (Q7) gains 8 fraction bits exactly
+inline int16_t toQ15(float value) {
+    return saturateQ15(std::lrint(value * 32768.0f));
+}
+
+inline int16_t toQ15(int16_t value) {
+    return value;
+}
+
+inline int16_t toQ15(int8_t value) {
+    return (int16_t)(value * 256);
+}
+
+// Where a block's Q15 output goes: straight into SC16 output, or into
+// scratch to be converted for float output
+inline int16_t* q15Output(int16_t* output, int16_t* /*scratch*/) {
+    return output;
+}
+
+inline int16_t* q15Output(float* /*output*/, int16_t* scratch) {
+    return scratch;
+}
+
+inline void storeQ15(int16_t value, int16_t* dst) {
+    *dst = value;
+}
+
+inline void storeQ15(int16_t value, float* dst) {
+    *dst = value * (1.0f / 32768.0f);
+}
+
+} // namespace
+
+const size_t IQResamplerQ15::DEFAULT_MAX_BLOCK_SAMPLES;
+
+void IQResamplerQ15::buildPolyphaseBank() {
+    // Pad branches with zero taps on the oldest side to a whole number of
+    // 16-lane pmaddwd blocks so the kernel never drops to its scalar tail
+    int taps = (filterLen_ + upFactor_ - 1) / upFactor_;
+    branchLen_ = (taps + 15) / 16 * 16;
+    bank_.assign((size_t)upFactor_ * branchLen_, 0);
+
+    // Taps are scaled by L, which can push short or narrow designs past 1.0;
+    // drop fraction bits until the largest tap fits in int16
+    double maxTap = 0.0;
+    for (int i = 0; i < filterLen_; i++) {
+        maxTap = std::max(maxTap, std::abs(filter_[i]) * upFactor_);
+    }
+    coefShift_ = 15;
+    while (coefShift_ > 1 && std::lrint(maxTap * (1 << coefShift_)) > 32767) {
+        coefShift_--;
+    }
+
+    // Branch p holds taps p, p + L, p + 2L, ... scaled by L and rounded
+    double coefScale = (double)(1 << coefShift_);
+    for (int p = 0; p < upFactor_; p++) {
+        int16_t* branch = &bank_[(size_t)p * branchLen_];
+        for (int k = 0; k < taps; k++) {
+            int idx = p + k * upFactor_;
+            if (idx < filterLen_) {
+                branch[branchLen_ - 1 - k] = saturateQ15(std::lrint(filter_[idx] * upFactor_ * coefScale));
+            }
+        }
+    }
+}
+
+IQResamplerQ15::IQResamplerQ15(int inputRate, int outputRate, int filterTaps)
+    : inputRate_(inputRate), outputRate_(outputRate), filterLen_(filterTaps),
+      branchLen_(0), coefShift_(15), maxBlock_(0), workI_(nullptr), workQ_(nullptr), outBlock_(nullptr),
+      phase_(0), nextIndex_(0) {
+
+    // Simplify the ratio
+    int g = IQFilterDesign::gcd(inputRate, outputRate);
+    upFactor_ = outputRate / g;
+    downFactor_ = inputRate / g;
+    IQFilterDesign::checkTaps(inputRate, outputRate, filterTaps);
+
+    // Generate anti-aliasing filter and quantize it
+    filter_ = IQFilterDesign::hamming(upFactor_, downFactor_, filterLen_);
+    buildPolyphaseBank();
+
+    reserve(DEFAULT_MAX_BLOCK_SAMPLES);
+}
+
+IQResamplerQ15::IQResamplerQ15(const IQResamplerQ15& other)
+    : inputRate_(other.inputRate_), outputRate_(other.outputRate_), upFactor_(other.upFactor_),
+      downFactor_(other.downFactor_), filter_(other.filter_), filterLen_(other.filterLen_),
+      bank_(other.bank_), branchLen_(other.branchLen_), coefShift_(other.coefShift_),
+      maxBlock_(0), workI_(other.workI_), workQ_(other.workQ_), outBlock_(nullptr),
+      phase_(other.phase_), nextIndex_(other.nextIndex_) {
+
+    // The history is read from other's arena while reserve() carves it
+    // from this one's
+    reserve(other.maxBlock_, other.arena_.policy());
+}
+
+IQResamplerQ15& IQResamplerQ15::operator=(const IQResamplerQ15& other) {
+    if (this != &other) {
+        *this = IQResamplerQ15(other);
+    }
+    return *this;
+}
+
+void IQResamplerQ15::reserve(size_t maxInputSamples, const IQMemoryPolicy& policy) {
+    if (maxInputSamples == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+
+    // Everything is carved from a new block, and the history copied over,
+    // before it replaces the old one: a failed reserve leaves the
+    // resampler usable at its old block size
+    const size_t history = branchLen_ - 1;
+    const size_t workLen = history + maxInputSamples;
+    const size_t outLen = 2 * maxOutputSamplesFor(maxInputSamples);
+    IQArena next(2 * IQArena::bytesFor<int16_t>(workLen) + IQArena::bytesFor<int16_t>(outLen), policy);
+    int16_t* workI = next.allocate<int16_t>(workLen);
+    int16_t* workQ = next.allocate<int16_t>(workLen);
+    int16_t* outBlock = next.allocate<int16_t>(outLen);
+    if (workI_) {
+        std::copy(workI_, workI_ + history, workI);
+        std::copy(workQ_, workQ_ + history, workQ);
+    } else {
+        std::fill(workI, workI + history, 0);
+        std::fill(workQ, workQ + history, 0);
+    }
+
+    arena_ = std::move(next);
+    workI_ = workI;
+    workQ_ = workQ;
+    outBlock_ = outBlock;
+    maxBlock_ = maxInputSamples;
+}
+
+size_t IQResamplerQ15::maxOutputSamplesFor(size_t numInputSamples) const {
+    // ceil(n x L / M) outputs, plus one when the first lands on the
+    // block's first sample
+    return (numInputSamples * upFactor_ + downFactor_ - 1) / downFactor_ + 1;
+}
+
+size_t IQResamplerQ15::inputSamplesNeededFor(size_t numOutputSamples) const {
+    if (numOutputSamples == 0) {
+        return 0;
+    }
+
+    // Upsampled position of the last requested output and the input
+    // sample it lands on
+    long long m = (long long)nextIndex_ * upFactor_ + phase_ + (long long)(numOutputSamples - 1) * downFactor_;
+    return (size_t)std::max(0LL, m / upFactor_ + 1);
+}
+
+size_t IQResamplerQ15::outputSamplesFor(size_t numInputSamples) const {
+    // Output k sits at upsampled position start + k*M, below n*L
+    long long start = (long long)nextIndex_ * upFactor_ + phase_;
+    long long end = (long long)numInputSamples * upFactor_;
+    if (end <= start) {
+        return 0;
+    }
+    return (size_t)((end - start + downFactor_ - 1) / downFactor_);
+}
+
+size_t IQResamplerQ15::resampleBlock(int numInputSamples, int16_t* output) {
+    const int16_t* inI = workI_;
+    const int16_t* inQ = workQ_;
+    size_t produced = 0;
+
+    // Output n sits at upsampled index n*M, i.e. input index idx with
+    // branch phase; its window is inI[idx .. idx + branchLen_ - 1]
+    int idx = nextIndex_;
+    int phase = phase_;
+    while (idx < numInputSamples) {
+        int32_t accI, accQ;
+        dotProductIQ(inI + idx, inQ + idx, &bank_[(size_t)phase * branchLen_],
+                     branchLen_, accI, accQ);
+        output[2 * produced] = accumulatorToQ15(accI, coefShift_);
+        output[2 * produced + 1] = accumulatorToQ15(accQ, coefShift_);
+        produced++;
+
+        phase += downFactor_;
+        idx += phase / upFactor_;
+        phase %= upFactor_;
+    }
+    nextIndex_ = idx - numInputSamples;
+    phase_ = phase;
+
+    // Keep the last branchLen_ - 1 samples as history
+    size_t history = branchLen_ - 1;
+    std::copy(workI_ + numInputSamples, workI_ + numInputSamples + history, workI_);
+    std::copy(workQ_ + numInputSamples, workQ_ + numInputSamples + history, workQ_);
+    return produced;
+}
+
+template <typename T, typename OutT>
+size_t IQResamplerQ15::processInterleaved(const T* input, size_t numInputSamples, OutT* output) {
+    // Quantize each block to Q15 behind the history and resample it
+    size_t history = branchLen_ - 1;
+    size_t written = 0;
+    for (size_t pos = 0; pos < numInputSamples; pos += maxBlock_) {
+        size_t n = std::min(maxBlock_, numInputSamples - pos);
+        const T* src = input + 2 * pos;
+        for (size_t i = 0; i < n; i++) {
+            workI_[history + i] = toQ15(src[i * 2]);
+            workQ_[history + i] = toQ15(src[i * 2 + 1]);
+        }
+        int16_t* out = q15Output(output + 2 * written, outBlock_);
+        size_t produced = resampleBlock((int)n, out);
+        if (out == outBlock_) {
+            for (size_t i = 0; i < 2 * produced; i++) {
+                storeQ15(outBlock_[i], &output[2 * written + i]);
+            }
+        }
+        written += produced;
+    }
+    return written;
+}
+
+template <typename T, typename OutT>
+std::vector<OutT> IQResamplerQ15::processVector(const std::vector<T>& input) {
+    if (input.size() % 2 != 0) {
+        throw std::invalid_argument("Input size must be even (I/Q pairs)");
+    }
+
+    size_t numInputSamples = input.size() / 2;
+    std::vector<OutT> output(2 * outputSamplesFor(numInputSamples));
+    size_t produced = processInterleaved(input.data(), numInputSamples, output.data());
+    output.resize(2 * produced);
+    return output;
+}
+
+size_t IQResamplerQ15::processSC16(const int16_t* input, size_t numInputSamples, int16_t* output,
+                                   size_t outputCapacity) {
+    if (numInputSamples > 0 && !input) {
+        throw std::invalid_argument("Input pointer is null");
+    }
+    if (outputCapacity < outputSamplesFor(numInputSamples)) {
+        throw std::length_error("Output buffer too small");
+    }
+    return processInterleaved(input, numInputSamples, output);
+}
+
+size_t IQResamplerQ15::processSC16(const int8_t* input, size_t numInputSamples, int16_t* output,
+                                   size_t outputCapacity) {
+    if (numInputSamples > 0 && !input) {
+        throw std::invalid_argument("Input pointer is null");
+    }
+    if (outputCapacity < outputSamplesFor(numInputSamples)) {
+        throw std::length_error("Output buffer too small");
+    }
+    return processInterleaved(input, numInputSamples, output);
+}
+
+std::vector<int16_t> IQResamplerQ15::processSC16(const std::vector<int16_t>& input) {
+    return processVector<int16_t, int16_t>(input);
+}
+
+std::vector<int16_t> IQResamplerQ15::processSC16(const std::vector<int8_t>& input) {
+    return processVector<int8_t, int16_t>(input);
+}
+
+std::vector<float> IQResamplerQ15::process(const std::vector<float>& input) {
+    return processVector<float, float>(input);
+}
+
+std::vector<float> IQResamplerQ15::process(const std::vector<int16_t>& input) {
+    return processVector<int16_t, float>(input);
+}
+
+std::vector<float> IQResamplerQ15::process(const std::vector<int8_t>& input) {
+    return processVector<int8_t, float>(input);
+}
+
+void IQResamplerQ15::reset() {
+    std::fill(workI_, workI_ + (branchLen_ - 1), 0);
+    std::fill(workQ_, workQ_ + (branchLen_ - 1), 0);
+    phase_ = 0;
+    nextIndex_ = 0;
+}
@@ -0,0 +1,128 @@
+#ifndef IQ_RESAMPLER_Q15_H
+#define IQ_RESAMPLER_Q15_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include "iq_arena.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Fixed-point Implementation
+// Polyphase resampler with Q15 coefficients, Q15 samples and int32
+// accumulators. The prototype is designed in double and quantized once;
+// all filtering is integer, so output is bit-exact across compilers,
+// flags and SIMD/scalar kernels.
+class IQResamplerQ15 {
+public:
+    // Block size the scratch arena is sized for until reserve() is called
+    static const size_t DEFAULT_MAX_BLOCK_SAMPLES = 8192;
+
+private:
+    int inputRate_;
+    int outputRate_;
+    int upFactor_;
+    int downFactor_;
+    std::vector<double> filter_;
+    int filterLen_;
+
+    // Polyphase filter bank in Q15: upFactor_ branches of branchLen_ taps,
+    // stored time-reversed so each output is a contiguous dot product
+    std::vector<int16_t> bank_;
+    int branchLen_;
+    int coefShift_;  // Fraction bits of the bank (15, fewer if taps exceed 1.0)
+
+    // Split Q15 input: branchLen_ - 1 samples of history followed by up
+    // to maxBlock_ new samples, and the Q15 output of one such block, all
+    // carved from the arena. Longer blocks are processed in pieces, so
+    // process() never allocates.
+    IQArena arena_;
+    size_t maxBlock_;
+    int16_t* workI_;
+    int16_t* workQ_;
+    int16_t* outBlock_;
+
+    // Streaming state
+    int phase_;      // Polyphase branch of the next output
+    int nextIndex_;  // Input index (in the next block) of the next output
+
+    // Quantize the prototype filter into the Q15 polyphase bank
+    void buildPolyphaseBank();
+
+    // Resample the numInputSamples samples loaded behind the history in
+    // workI_/workQ_, writing interleaved Q15 output; returns IQ samples
+    size_t resampleBlock(int numInputSamples, int16_t* output);
+
+    // Quantize interleaved input (float, SC16 or SC8) to Q15 block by
+    // block and resample it into interleaved output (Q15, or float with
+    // the Q15 block converted back); room for outputSamplesFor() pairs
+    template <typename T, typename OutT>
+    size_t processInterleaved(const T* input, size_t numInputSamples, OutT* output);
+
+    template <typename T, typename OutT>
+    std::vector<OutT> processVector(const std::vector<T>& input);
+
+public:
+    // filterTaps as for IQResamplerCPP: the whole prototype, at least
+    // IQFilterDesign::minimumTaps(inputRate, outputRate)
+    IQResamplerQ15(int inputRate, int outputRate, int filterTaps = 127);
+
+    // A copy has the same bank and stream state, in its own arena placed
+    // with the source's memory policy
+    IQResamplerQ15(const IQResamplerQ15& other);
+    IQResamplerQ15& operator=(const IQResamplerQ15& other);
+    IQResamplerQ15(IQResamplerQ15&& other) = default;
+    IQResamplerQ15& operator=(IQResamplerQ15&& other) = default;
+
+    // Process float IQ data; samples are quantized to Q15 on input
+    std::vector<float> process(const std::vector<float>& input);
+
+    // Process interleaved SC16 / SC8 IQ data into float, at the same full
+    // scale as IQResamplerCPP's defaults (1.0 <-> 32768 / 128). SC16 is
+    // Q15 as is and SC8 is shifted up 8 bits, so neither is rounded.
+    std::vector<float> process(const std::vector<int16_t>& input);
+    std::vector<float> process(const std::vector<int8_t>& input);
+
+    // Same, with Q15 (SC16) output
+    std::vector<int16_t> processSC16(const std::vector<int16_t>& input);
+    std::vector<int16_t> processSC16(const std::vector<int8_t>& input);
+
+    // Same, in caller-owned buffers (counts in IQ samples); output must
+    // hold outputSamplesFor(numInputSamples) samples (std::length_error
+    // otherwise). Does not allocate; returns the IQ samples written.
+    size_t processSC16(const int16_t* input, size_t numInputSamples, int16_t* output, size_t outputCapacity);
+    size_t processSC16(const int8_t* input, size_t numInputSamples, int16_t* output, size_t outputCapacity);
+
+    // Size the scratch arena for blocks of up to maxInputSamples
+    // (DEFAULT_MAX_BLOCK_SAMPLES from the constructor), placed per policy
+    // as for IQResamplerCPP::reserve(); longer blocks are split into
+    // pieces of that size with identical output. The history is kept, and
+    // a failed reserve leaves the resampler as it was.
+    void reserve(size_t maxInputSamples, const IQMemoryPolicy& policy = IQMemoryPolicy());
+    size_t maxBlockSamples() const { return maxBlock_; }
+    const IQArena& arena() const { return arena_; }
+
+    // Exact number of IQ samples the next call returns for numInputSamples
+    size_t outputSamplesFor(size_t numInputSamples) const;
+
+    // Most IQ samples one call can return for numInputSamples, whatever
+    // the phase, for output buffers reused across blocks
+    size_t maxOutputSamplesFor(size_t numInputSamples) const;
+
+    // Fewest input samples the next call needs to return numOutputSamples
+    size_t inputSamplesNeededFor(size_t numOutputSamples) const;
+
+    // Quantized polyphase bank (branch p at p * branchLength(), taps
+    // time-reversed) and its fraction bits
+    const std::vector<int16_t>& polyphaseBank() const { return bank_; }
+    int branchLength() const { return branchLen_; }
+    int coefficientShift() const { return coefShift_; }
+
+    void reset();
+};
+
+#endif // IQ_RESAMPLER_Q15_H
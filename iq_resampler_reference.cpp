@@ -0,0 +1,190 @@
+#include "iq_resampler_reference.h"
+#include "iq_filter_design.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const long double PI_L = 3.141592653589793238462643383279502884L;
+
+// Largest L whose per-phase window weights are cached
+const int MAX_CACHED_PHASES = 4096;
+
+// Zeroth-order modified Bessel function of the first kind (power series)
+long double besselI0(long double x) {
+    long double sum = 1.0L;
+    long double term = 1.0L;
+    long double half = x / 2.0L;
+    for (int k = 1; k < 500; k++) {
+        term *= (half / k) * (half / k);
+        sum += term;
+        if (term < sum * 1e-21L) {
+            break;
+        }
+    }
+    return sum;
+}
+
+long double sinc(long double x) {
+    if (x == 0.0L) {
+        return 1.0L;
+    }
+    return std::sin(PI_L * x) / (PI_L * x);
+}
+
+} // namespace
+
+IQResamplerReference::IQResamplerReference(int inputRate, int outputRate, double delay,
+                                           int zeroCrossings, double kaiserBeta)
+    : delay_(delay), ideal_(true), zeroCrossings_(zeroCrossings), kaiserBeta_(kaiserBeta) {
+    if (inputRate <= 0 || outputRate <= 0) {
+        throw std::invalid_argument("Sample rates must be positive");
+    }
+    if (zeroCrossings < 1) {
+        throw std::invalid_argument("Need at least one zero crossing");
+    }
+    int g = IQFilterDesign::gcd(inputRate, outputRate);
+    upFactor_ = outputRate / g;
+    downFactor_ = inputRate / g;
+    cutoff_ = std::min(1.0L, (long double)upFactor_ / downFactor_);
+}
+
+IQResamplerReference::IQResamplerReference(int inputRate, int outputRate, const std::vector<float>& prototype)
+    : ideal_(false), zeroCrossings_(0), kaiserBeta_(0.0L), cutoff_(0.0L),
+      prototype_(prototype.begin(), prototype.end()) {
+    if (inputRate <= 0 || outputRate <= 0) {
+        throw std::invalid_argument("Sample rates must be positive");
+    }
+    if (prototype.empty()) {
+        throw std::invalid_argument("Filter must have at least one tap");
+    }
+    int g = IQFilterDesign::gcd(inputRate, outputRate);
+    upFactor_ = outputRate / g;
+    downFactor_ = inputRate / g;
+    delay_ = IQFilterDesign::groupDelay(prototype) / upFactor_;
+}
+
+size_t IQResamplerReference::outputSamplesFor(size_t numInputSamples) const {
+    return (size_t)(((unsigned long long)numInputSamples * upFactor_ + downFactor_ - 1) / downFactor_);
+}
+
+long double IQResamplerReference::kaiser(long double x, long double halfWidth) const {
+    long double r = x / halfWidth;
+    if (r <= -1.0L || r >= 1.0L) {
+        return 0.0L;
+    }
+    return besselI0(kaiserBeta_ * std::sqrt(1.0L - r * r)) / besselI0(kaiserBeta_);
+}
+
+void IQResamplerReference::idealWeights(int phase, long long& first, std::vector<long double>& weights) const {
+    // Output time is k + phase / L - delay for an integer k; taps cover
+    // the window around it, relative to k
+    const long double frac = (long double)phase / upFactor_ - delay_;
+    const long double halfWidth = zeroCrossings_ / cutoff_;
+    first = (long long)std::ceil(frac - halfWidth);
+    long long last = (long long)std::floor(frac + halfWidth);
+
+    weights.resize(last - first + 1);
+    long double gain = 0.0L;
+    for (long long i = first; i <= last; i++) {
+        long double x = frac - i;
+        long double w = cutoff_ * sinc(cutoff_ * x) * kaiser(x, halfWidth);
+        weights[i - first] = w;
+        gain += w;
+    }
+    for (size_t i = 0; i < weights.size(); i++) {
+        weights[i] /= gain;
+    }
+}
+
+std::complex<double> IQResamplerReference::idealOutput(const std::vector<std::complex<double> >& input,
+                                                       size_t n) const {
+    const long long m = (long long)n * downFactor_;
+    const int phase = (int)(m % upFactor_);
+    const long long k = m / upFactor_;
+
+    // Weights repeat every L outputs; cache them when L is small enough
+    long long first;
+    std::vector<long double> local;
+    const std::vector<long double>* weights = &local;
+    if (upFactor_ <= MAX_CACHED_PHASES) {
+        if (phaseWeights_.empty()) {
+            phaseWeights_.resize(upFactor_);
+            phaseFirst_.resize(upFactor_);
+        }
+        if (phaseWeights_[phase].empty()) {
+            idealWeights(phase, phaseFirst_[phase], phaseWeights_[phase]);
+        }
+        first = phaseFirst_[phase];
+        weights = &phaseWeights_[phase];
+    } else {
+        idealWeights(phase, first, local);
+    }
+
+    long double sumI = 0.0L;
+    long double sumQ = 0.0L;
+    for (size_t j = 0; j < weights->size(); j++) {
+        long long i = k + first + (long long)j;
+        if (i >= 0 && i < (long long)input.size()) {
+            sumI += (*weights)[j] * input[i].real();
+            sumQ += (*weights)[j] * input[i].imag();
+        }
+    }
+    return std::complex<double>((double)sumI, (double)sumQ);
+}
+
+std::complex<double> IQResamplerReference::prototypeOutput(const std::vector<std::complex<double> >& input,
+                                                           size_t n) const {
+    // Upsampled position of the output; tap j meets input (m - j) / L
+    const long long m = (long long)n * downFactor_;
+    const long long taps = (long long)prototype_.size();
+
+    long double sumI = 0.0L;
+    long double sumQ = 0.0L;
+    for (long long j = m % upFactor_; j < taps && j <= m; j += upFactor_) {
+        long long i = (m - j) / upFactor_;
+        if (i < (long long)input.size()) {
+            sumI += prototype_[j] * input[i].real();
+            sumQ += prototype_[j] * input[i].imag();
+        }
+    }
+    return std::complex<double>((double)(sumI * upFactor_), (double)(sumQ * upFactor_));
+}
+
+std::vector<std::complex<double> > IQResamplerReference::process(
+    const std::vector<std::complex<double> >& input) const {
+    std::vector<std::complex<double> > output(outputSamplesFor(input.size()));
+    for (size_t n = 0; n < output.size(); n++) {
+        output[n] = ideal_ ? idealOutput(input, n) : prototypeOutput(input, n);
+    }
+    return output;
+}
+
+std::vector<std::complex<double> > IQResamplerReference::process(const std::vector<float>& input) const {
+    if (input.size() % 2 != 0) {
+        throw std::invalid_argument("Input size must be even (I/Q pairs)");
+    }
+    std::vector<std::complex<double> > samples(input.size() / 2);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = std::complex<double>(input[i * 2], input[i * 2 + 1]);
+    }
+    return process(samples);
+}
+
+IQErrorBudget IQResamplerReference::compare(const std::complex<double>* reference, const float* output,
+                                            size_t count, size_t skip) {
+    IQErrorBudget budget;
+    budget.maxAbsError = 0.0;
+    double errorPower = 0.0;
+    double signalPower = 0.0;
+    for (size_t i = skip; i < count; i++) {
+        std::complex<double> error = std::complex<double>(output[i * 2], output[i * 2 + 1]) - reference[i];
+        budget.maxAbsError = std::max(budget.maxAbsError, std::abs(error));
+        errorPower += std::norm(error);
+        signalPower += std::norm(reference[i]);
+    }
+    size_t n = (count > skip) ? count - skip : 0;
+    budget.rmsError = n ? std::sqrt(errorPower / n) : 0.0;
+    budget.errorDb = 10.0 * std::log10(errorPower / signalPower);
+    return budget;
+}
@@ -0,0 +1,84 @@
+#ifndef IQ_RESAMPLER_REFERENCE_H
+#define IQ_RESAMPLER_REFERENCE_H
+
+#include <complex>
+#include <vector>
+#include <stdexcept>
+
+// Error of a fast resampler's output against the reference
+struct IQErrorBudget {
+    double maxAbsError;  // Largest |output - reference|
+    double rmsError;
+    double errorDb;      // rms error relative to the reference's rms (dB)
+};
+
+// Slow, exact L/M resampler for accuracy baselines in tests and
+// benchmarks. Every sum is accumulated in long double straight from the
+// definition (no polyphase bank, no SIMD, no FFT), over a whole signal at
+// once, with zeros outside it. Output n is at input time n x M / L, like
+// every other resampler here, so outputs line up index for index.
+// Window weights are cached on first use, so one instance must not be
+// shared between threads.
+class IQResamplerReference {
+public:
+    // Ideal bandlimited resampler: sinc cut off at the narrower Nyquist,
+    // zeroCrossings zero crossings each side under a Kaiser window, gain
+    // normalized to exactly 1 at DC for every fractional offset. Output n
+    // is x(n x M / L - delay), delay in input samples (e.g. a fast
+    // resampler's groupDelay() to line up with it).
+    IQResamplerReference(int inputRate, int outputRate, double delay = 0.0,
+                         int zeroCrossings = 256, double kaiserBeta = 14.0);
+
+    // The same prototype a polyphase resampler runs (at L x the input
+    // rate, e.g. IQResamplerCPP::filterCoefficients()), evaluated exactly:
+    // y[n] = L x sum_j h[j] u[n M - j], u the zero-stuffed input. Differences
+    // from the fast resampler are then its arithmetic error alone.
+    IQResamplerReference(int inputRate, int outputRate, const std::vector<float>& prototype);
+
+    // Resample a whole signal; outputSamplesFor(input size) outputs
+    std::vector<std::complex<double> > process(const std::vector<std::complex<double> >& input) const;
+
+    // Same for interleaved float IQ
+    std::vector<std::complex<double> > process(const std::vector<float>& input) const;
+
+    // ceil(numInputSamples x L / M), what a fresh streaming resampler
+    // returns for the same input
+    size_t outputSamplesFor(size_t numInputSamples) const;
+
+    // Delay of the output in input samples
+    double groupDelay() const { return delay_; }
+
+    // Compare count interleaved float IQ outputs against the reference,
+    // skipping the first skip (e.g. the filter warm-up when the fast
+    // resampler differs from the reference in filter, not just arithmetic)
+    static IQErrorBudget compare(const std::complex<double>* reference, const float* output,
+                                 size_t count, size_t skip = 0);
+
+private:
+    int upFactor_;
+    int downFactor_;
+    double delay_;
+
+    // Ideal mode
+    bool ideal_;
+    int zeroCrossings_;
+    long double kaiserBeta_;
+    long double cutoff_;  // Cycles per input sample x 2 (1 = input Nyquist)
+    mutable std::vector<std::vector<long double> > phaseWeights_;  // Per output phase, built on use
+    mutable std::vector<long long> phaseFirst_;
+
+    // Prototype mode
+    std::vector<long double> prototype_;
+
+    // Kaiser window at offset x from the centre, half-width halfWidth
+    long double kaiser(long double x, long double halfWidth) const;
+
+    // Normalized window weights for output phase (n x M mod L), starting
+    // first input samples after floor(n x M / L)
+    void idealWeights(int phase, long long& first, std::vector<long double>& weights) const;
+
+    std::complex<double> idealOutput(const std::vector<std::complex<double> >& input, size_t n) const;
+    std::complex<double> prototypeOutput(const std::vector<std::complex<double> >& input, size_t n) const;
+};
+
+#endif // IQ_RESAMPLER_REFERENCE_H
@@ -0,0 +1,87 @@
+#ifndef IQ_RING_BUFFER_H
+#define IQ_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// Lock-free single-producer / single-consumer ring of IQ samples.
+// One thread writes (e.g. the SDR receive thread), one thread reads (e.g.
+// a playback callback pulling from the resampler). Storage is allocated
+// once in the constructor; read() and write() never allocate or block.
+class IQRingBuffer {
+public:
+    // Capacity is rounded up to a power of two
+    explicit IQRingBuffer(size_t capacity) : head_(0), tail_(0) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Ring buffer capacity must be positive");
+        }
+        size_t size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        buffer_.resize(size);
+        mask_ = size - 1;
+    }
+
+    size_t capacity() const { return buffer_.size(); }
+
+    // Samples ready to read / free slots to write
+    size_t available() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+    size_t space() const {
+        return capacity() - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+    }
+
+    // Producer side: copy up to count samples in, returns how many fit
+    size_t write(const std::complex<float>* data, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t n = std::min(count, capacity() - (head - tail));
+        copyIn(head, data, n);
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side: copy up to count samples out, returns how many were read
+    size_t read(std::complex<float>* data, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t n = std::min(count, head - tail);
+        copyOut(tail, data, n);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side: drop everything currently buffered
+    void clear() {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    std::vector<std::complex<float> > buffer_;
+    size_t mask_;
+    std::atomic<size_t> head_;  // Total samples written (producer)
+    std::atomic<size_t> tail_;  // Total samples read (consumer)
+
+    // Copy across the wrap point in at most two pieces
+    void copyIn(size_t pos, const std::complex<float>* data, size_t n) {
+        size_t start = pos & mask_;
+        size_t first = std::min(n, capacity() - start);
+        std::copy(data, data + first, buffer_.begin() + start);
+        std::copy(data + first, data + n, buffer_.begin());
+    }
+
+    void copyOut(size_t pos, std::complex<float>* data, size_t n) const {
+        size_t start = pos & mask_;
+        size_t first = std::min(n, capacity() - start);
+        std::copy(buffer_.begin() + start, buffer_.begin() + start + first, data);
+        std::copy(buffer_.begin(), buffer_.begin() + (n - first), data + first);
+    }
+};
+
+#endif // IQ_RING_BUFFER_H
@@ -0,0 +1,49 @@
+#ifndef IQ_SPAN_H
+#define IQ_SPAN_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Non-owning view of a contiguous array (C++11 stand-in for std::span).
+// Lets callers hand a piece of a larger buffer (e.g. a DMA ring) to the
+// resampler without copying it into a std::vector first.
+template <typename T>
+class IQSpan {
+public:
+    typedef T element_type;
+    typedef typename std::remove_const<T>::type value_type;
+
+    IQSpan() : data_(nullptr), size_(0) {}
+    IQSpan(T* data, size_t size) : data_(data), size_(size) {}
+
+    // Views of a whole vector
+    IQSpan(std::vector<value_type>& v) : data_(v.data()), size_(v.size()) {}
+    IQSpan(const std::vector<value_type>& v) : data_(v.data()), size_(v.size()) {}
+
+    // IQSpan<T> converts to IQSpan<const T>
+    IQSpan(const IQSpan<value_type>& other) : data_(other.data()), size_(other.size()) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t i) const { return data_[i]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+    // View of count elements starting at offset
+    IQSpan subspan(size_t offset, size_t count) const {
+        if (offset > size_ || count > size_ - offset) {
+            throw std::out_of_range("IQSpan::subspan out of range");
+        }
+        return IQSpan(data_ + offset, count);
+    }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+#endif // IQ_SPAN_H
@@ -0,0 +1,116 @@
+#include "iq_telemetry.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+#if defined(IQ_TELEMETRY_RDTSC)
+// TSC rate against the steady clock over a short sleep (the TSC of any
+// CPU this code targets runs at a constant rate, idle or not)
+double calibrateTicksPerSecond() {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point t0 = Clock::now();
+    IQTelemetry::Ticks c0 = IQTelemetry::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Clock::time_point t1 = Clock::now();
+    IQTelemetry::Ticks c1 = IQTelemetry::now();
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    return seconds > 0.0 ? (double)(c1 - c0) / seconds : 0.0;
+}
+#endif
+
+} // namespace
+
+const int IQTelemetrySnapshot::HISTOGRAM_BUCKETS;
+const bool IQTelemetry::ENABLED;
+
+double IQTelemetry::ticksPerSecond() {
+#if defined(IQ_NO_TELEMETRY)
+    return 0.0;
+#elif defined(IQ_TELEMETRY_RDTSC)
+    static const double rate = calibrateTicksPerSecond();
+    return rate;
+#else
+    return 1e9;
+#endif
+}
+
+double IQTelemetrySnapshot::meanNs() const {
+    if (calls == 0 || ticksPerSecond <= 0.0) {
+        return 0.0;
+    }
+    return totalTicks / ticksPerSecond * 1e9 / calls;
+}
+
+double IQTelemetrySnapshot::percentileNs(double p) const {
+    if (calls == 0 || ticksPerSecond <= 0.0) {
+        return 0.0;
+    }
+    uint64_t target = (uint64_t)std::ceil(p * calls);
+    uint64_t seen = 0;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+        seen += histogram[b];
+        if (seen >= target && histogram[b] > 0) {
+            // Upper edge of the bucket, never past the longest call
+            double ticks = (b == 0) ? 0.0 : std::ldexp(1.0, b);
+            if (b == HISTOGRAM_BUCKETS - 1 || ticks > maxTicks) {
+                ticks = (double)maxTicks;
+            }
+            return ticks / ticksPerSecond * 1e9;
+        }
+    }
+    return maxTicks / ticksPerSecond * 1e9;
+}
+
+IQTelemetrySnapshot IQTelemetry::snapshot() const {
+    IQTelemetrySnapshot s;
+    std::memset(&s, 0, sizeof(s));
+#if !defined(IQ_NO_TELEMETRY)
+    s.calls = calls_.load(std::memory_order_relaxed);
+    s.inputSamples = inputSamples_.load(std::memory_order_relaxed);
+    s.outputSamples = outputSamples_.load(std::memory_order_relaxed);
+    s.underruns = underruns_.load(std::memory_order_relaxed);
+    s.overruns = overruns_.load(std::memory_order_relaxed);
+    s.totalTicks = totalTicks_.load(std::memory_order_relaxed);
+    s.maxTicks = maxTicks_.load(std::memory_order_relaxed);
+    for (int b = 0; b < IQTelemetrySnapshot::HISTOGRAM_BUCKETS; b++) {
+        s.histogram[b] = histogram_[b].load(std::memory_order_relaxed);
+    }
+    s.ticksPerSecond = ticksPerSecond();
+#endif
+    return s;
+}
+
+void IQTelemetry::take(const IQTelemetry& other) noexcept {
+#if !defined(IQ_NO_TELEMETRY)
+    calls_.store(other.calls_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    inputSamples_.store(other.inputSamples_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    outputSamples_.store(other.outputSamples_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    underruns_.store(other.underruns_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    overruns_.store(other.overruns_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    totalTicks_.store(other.totalTicks_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    maxTicks_.store(other.maxTicks_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (int b = 0; b < IQTelemetrySnapshot::HISTOGRAM_BUCKETS; b++) {
+        histogram_[b].store(other.histogram_[b].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+#else
+    (void)other;
+#endif
+}
+
+void IQTelemetry::reset() {
+#if !defined(IQ_NO_TELEMETRY)
+    calls_.store(0, std::memory_order_relaxed);
+    inputSamples_.store(0, std::memory_order_relaxed);
+    outputSamples_.store(0, std::memory_order_relaxed);
+    underruns_.store(0, std::memory_order_relaxed);
+    overruns_.store(0, std::memory_order_relaxed);
+    totalTicks_.store(0, std::memory_order_relaxed);
+    maxTicks_.store(0, std::memory_order_relaxed);
+    for (int b = 0; b < IQTelemetrySnapshot::HISTOGRAM_BUCKETS; b++) {
+        histogram_[b].store(0, std::memory_order_relaxed);
+    }
+#endif
+}
@@ -0,0 +1,160 @@
+#ifndef IQ_TELEMETRY_H
+#define IQ_TELEMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(IQ_NO_TELEMETRY) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define IQ_TELEMETRY_RDTSC 1
+#else
+#include <chrono>
+#endif
+
+// A point-in-time copy of an IQTelemetry, in the resampler's time stamp
+// ticks (TSC cycles on x86, nanoseconds elsewhere)
+struct IQTelemetrySnapshot {
+    static const int HISTOGRAM_BUCKETS = 48;
+
+    uint64_t calls;          // Blocks through the filter
+    uint64_t inputSamples;
+    uint64_t outputSamples;
+    uint64_t underruns;      // Input not there when it was needed
+    uint64_t overruns;       // Output with nowhere to go
+    uint64_t totalTicks;     // Processing time, summed over calls
+    uint64_t maxTicks;
+
+    // Calls by processing time: bucket b counts [2^(b-1), 2^b) ticks
+    // (bucket 0: 0 ticks), the last one everything longer
+    uint64_t histogram[HISTOGRAM_BUCKETS];
+
+    double ticksPerSecond;
+
+    double totalSeconds() const { return ticksPerSecond > 0.0 ? totalTicks / ticksPerSecond : 0.0; }
+    double meanNs() const;
+
+    // Processing time (ns) below which a fraction p of the calls fall,
+    // from the histogram: upper edge of the bucket, so within 2x
+    double percentileNs(double p) const;
+};
+
+// Per-instance runtime statistics of a resampler: how often it is
+// called, how many samples go through, how long each call takes and
+// whether its stream starves or overflows. Written by the one thread
+// that runs the resampler, with relaxed atomic loads and stores (no
+// locked read-modify-write), and readable from any other thread with
+// snapshot(); fields of a snapshot taken mid-call may be one call apart.
+// Building with IQ_NO_TELEMETRY (CMake ENABLE_TELEMETRY=OFF) removes it:
+// every method becomes an empty inline and snapshot() returns zeros.
+class IQTelemetry {
+public:
+    typedef uint64_t Ticks;
+
+#if defined(IQ_NO_TELEMETRY)
+    static const bool ENABLED = false;
+#else
+    static const bool ENABLED = true;
+#endif
+
+    IQTelemetry() { reset(); }
+
+    IQTelemetry(const IQTelemetry&) = delete;
+    IQTelemetry& operator=(const IQTelemetry&) = delete;
+
+    // Moving takes the counts along (the resampler owning it moves); only
+    // while neither side is being written
+    IQTelemetry(IQTelemetry&& other) noexcept { take(other); }
+    IQTelemetry& operator=(IQTelemetry&& other) noexcept {
+        take(other);
+        return *this;
+    }
+
+    // Time stamp counter: rdtsc on x86, steady clock ns elsewhere
+    static Ticks now() {
+#if defined(IQ_NO_TELEMETRY)
+        return 0;
+#elif defined(IQ_TELEMETRY_RDTSC)
+        return __rdtsc();
+#else
+        return (Ticks)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // Ticks per second of now(), measured once against the steady clock
+    static double ticksPerSecond();
+
+    // A call that started at start (from now()) is done
+    void record(Ticks start, size_t inputSamples, size_t outputSamples) {
+#if !defined(IQ_NO_TELEMETRY)
+        Ticks ticks = now() - start;
+        bump(calls_, 1);
+        bump(inputSamples_, inputSamples);
+        bump(outputSamples_, outputSamples);
+        bump(totalTicks_, ticks);
+        if (ticks > maxTicks_.load(std::memory_order_relaxed)) {
+            maxTicks_.store(ticks, std::memory_order_relaxed);
+        }
+        bump(histogram_[bucket(ticks)], 1);
+#else
+        (void)start;
+        (void)inputSamples;
+        (void)outputSamples;
+#endif
+    }
+
+    // Stream events, also for the code driving the resampler (e.g. a
+    // worker finding its input ring short or its output ring full)
+    void recordUnderrun() {
+#if !defined(IQ_NO_TELEMETRY)
+        bump(underruns_, 1);
+#endif
+    }
+    void recordOverrun() {
+#if !defined(IQ_NO_TELEMETRY)
+        bump(overruns_, 1);
+#endif
+    }
+
+    IQTelemetrySnapshot snapshot() const;
+
+    // Back to zero; only from the writing thread, or while it is idle
+    void reset();
+
+private:
+    void take(const IQTelemetry& other) noexcept;
+
+#if !defined(IQ_NO_TELEMETRY)
+    std::atomic<uint64_t> calls_;
+    std::atomic<uint64_t> inputSamples_;
+    std::atomic<uint64_t> outputSamples_;
+    std::atomic<uint64_t> underruns_;
+    std::atomic<uint64_t> overruns_;
+    std::atomic<uint64_t> totalTicks_;
+    std::atomic<uint64_t> maxTicks_;
+    std::atomic<uint64_t> histogram_[IQTelemetrySnapshot::HISTOGRAM_BUCKETS];
+
+    // Single writer: a relaxed load and store instead of fetch_add
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static int bucket(Ticks ticks) {
+        if (ticks == 0) {
+            return 0;
+        }
+#if defined(__GNUC__)
+        int b = 64 - __builtin_clzll(ticks);
+#else
+        int b = 0;
+        while (ticks >> b) {
+            b++;
+        }
+#endif
+        return b < IQTelemetrySnapshot::HISTOGRAM_BUCKETS ? b : IQTelemetrySnapshot::HISTOGRAM_BUCKETS - 1;
+    }
+#endif
+};
+
+#endif // IQ_TELEMETRY_H
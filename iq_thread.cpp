@@ -0,0 +1,225 @@
+#include "iq_thread.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#endif
+
+namespace {
+
+const int64_t NS_PER_SECOND = 1000000000;
+
+int64_t monotonicNs() {
+#if defined(__linux__)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * NS_PER_SECOND + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Absolute sleeps, so wake-up times do not drift with processing time
+void sleepUntilNs(int64_t deadline) {
+#if defined(__linux__)
+    timespec ts;
+    ts.tv_sec = deadline / NS_PER_SECOND;
+    ts.tv_nsec = deadline % NS_PER_SECOND;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline)));
+#endif
+}
+
+void recordError(IQThreadStatus& status, int error) {
+    if (status.error == 0) {
+        status.error = error;
+    }
+}
+
+} // namespace
+
+IQThreadStatus applyThreadConfig(const IQThreadConfig& config) {
+    IQThreadStatus status;
+
+#if defined(__linux__)
+    if (config.cpus.empty()) {
+        status.affinityApplied = true;
+    } else {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (size_t i = 0; i < config.cpus.size(); i++) {
+            if (config.cpus[i] >= 0 && config.cpus[i] < CPU_SETSIZE) {
+                CPU_SET(config.cpus[i], &set);
+            }
+        }
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        status.affinityApplied = (err == 0);
+        if (err != 0) {
+            recordError(status, err);
+        }
+    }
+
+    if (config.scheduling == IQThreadConfig::Scheduling::Default) {
+        status.schedulingApplied = true;
+    } else {
+        int policy = (config.scheduling == IQThreadConfig::Scheduling::Fifo) ? SCHED_FIFO : SCHED_RR;
+        sched_param param;
+        param.sched_priority = std::min(std::max(config.priority, sched_get_priority_min(policy)),
+                                        sched_get_priority_max(policy));
+        int err = pthread_setschedparam(pthread_self(), policy, &param);
+        status.schedulingApplied = (err == 0);
+        if (err != 0) {
+            recordError(status, err);
+        }
+    }
+
+    if (config.lockMemory) {
+        status.memoryLocked = (mlockall(MCL_CURRENT | MCL_FUTURE) == 0);
+        if (!status.memoryLocked) {
+            recordError(status, errno);
+        }
+    }
+#else
+    status.affinityApplied = config.cpus.empty();
+    status.schedulingApplied = (config.scheduling == IQThreadConfig::Scheduling::Default);
+    if (!status.affinityApplied || !status.schedulingApplied || config.lockMemory) {
+        status.error = ENOSYS;
+    }
+#endif
+
+    return status;
+}
+
+IQResamplerWorker::IQResamplerWorker(IQResamplerCPP& resampler, IQRingBuffer& input, IQRingBuffer& output,
+                                     size_t blockSamples, const IQThreadConfig& config)
+    : resampler_(resampler), input_(input), output_(output), blockSamples_(blockSamples),
+      config_(config), periodNs_(0), running_(false), ready_(false),
+      blocks_(0), missed_(0), underruns_(0), dropped_(0), errors_(0), worstNs_(0) {
+    if (blockSamples == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+    periodNs_ = (int64_t)blockSamples * NS_PER_SECOND / resampler.inputRate();
+}
+
+IQResamplerWorker::~IQResamplerWorker() {
+    stop();
+}
+
+void IQResamplerWorker::start() {
+    if (running()) {
+        return;
+    }
+    if (periodNs_ <= 0) {
+        throw std::invalid_argument("Period must be positive");
+    }
+
+    // Every output a block can produce, whatever the phase
+    inBlock_.resize(blockSamples_);
+    outBlock_.resize(resampler_.maxOutputSamplesFor(blockSamples_));
+
+    blocks_.store(0);
+    missed_.store(0);
+    underruns_.store(0);
+    dropped_.store(0);
+    errors_.store(0);
+    worstNs_.store(0);
+
+    ready_.store(false);
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&IQResamplerWorker::run, this);
+    while (!ready_.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    if (startError_) {
+        thread_.join();
+        std::exception_ptr error = startError_;
+        startError_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void IQResamplerWorker::stop() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+IQDeadlineStats IQResamplerWorker::stats() const {
+    IQDeadlineStats s;
+    s.blocks = blocks_.load(std::memory_order_relaxed);
+    s.missedDeadlines = missed_.load(std::memory_order_relaxed);
+    s.underruns = underruns_.load(std::memory_order_relaxed);
+    s.droppedSamples = dropped_.load(std::memory_order_relaxed);
+    s.errors = errors_.load(std::memory_order_relaxed);
+    s.worstLatencyNs = worstNs_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void IQResamplerWorker::run() {
+    // Scheduling and memory first, then the resampler's scratch, so a
+    // LOCAL_NODE arena lands on the node this thread is pinned to
+    threadStatus_ = applyThreadConfig(config_);
+    try {
+        resampler_.reserve(blockSamples_, resampler_.arena().policy());
+    } catch (...) {
+        // Leaving the thread with it would terminate the process; start()
+        // rethrows it instead (the resampler is left as it was)
+        startError_ = std::current_exception();
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        running_.store(false, std::memory_order_release);
+        ready_.store(true, std::memory_order_release);
+        return;
+    }
+    ready_.store(true, std::memory_order_release);
+
+    int64_t start = monotonicNs();
+    for (uint64_t k = 0; running_.load(std::memory_order_acquire); k++) {
+        const int64_t scheduled = start + (int64_t)k * periodNs_;
+        sleepUntilNs(scheduled);
+
+        if (input_.available() < blockSamples_) {
+            underruns_.fetch_add(1, std::memory_order_relaxed);
+            resampler_.telemetry().recordUnderrun();
+            continue;
+        }
+
+        input_.read(inBlock_.data(), blockSamples_);
+        size_t produced = 0;
+        try {
+            produced = resampler_.process(inBlock_.data(), blockSamples_, outBlock_.data(), outBlock_.size());
+        } catch (const std::exception&) {
+            // An exception leaving the thread would terminate the process;
+            // the block is lost and counted instead
+            errors_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        size_t written = output_.write(outBlock_.data(), produced);
+        if (written < produced) {
+            dropped_.fetch_add(produced - written, std::memory_order_relaxed);
+            resampler_.telemetry().recordOverrun();
+        }
+
+        const int64_t latency = monotonicNs() - scheduled;
+        blocks_.fetch_add(1, std::memory_order_relaxed);
+        if (latency > periodNs_) {
+            missed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (latency > worstNs_.load(std::memory_order_relaxed)) {
+            worstNs_.store(latency, std::memory_order_relaxed);
+        }
+        if (observer_) {
+            observer_(latency);
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef IQ_THREAD_H
+#define IQ_THREAD_H
+
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "iq_resampler_cpp.h"
+#include "iq_ring_buffer.h"
+
+// How a pipeline thread should be scheduled. Like IQMemoryPolicy, every
+// setting degrades gracefully: without the permission (SCHED_FIFO and
+// mlockall usually need CAP_SYS_NICE / CAP_IPC_LOCK or rlimits) or OS
+// support, the thread still runs, and IQThreadStatus says what was applied.
+struct IQThreadConfig {
+    enum class Scheduling { Default, Fifo, RoundRobin };
+
+    std::vector<int> cpus;  // CPUs the thread may run on (empty: leave as is)
+    Scheduling scheduling;
+    int priority;           // Real-time priority, clamped to the policy's range
+    bool lockMemory;        // mlockall(MCL_CURRENT | MCL_FUTURE), process-wide
+
+    IQThreadConfig() : scheduling(Scheduling::Default), priority(0), lockMemory(false) {}
+};
+
+// What applyThreadConfig() managed to do; error is the errno of the first
+// request that failed (0 when all succeeded)
+struct IQThreadStatus {
+    bool affinityApplied;
+    bool schedulingApplied;
+    bool memoryLocked;
+    int error;
+
+    IQThreadStatus() : affinityApplied(false), schedulingApplied(false), memoryLocked(false), error(0) {}
+};
+
+// Apply config to the calling thread. Never throws for missing permission
+// or support; settings left at their defaults count as applied.
+IQThreadStatus applyThreadConfig(const IQThreadConfig& config);
+
+// Deadline accounting for IQResamplerWorker. Latency of a block runs from
+// its scheduled start (wake-up jitter included) to its output being
+// written; a block misses its deadline when that exceeds the period.
+struct IQDeadlineStats {
+    uint64_t blocks;          // Blocks processed
+    uint64_t missedDeadlines;
+    uint64_t underruns;       // Periods with less than a block of input
+    uint64_t droppedSamples;  // Output that did not fit in the output ring
+    uint64_t errors;          // Blocks lost to an exception from the resampler, or a failed start()
+    int64_t worstLatencyNs;
+};
+
+// Real-time pipeline stage: a thread that wakes once per block period,
+// takes one block from the input ring, resamples it and writes the
+// result to the output ring, under an IQThreadConfig. The schedule is
+// absolute (block k starts at start + k x period), so a late block shows
+// up as missed deadlines rather than drifting the schedule. The worker
+// never blocks on its rings: short input is an underrun, output that
+// does not fit is dropped, and both are counted (here and in the
+// resampler's telemetry, as underruns and overruns).
+class IQResamplerWorker {
+public:
+    // Latency of every block in ns, called on the worker thread
+    typedef std::function<void(int64_t latencyNs)> LatencyObserver;
+
+    // Period defaults to blockSamples at the resampler's input rate. The
+    // resampler and rings must outlive the worker and, while it runs, only
+    // the worker may use the resampler and consume/produce its side of
+    // each ring.
+    IQResamplerWorker(IQResamplerCPP& resampler, IQRingBuffer& input, IQRingBuffer& output,
+                      size_t blockSamples, const IQThreadConfig& config = IQThreadConfig());
+    ~IQResamplerWorker();
+
+    IQResamplerWorker(const IQResamplerWorker&) = delete;
+    IQResamplerWorker& operator=(const IQResamplerWorker&) = delete;
+
+    // Settings take effect on the next start()
+    void setPeriod(int64_t periodNs) { periodNs_ = periodNs; }
+    void setLatencyObserver(LatencyObserver observer) { observer_ = observer; }
+    int64_t period() const { return periodNs_; }
+
+    // Start the thread and wait until it has applied its config (and
+    // reserved the resampler for the block size, on that thread); stop()
+    // returns within one period. Stats restart from zero on start().
+    // When that reserve() throws (e.g. std::bad_alloc), the thread exits
+    // and start() rethrows the exception, counted in stats().errors.
+    void start();
+    void stop();
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // Safe to call from any thread while the worker runs
+    IQDeadlineStats stats() const;
+    IQThreadStatus threadStatus() const { return threadStatus_; }
+
+private:
+    IQResamplerCPP& resampler_;
+    IQRingBuffer& input_;
+    IQRingBuffer& output_;
+    size_t blockSamples_;
+    IQThreadConfig config_;
+    int64_t periodNs_;
+    LatencyObserver observer_;
+
+    // Block buffers, allocated before the thread starts
+    std::vector<std::complex<float> > inBlock_;
+    std::vector<std::complex<float> > outBlock_;
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> ready_;
+    IQThreadStatus threadStatus_;  // Written before ready_ is set
+    std::exception_ptr startError_;  // Same: reserve() failure on the worker thread
+
+    std::atomic<uint64_t> blocks_;
+    std::atomic<uint64_t> missed_;
+    std::atomic<uint64_t> underruns_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> errors_;
+    std::atomic<int64_t> worstNs_;
+
+    void run();
+};
+
+#endif // IQ_THREAD_H
@@ -0,0 +1,364 @@
+#!/usr/bin/env python3
+"""Benchmark baselines and regression checks for benchmark_resampler.cpp.
+
+    bench_compare.py save RUN.json -o baselines/benchmark_cpp.json [--target benchmark_cpp]
+    bench_compare.py compare BASELINE.json RUN.json [--markdown report.md]
+    bench_compare.py table RUN.json [--markdown table.md]
+
+RUN.json is Google Benchmark output (--benchmark_out=RUN.json
+--benchmark_out_format=json), ideally with --benchmark_repetitions=N so
+every case has N independent timings; a saved baseline is accepted
+wherever a run is. A baseline is a versioned JSON file (see FORMAT and
+VERSION) holding the per-repetition times, throughput and counters of
+every case plus the git commit, machine and library context they came
+from.
+
+compare builds a Welch confidence interval (default 95%) for the change
+in mean time of each case. A case regressed when the whole interval lies
+above --threshold (default 5%) slower: statistically significant and big
+enough to matter. It improved when the whole interval lies below the
+threshold faster. Cases with a single repetition on either side get no
+interval and are never flagged. The exit status is 1 when anything
+regressed, so CI can fail on it. A summary table gives the geometric mean
+of the time ratios per backend (the CPP in BM_CPP_48kTo44k), which is how
+build variants (LTO, PGO) are reported.
+
+table prints a markdown table (mean time with its confidence interval,
+MSamples/s, cycles/sample when perf counters were on) for BENCHMARK.md.
+
+No dependencies beyond the Python 3 standard library.
+"""
+
+import argparse
+import datetime
+import json
+import math
+import os
+import subprocess
+import sys
+from collections import OrderedDict
+
+FORMAT = "iq-resampler-benchmark-baseline"
+VERSION = 1
+
+TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+CONTEXT_KEYS = ("host_name", "num_cpus", "mhz_per_cpu", "cpu_scaling_enabled", "caches",
+                "library_build_type", "executable", "date")
+SKIPPED_COUNTERS = ("items_per_second", "bytes_per_second")
+
+
+# Student's t distribution (for the confidence intervals)
+
+def _betacf(a, b, x):
+    """Continued fraction of the incomplete beta function (modified Lentz)"""
+    tiny = 1e-300
+    qab, qap, qam = a + b, a + 1.0, a - 1.0
+    c, d = 1.0, 1.0 - qab * x / qap
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, 300):
+        m2 = 2 * m
+        aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+        d = 1.0 + aa * d
+        d = 1.0 / (d if abs(d) > tiny else tiny)
+        c = 1.0 + aa / c
+        c = c if abs(c) > tiny else tiny
+        h *= d * c
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+        d = 1.0 + aa * d
+        d = 1.0 / (d if abs(d) > tiny else tiny)
+        c = 1.0 + aa / c
+        c = c if abs(c) > tiny else tiny
+        delta = d * c
+        h *= delta
+        if abs(delta - 1.0) < 1e-15:
+            break
+    return h
+
+
+def _betai(a, b, x):
+    """Regularized incomplete beta function I_x(a, b)"""
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) +
+                     a * math.log(x) + b * math.log(1.0 - x))
+    if x < (a + 1.0) / (a + b + 2.0):
+        return front * _betacf(a, b, x) / a
+    return 1.0 - front * _betacf(b, a, 1.0 - x) / b
+
+
+def t_cdf(t, df):
+    tail = 0.5 * _betai(df / 2.0, 0.5, df / (df + t * t))
+    return 1.0 - tail if t > 0 else tail
+
+
+def t_quantile(p, df):
+    """t with P(T <= t) = p, by bisection (p > 0.5)"""
+    lo, hi = 0.0, 1e3
+    for _ in range(200):
+        mid = 0.5 * (lo + hi)
+        if t_cdf(mid, df) < p:
+            lo = mid
+        else:
+            hi = mid
+    return 0.5 * (lo + hi)
+
+
+def mean(values):
+    return sum(values) / len(values)
+
+
+def variance(values):
+    m = mean(values)
+    return sum((v - m) ** 2 for v in values) / (len(values) - 1) if len(values) > 1 else 0.0
+
+
+def mean_interval(values, confidence):
+    """Half-width of the confidence interval of the mean (None for one value)"""
+    n = len(values)
+    if n < 2:
+        return None
+    return t_quantile(0.5 + confidence / 2.0, n - 1) * math.sqrt(variance(values) / n)
+
+
+def welch_interval(base, current, confidence):
+    """Confidence interval of mean(current) - mean(base), or None"""
+    n1, n2 = len(base), len(current)
+    if n1 < 2 or n2 < 2:
+        return None
+    v1, v2 = variance(base) / n1, variance(current) / n2
+    diff = mean(current) - mean(base)
+    se = math.sqrt(v1 + v2)
+    if se == 0.0:
+        return diff, diff
+    df = (v1 + v2) ** 2 / (v1 * v1 / (n1 - 1) + v2 * v2 / (n2 - 1))
+    half = t_quantile(0.5 + confidence / 2.0, df) * se
+    return diff - half, diff + half
+
+
+# Runs and baselines
+
+def git_info():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+    def run(*args):
+        try:
+            return subprocess.check_output(("git", "-C", root) + args, stderr=subprocess.DEVNULL,
+                                           universal_newlines=True).strip()
+        except (OSError, subprocess.CalledProcessError):
+            return None
+
+    return {"commit": run("rev-parse", "HEAD"), "describe": run("describe", "--always", "--dirty")}
+
+
+def from_run(data):
+    """Google Benchmark JSON -> {name: entry} with per-repetition samples"""
+    cases = OrderedDict()
+    for b in data.get("benchmarks", []):
+        if b.get("run_type", "iteration") != "iteration" or b.get("error_occurred"):
+            continue
+        name = b.get("run_name", b["name"])
+        unit = TIME_UNIT_NS[b.get("time_unit", "ns")]
+
+        # Cases timed on the wall clock (UseRealTime) are compared on it
+        kind = "real" if name.endswith("/real_time") else "cpu"
+        entry = cases.setdefault(name, {"time_kind": kind, "times_ns": [], "items_per_second": [],
+                                        "counters": OrderedDict()})
+        entry["times_ns"].append(b["%s_time" % kind] * unit)
+        if "items_per_second" in b:
+            entry["items_per_second"].append(b["items_per_second"])
+        for key, value in b.items():
+            if isinstance(value, (int, float)) and not isinstance(value, bool) and \
+                    key not in SKIPPED_COUNTERS and key not in (
+                    "family_index", "per_family_instance_index", "repetitions", "repetition_index",
+                    "threads", "iterations", "real_time", "cpu_time"):
+                entry["counters"].setdefault(key, []).append(value)
+    return cases
+
+
+def load(path):
+    """A baseline or a raw run, as a baseline"""
+    with open(path) as f:
+        data = json.load(f)
+    if data.get("format") == FORMAT:
+        if data.get("version", 0) > VERSION:
+            sys.exit("%s: baseline version %s is newer than this tool (%d)" % (path, data["version"], VERSION))
+        return data
+    context = data.get("context", {})
+    return {
+        "format": FORMAT,
+        "version": VERSION,
+        "context": dict((k, context[k]) for k in CONTEXT_KEYS if k in context),
+        "benchmarks": from_run(data),
+    }
+
+
+def save(args):
+    baseline = load(args.run)
+    baseline["created"] = datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds")
+    baseline["git"] = git_info()
+    if args.target:
+        baseline["target"] = args.target
+    directory = os.path.dirname(os.path.abspath(args.output))
+    os.makedirs(directory, exist_ok=True)
+    with open(args.output, "w") as f:
+        json.dump(baseline, f, indent=1)
+        f.write("\n")
+    reps = [len(b["times_ns"]) for b in baseline["benchmarks"].values()]
+    print("saved %d cases (%s repetitions) to %s" % (len(reps), "/".join(sorted(set(map(str, reps)))) or "0",
+                                                    args.output))
+    if reps and min(reps) < 2:
+        print("warning: run with --benchmark_repetitions=N (N >= 5) so compare can test significance",
+              file=sys.stderr)
+
+
+# Reports
+
+def format_time(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return "%.3g %s" % (ns / scale, unit)
+    return "%.3g ns" % ns
+
+
+def describe(baseline):
+    context = baseline.get("context", {})
+    git = baseline.get("git", {}) or {}
+    parts = [context.get("host_name", "?"), "%s CPUs" % context.get("num_cpus", "?")]
+    if context.get("mhz_per_cpu"):
+        parts.append("%s MHz" % context["mhz_per_cpu"])
+    if git.get("describe"):
+        parts.append("git %s" % git["describe"])
+    if baseline.get("created"):
+        parts.append(baseline["created"])
+    return ", ".join(str(p) for p in parts)
+
+
+def backend(name):
+    """Backend part of a case name: BM_CPP_48kTo44k -> CPP"""
+    parts = name.split("/")[0].split("_")
+    return parts[1] if len(parts) > 2 and parts[0] == "BM" else parts[0]
+
+
+def compare(args):
+    base = load(args.baseline)
+    current = load(args.run)
+    lines = ["| Benchmark | Baseline | Current | Change | %d%% CI | Status |" % round(args.confidence * 100),
+             "|---|---:|---:|---:|---:|---|"]
+    regressions, improvements, compared = 0, 0, 0
+    ratios = OrderedDict()  # Backend -> time ratios
+
+    for name, cur in current["benchmarks"].items():
+        old = base["benchmarks"].get(name)
+        if old is None:
+            continue
+        compared += 1
+        b_mean, c_mean = mean(old["times_ns"]), mean(cur["times_ns"])
+        change = c_mean / b_mean - 1.0
+        ratios.setdefault(backend(name), []).append(c_mean / b_mean)
+        interval = welch_interval(old["times_ns"], cur["times_ns"], args.confidence)
+        if interval is None:
+            status, ci = "no CI (1 rep)", "-"
+        else:
+            low, high = interval[0] / b_mean, interval[1] / b_mean
+            ci = "%+.1f%% .. %+.1f%%" % (100 * low, 100 * high)
+            if low > args.threshold:
+                status = "**REGRESSION**"
+                regressions += 1
+            elif high < -args.threshold:
+                status = "improved"
+                improvements += 1
+            else:
+                status = "~"
+        if args.only_changes and status in ("~", "no CI (1 rep)"):
+            continue
+        lines.append("| `%s` | %s | %s | %+.1f%% | %s | %s |" % (
+            name, format_time(b_mean), format_time(c_mean), 100 * change, ci, status))
+    missing = [n for n in base["benchmarks"] if n not in current["benchmarks"]]
+
+    summary = ["| Backend | Cases | Geomean time | Speedup |", "|---|---:|---:|---:|"]
+    for group, values in ratios.items():
+        geomean = math.exp(sum(math.log(v) for v in values) / len(values))
+        summary.append("| %s | %d | %+.1f%% | %.2fx |" % (group, len(values), 100 * (geomean - 1.0), 1.0 / geomean))
+    summary.append("")
+
+    header = ["## %s" % args.title, "",
+              "- Baseline: %s" % describe(base),
+              "- Current: %s" % describe(current),
+              "- Flagged when the whole %d%% Welch confidence interval of the change in mean time is beyond "
+              "±%.0f%%" % (round(args.confidence * 100), 100 * args.threshold),
+              "- %d regressed, %d improved, %d compared" % (regressions, improvements, compared), ""]
+    for key in ("host_name", "num_cpus", "library_build_type"):
+        b, c = base.get("context", {}).get(key), current.get("context", {}).get(key)
+        if b is not None and c is not None and b != c:
+            header.insert(2, "- **Warning:** %s differs (%s vs %s); times may not be comparable" % (key, b, c))
+    footer = [""]
+    if missing:
+        footer.append("Not in the current run: %s" % ", ".join("`%s`" % n for n in missing))
+    report = "\n".join(header + summary + lines + footer) + "\n"
+
+    print(report)
+    if args.markdown:
+        with open(args.markdown, "a" if args.append else "w") as f:
+            f.write(report)
+    return 1 if regressions else 0
+
+
+def table(args):
+    run = load(args.run)
+    lines = ["Measured on %s." % describe(run), "",
+             "| Benchmark | Time | ±%d%% | MSamples/s | Cycles/sample |" % round(args.confidence * 100),
+             "|---|---:|---:|---:|---:|"]
+    for name, entry in run["benchmarks"].items():
+        times = entry["times_ns"]
+        half = mean_interval(times, args.confidence)
+        msps = "%.1f" % (mean(entry["items_per_second"]) / 1e6) if entry["items_per_second"] else "-"
+        cycles = entry["counters"].get("cycles_per_sample")
+        lines.append("| `%s` | %s | %s | %s | %s |" % (
+            name, format_time(mean(times)), "%.1f%%" % (100 * half / mean(times)) if half is not None else "-",
+            msps, "%.2f" % mean(cycles) if cycles else "-"))
+    report = "\n".join(lines) + "\n"
+    print(report)
+    if args.markdown:
+        with open(args.markdown, "w") as f:
+            f.write(report)
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command")
+    sub.required = True
+
+    p = sub.add_parser("save", help="store a run as a baseline")
+    p.add_argument("run")
+    p.add_argument("-o", "--output", required=True)
+    p.add_argument("--target", help="benchmark executable the run came from")
+    p.set_defaults(func=save)
+
+    p = sub.add_parser("compare", help="flag significant changes against a baseline")
+    p.add_argument("baseline")
+    p.add_argument("run")
+    p.add_argument("--threshold", type=float, default=0.05,
+                   help="smallest change worth flagging, as a fraction (default 0.05)")
+    p.add_argument("--confidence", type=float, default=0.95)
+    p.add_argument("--only-changes", action="store_true", help="list regressed and improved cases only")
+    p.add_argument("--markdown", help="also write the report to this file")
+    p.add_argument("--append", action="store_true", help="append to the markdown file")
+    p.add_argument("--title", default="Benchmark comparison", help="report heading")
+    p.set_defaults(func=compare)
+
+    p = sub.add_parser("table", help="markdown table of one run")
+    p.add_argument("run")
+    p.add_argument("--confidence", type=float, default=0.95)
+    p.add_argument("--markdown", help="also write the table to this file")
+    p.set_defaults(func=table)
+
+    args = parser.parse_args()
+    sys.exit(args.func(args) or 0)
+
+
+if __name__ == "__main__":
+    main()
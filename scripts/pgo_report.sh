@@ -0,0 +1,85 @@
+#!/bin/sh
+# Build the benchmarks three ways and report what LTO and PGO buy per
+# backend (BENCHMARK.md "Optimized Builds"):
+#
+#   release   -O3 -march=native, the default build
+#   lto       release + ENABLE_LTO
+#   pgo       release + ENABLE_LTO + IQ_PGO (instrumented build, pgo_train,
+#             rebuild with the profiles, all in one build directory)
+#
+# Usage: scripts/pgo_report.sh [build-root] [extra cmake args...]
+#
+# Each variant runs the benchmark baseline cases (BENCHMARK_BASELINE_FILTER)
+# with repetitions; bench_compare.py then compares lto and pgo against
+# release and writes <build-root>/pgo_report.md. Environment:
+#   IQ_PGO_TARGETS   benchmarks to run (default: benchmark_cpp benchmark_cpp_scalar,
+#                    plus benchmark_ipp when it was built)
+#   IQ_PGO_REPS      repetitions per case (default 10)
+#   IQ_PGO_FILTER    benchmark filter (default: the baseline cases)
+
+set -e
+
+SOURCE_DIR=$(cd "$(dirname "$0")/.." && pwd)
+ROOT=${1:-"$SOURCE_DIR/build-pgo-report"}
+[ $# -gt 0 ] && shift
+REPS=${IQ_PGO_REPS:-10}
+FILTER=${IQ_PGO_FILTER:-"120kTo100k|48kTo44k|Format_|LongFilter|Polyphase_|Pull|Comparison"}
+JOBS=$(nproc 2>/dev/null || echo 2)
+COMPARE="python3 $SOURCE_DIR/scripts/bench_compare.py"
+
+# configure <variant> [cmake args...]
+configure() {
+    local name="$1"
+    shift
+    cmake -S "$SOURCE_DIR" -B "$ROOT/$name" -DCMAKE_BUILD_TYPE=Release "$@" >"$ROOT/$name.log" 2>&1 || {
+        tail -20 "$ROOT/$name.log"
+        exit 1
+    }
+}
+
+build() {
+    cmake --build "$ROOT/$1" -j"$JOBS" --target "$2" >>"$ROOT/$1.log" 2>&1 || {
+        tail -20 "$ROOT/$1.log"
+        exit 1
+    }
+}
+
+mkdir -p "$ROOT"
+
+echo "== release"
+configure release "$@"
+echo "== lto"
+configure lto -DENABLE_LTO=ON "$@"
+echo "== pgo (instrumented)"
+configure pgo -DENABLE_LTO=ON -DIQ_PGO=GENERATE "$@"
+build pgo pgo_train
+
+echo "== pgo (optimized)"
+configure pgo -DENABLE_LTO=ON -DIQ_PGO=USE "$@"
+
+TARGETS=${IQ_PGO_TARGETS:-"benchmark_cpp benchmark_cpp_scalar"}
+if [ -z "$IQ_PGO_TARGETS" ] && grep -q "^USE_IPP:BOOL=ON" "$ROOT/release/CMakeCache.txt"; then
+    TARGETS="$TARGETS benchmark_ipp"
+fi
+
+REPORT="$ROOT/pgo_report.md"
+echo "# Optimized builds" >"$REPORT"
+echo >>"$REPORT"
+
+for target in $TARGETS; do
+    for variant in release lto pgo; do
+        build $variant "$target"
+        echo "== $target ($variant)"
+        "$ROOT/$variant/$target" --benchmark_filter="$FILTER" \
+            --benchmark_repetitions="$REPS" --benchmark_enable_random_interleaving=true \
+            --benchmark_min_time=0.2 --benchmark_format=console \
+            --benchmark_out="$ROOT/$target-$variant.json" --benchmark_out_format=json >/dev/null
+    done
+    # Exit status 1 only means something got slower, which is a result here
+    $COMPARE compare "$ROOT/$target-release.json" "$ROOT/$target-lto.json" \
+        --title "$target: LTO vs release" --markdown "$REPORT" --append >/dev/null || true
+    $COMPARE compare "$ROOT/$target-release.json" "$ROOT/$target-pgo.json" \
+        --title "$target: PGO + LTO vs release" --markdown "$REPORT" --append >/dev/null || true
+done
+
+echo "report: $REPORT"
@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+"""Heatmaps of the BM_Sweep_* parameter sweep (benchmark_resampler.cpp).
+
+Reads Google Benchmark JSON (--benchmark_out=sweep.json
+--benchmark_out_format=json). For every backend it writes one SVG per
+metric, with one taps-per-branch x block-size heatmap per rate pair
+(taps per branch at the lower rate, the same axis for every backend):
+
+    <out>/<backend>_msps.svg            MSamples/s (input samples)
+    <out>/<backend>_cycles.svg          CPU cycles per input sample
+    <out>/sweep.md                      the same numbers as markdown tables
+
+Cycles per sample come from the perf counters (cycles_per_sample) when the
+benchmark could read them, otherwise from CPU time x the nominal clock in
+the JSON context (mhz_per_cpu), which ignores turbo and frequency scaling.
+Several JSON files (e.g. benchmark_cpp and benchmark_cpp_scalar runs) can
+be given; their backends are told apart with --tag.
+
+No dependencies beyond the Python 3 standard library.
+"""
+
+import argparse
+import json
+import math
+import os
+import sys
+from collections import defaultdict
+
+TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+# Perceptually ordered colour stops (viridis), low to high
+COLOURS = [(68, 1, 84), (59, 82, 139), (33, 145, 140), (94, 201, 98), (253, 231, 37)]
+
+
+def load(path, tag):
+    with open(path) as f:
+        data = json.load(f)
+    mhz = data.get("context", {}).get("mhz_per_cpu", 0)
+    points = []
+    for b in data.get("benchmarks", []):
+        name = b.get("run_name", b["name"])
+        if not name.startswith("BM_Sweep_") or b.get("run_type", "iteration") != "iteration":
+            continue
+        if b.get("error_occurred"):
+            continue
+        backend = name.split("/")[0][len("BM_Sweep_"):]
+        if tag:
+            backend = "%s_%s" % (backend, tag)
+        block = b["block"]
+        if "cycles_per_sample" in b:
+            cycles = b["cycles_per_sample"]
+        elif mhz:
+            cpu_ns = b["cpu_time"] * TIME_UNIT_NS[b.get("time_unit", "ns")]
+            cycles = cpu_ns * mhz * 1e-3 / block
+        else:
+            cycles = float("nan")
+        points.append({
+            "backend": backend,
+            "ratio": "%d->%d" % (b["input_rate"], b["output_rate"]),
+            "taps": int(b["branch_taps"]),
+            "block": int(block),
+            "msps": b["items_per_second"] / 1e6,
+            "cycles": cycles,
+        })
+    return points
+
+
+def colour(value, low, high, higher_is_better):
+    """Colour on a log scale between low and high; bright is good"""
+    if value is None or math.isnan(value) or value <= 0 or low <= 0:
+        return "#dddddd"
+    t = 0.5 if high <= low else (math.log(value) - math.log(low)) / (math.log(high) - math.log(low))
+    if not higher_is_better:
+        t = 1.0 - t
+    t = min(1.0, max(0.0, t)) * (len(COLOURS) - 1)
+    i = min(int(t), len(COLOURS) - 2)
+    f = t - i
+    rgb = [int(round(a + (b - a) * f)) for a, b in zip(COLOURS[i], COLOURS[i + 1])]
+    return "#%02x%02x%02x" % tuple(rgb)
+
+
+def text_colour(fill):
+    r, g, b = int(fill[1:3], 16), int(fill[3:5], 16), int(fill[5:7], 16)
+    return "#000000" if 0.299 * r + 0.587 * g + 0.114 * b > 140 else "#ffffff"
+
+
+def block_label(block):
+    if block >= 1 << 20 and block % (1 << 20) == 0:
+        return "%dM" % (block >> 20)
+    if block >= 1 << 10 and block % (1 << 10) == 0:
+        return "%dk" % (block >> 10)
+    return str(block)
+
+
+def value_label(value):
+    if value is None or math.isnan(value):
+        return "-"
+    if value >= 100:
+        return "%.0f" % value
+    if value >= 10:
+        return "%.1f" % value
+    return "%.2f" % value
+
+
+def grids(points):
+    """backend -> ratio -> (taps, blocks, {(taps, block): point})"""
+    result = defaultdict(dict)
+    by_key = defaultdict(dict)
+    for p in points:
+        by_key[(p["backend"], p["ratio"])][(p["taps"], p["block"])] = p
+    for (backend, ratio), cells in by_key.items():
+        taps = sorted(set(t for t, _ in cells))
+        blocks = sorted(set(b for _, b in cells))
+        result[backend][ratio] = (taps, blocks, cells)
+    return result
+
+
+def write_svg(path, backend, ratios, metric, title, higher_is_better):
+    cell_w, cell_h = 56, 22
+    label_w, head_h = 48, 40
+    panels = list(ratios.items())
+    cols = min(4, len(panels))
+    rows = (len(panels) + cols - 1) // cols
+    sample_taps, sample_blocks, _ = panels[0][1]
+    panel_w = label_w + cell_w * len(sample_blocks) + 20
+    panel_h = head_h + cell_h * len(sample_taps) + 30
+    width, height = cols * panel_w + 20, rows * panel_h + 50
+
+    values = [c[metric] for _, (_, _, cells) in panels for c in cells.values()
+              if c[metric] is not None and not math.isnan(c[metric]) and c[metric] > 0]
+    low, high = (min(values), max(values)) if values else (1.0, 1.0)
+
+    out = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" '
+           'font-family="sans-serif" font-size="11">' % (width, height),
+           '<rect width="100%" height="100%" fill="#ffffff"/>',
+           '<text x="10" y="22" font-size="15" font-weight="bold">%s: %s</text>' % (backend, title)]
+    for n, (ratio, (taps, blocks, cells)) in enumerate(panels):
+        x0 = 10 + (n % cols) * panel_w
+        y0 = 40 + (n // cols) * panel_h
+        out.append('<text x="%d" y="%d" font-weight="bold">%s</text>' % (x0, y0 + 12, ratio))
+        for j, block in enumerate(blocks):
+            out.append('<text x="%d" y="%d" text-anchor="middle">%s</text>'
+                       % (x0 + label_w + j * cell_w + cell_w // 2, y0 + head_h - 6, block_label(block)))
+        for i, t in enumerate(taps):
+            y = y0 + head_h + i * cell_h
+            out.append('<text x="%d" y="%d" text-anchor="end">%d</text>' % (x0 + label_w - 6, y + 15, t))
+            for j, block in enumerate(blocks):
+                cell = cells.get((t, block))
+                value = cell[metric] if cell else None
+                fill = colour(value, low, high, higher_is_better)
+                x = x0 + label_w + j * cell_w
+                out.append('<rect x="%d" y="%d" width="%d" height="%d" fill="%s" stroke="#ffffff"/>'
+                           % (x, y, cell_w, cell_h, fill))
+                out.append('<text x="%d" y="%d" text-anchor="middle" fill="%s">%s</text>'
+                           % (x + cell_w // 2, y + 15, text_colour(fill), value_label(value)))
+        out.append('<text x="%d" y="%d" fill="#555555">rows: taps per branch, columns: block (samples)</text>'
+                   % (x0, y0 + head_h + len(taps) * cell_h + 16))
+    out.append('</svg>')
+    with open(path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def markdown(all_grids):
+    lines = ["# Parameter sweep", ""]
+    for metric, title in (("msps", "MSamples/s"), ("cycles", "Cycles per input sample")):
+        lines += ["## %s" % title, ""]
+        for backend in sorted(all_grids):
+            for ratio, (taps, blocks, cells) in all_grids[backend].items():
+                lines.append("### %s, %s" % (backend, ratio))
+                lines.append("")
+                lines.append("| taps/branch | " + " | ".join(block_label(b) for b in blocks) + " |")
+                lines.append("|---:|" + "---:|" * len(blocks))
+                for t in taps:
+                    row = [value_label(cells[(t, b)][metric]) if (t, b) in cells else "-" for b in blocks]
+                    lines.append("| %d | %s |" % (t, " | ".join(row)))
+                lines.append("")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("json", nargs="+", help="Google Benchmark JSON output")
+    parser.add_argument("--tag", action="append", default=[],
+                        help="suffix for the backends of each JSON file, in order (e.g. simd, scalar)")
+    parser.add_argument("--out", default="sweep", help="output directory (default: sweep)")
+    args = parser.parse_args()
+
+    points = []
+    for n, path in enumerate(args.json):
+        points += load(path, args.tag[n] if n < len(args.tag) else "")
+    if not points:
+        sys.exit("no BM_Sweep_* results (run the benchmark with IQ_SWEEP=1)")
+
+    os.makedirs(args.out, exist_ok=True)
+    all_grids = grids(points)
+    for backend, ratios in sorted(all_grids.items()):
+        write_svg(os.path.join(args.out, "%s_msps.svg" % backend), backend, ratios,
+                  "msps", "MSamples/s (input)", True)
+        write_svg(os.path.join(args.out, "%s_cycles.svg" % backend), backend, ratios,
+                  "cycles", "cycles per input sample", False)
+    with open(os.path.join(args.out, "sweep.md"), "w") as f:
+        f.write(markdown(all_grids))
+
+    print("%d results, %d backends -> %s/" % (len(points), len(all_grids), args.out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,449 @@
+#include <gtest/gtest.h>
+#include "iq_arena.h"
+#include "iq_resampler_cpp.h"
+#include "iq_ring_buffer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// AddressSanitizer aborts on an impossible allocation instead of failing it
+// (unless allocator_may_return_null=1), so those checks are skipped there
+#if defined(__SANITIZE_ADDRESS__)
+#define IQ_TEST_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define IQ_TEST_ASAN 1
+#endif
+#endif
+
+// Allocation-counting hook: every operator new in this test binary goes
+// through here, so a test can assert that a stretch of code made no heap
+// allocations at all
+static std::atomic<size_t> g_allocations(0);
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// Counts the allocations made while it is alive
+class AllocationCounter {
+public:
+    AllocationCounter() : start_(g_allocations.load()) {}
+    size_t count() const { return g_allocations.load() - start_; }
+
+private:
+    size_t start_;
+};
+
+// Test fixture for arena and steady-state allocation tests
+class IQArenaTest : public ::testing::Test {
+protected:
+    const int INPUT_RATE = 120000;
+    const int OUTPUT_RATE = 100000;
+
+    std::vector<std::complex<float> > generateTestSignal(int numSamples, float sampleRate, float frequency) {
+        std::vector<std::complex<float> > signal(numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            double phase = 2.0 * M_PI * frequency * i / sampleRate;
+            signal[i] = std::complex<float>(std::cos(phase), std::sin(phase));
+        }
+        return signal;
+    }
+};
+
+// Test: The hook sees allocations
+TEST_F(IQArenaTest, CounterSeesAllocations) {
+    AllocationCounter counter;
+    std::vector<float> v(10);
+    EXPECT_EQ(counter.count(), 1u);
+
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE);
+    std::vector<float> input(200, 0.0f);
+    size_t before = counter.count();
+    resampler.process(input);  // The returned vector
+    EXPECT_GT(counter.count(), before);
+}
+
+// Test: Buffers are cache-line aligned and carved from one block
+TEST_F(IQArenaTest, AlignedBumpAllocation) {
+    IQArena arena(1000);
+    EXPECT_EQ(arena.capacity(), 1024u);
+
+    AllocationCounter counter;
+    float* a = arena.allocate<float>(3);
+    std::complex<float>* b = arena.allocate<std::complex<float> >(17);
+    int16_t* c = arena.allocate<int16_t>(1);
+    EXPECT_EQ(counter.count(), 0u);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % IQArena::ALIGNMENT, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % IQArena::ALIGNMENT, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % IQArena::ALIGNMENT, 0u);
+    EXPECT_EQ(arena.used(), IQArena::bytesFor<float>(3) + IQArena::bytesFor<std::complex<float> >(17) +
+                            IQArena::bytesFor<int16_t>(1));
+
+    // Exhausted block throws rather than growing
+    EXPECT_THROW(arena.allocate<float>(1000), std::bad_alloc);
+
+    arena.release();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.allocate<float>(3), a);
+}
+
+// Test: Moving hands the block over in place; a failed reset keeps the old one
+TEST_F(IQArenaTest, MoveAndFailedReset) {
+    IQArena arena(1000);
+    float* a = arena.allocate<float>(8);
+    a[7] = 3.0f;
+
+    IQArena moved(std::move(arena));
+    EXPECT_EQ(arena.capacity(), 0u);
+    EXPECT_EQ(moved.capacity(), 1024u);
+    EXPECT_EQ(moved.used(), IQArena::bytesFor<float>(8));
+    EXPECT_EQ(a[7], 3.0f);
+
+    IQArena assigned(64);
+    assigned = std::move(moved);
+    EXPECT_EQ(moved.capacity(), 0u);
+    EXPECT_EQ(assigned.capacity(), 1024u);
+
+#ifndef IQ_TEST_ASAN
+    EXPECT_THROW(assigned.reset((size_t)1 << 62), std::bad_alloc);
+#endif
+    EXPECT_EQ(assigned.capacity(), 1024u);
+    EXPECT_EQ(assigned.used(), IQArena::bytesFor<float>(8));
+    EXPECT_EQ(a[7], 3.0f);
+}
+
+// Test: Resamplers stay movable, mid-stream and inside a growing vector
+TEST_F(IQArenaTest, ResamplerMoves) {
+    auto input = generateTestSignal(4000, INPUT_RATE, 10000.0f);
+    IQResamplerCPP reference(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP first(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    reference.reserve(2000);
+    first.reserve(2000);
+    std::vector<std::complex<float> > expected(2000);
+    std::vector<std::complex<float> > output(2000);
+
+    size_t n = reference.process(input.data(), 2000, expected.data(), expected.size());
+    ASSERT_EQ(first.process(input.data(), 2000, output.data(), output.size()), n);
+
+    IQResamplerCPP second(std::move(first));
+    n = reference.process(input.data() + 2000, 2000, expected.data(), expected.size());
+    ASSERT_EQ(second.process(input.data() + 2000, 2000, output.data(), output.size()), n);
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_EQ(output[i], expected[i]);
+    }
+    EXPECT_EQ(second.telemetry().snapshot().inputSamples,
+              IQTelemetry::ENABLED ? 4000u : 0u);
+
+    std::vector<IQResamplerCPP> bank;
+    for (int i = 0; i < 9; i++) {
+        bank.push_back(IQResamplerCPP(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase));
+        bank.back().reserve(1000);
+    }
+    IQResamplerCPP fresh(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    n = fresh.process(input.data(), 1000, expected.data(), expected.size());
+    for (size_t r = 0; r < bank.size(); r++) {
+        ASSERT_EQ(bank[r].process(input.data(), 1000, output.data(), output.size()), n);
+        EXPECT_EQ(output[n - 1], expected[n - 1]) << r;
+    }
+}
+
+// Test: Resamplers copy mid-stream into their own arena, FFT engine included
+TEST_F(IQArenaTest, ResamplerCopies) {
+    static_assert(std::is_nothrow_move_constructible<IQResamplerCPP>::value,
+                  "vector growth must move, not copy");
+    auto input = generateTestSignal(4000, INPUT_RATE, 10000.0f);
+
+    for (auto mode : {IQResamplerCPP::Mode::Linear, IQResamplerCPP::Mode::Polyphase,
+                      IQResamplerCPP::Mode::PolyphaseFFT}) {
+        IQResamplerCPP original(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        original.reserve(2000);
+        std::vector<std::complex<float> > expected(2000);
+        std::vector<std::complex<float> > output(2000);
+        original.process(input.data(), 2000, output.data(), output.size());
+
+        IQResamplerCPP copy(original);
+        EXPECT_NE(copy.arena().used(), 0u);
+        EXPECT_EQ(copy.maxBlockSamples(), 2000u);
+        EXPECT_EQ(copy.usesFFT(), original.usesFFT());
+
+        size_t n = original.process(input.data() + 2000, 2000, expected.data(), expected.size());
+        ASSERT_EQ(copy.process(input.data() + 2000, 2000, output.data(), output.size()), n);
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_EQ(output[i], expected[i]);
+        }
+
+        // Assignment replaces the target's stream with the source's
+        IQResamplerCPP assigned(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        assigned = original;
+        n = original.process(input.data(), 1000, expected.data(), expected.size());
+        ASSERT_EQ(assigned.process(input.data(), 1000, output.data(), output.size()), n);
+        EXPECT_EQ(output[n - 1], expected[n - 1]);
+    }
+}
+
+// Test: Huge pages fall back to ordinary memory when none are available
+TEST_F(IQArenaTest, HugePagesFallBack) {
+    IQArena arena(3 * 1024 * 1024, true);
+    ASSERT_GE(arena.capacity(), 3u * 1024 * 1024);
+
+    // Usable either way, explicit huge pages or not
+    std::complex<float>* p = arena.allocate<std::complex<float> >(arena.capacity() / sizeof(std::complex<float>));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % IQArena::ALIGNMENT, 0u);
+    for (size_t i = 0; i < arena.capacity() / sizeof(std::complex<float>); i += 1024) {
+        p[i] = std::complex<float>((float)i, 0.0f);
+    }
+    EXPECT_EQ(p[2048].real(), 2048.0f);
+
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP reference(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    resampler.reserve(4096, true);
+    auto input = generateTestSignal(4096, INPUT_RATE, 10000.0f);
+    std::vector<std::complex<float> > output(4000);
+    std::vector<std::complex<float> > expected(4000);
+    size_t produced = resampler.process(input.data(), input.size(), output.data(), output.size());
+    ASSERT_EQ(reference.process(input.data(), input.size(), expected.data(), expected.size()), produced);
+    for (size_t i = 0; i < produced; i++) {
+        EXPECT_EQ(output[i], expected[i]);
+    }
+}
+
+// Test: NUMA placement binds where it can and degrades gracefully
+TEST_F(IQArenaTest, NumaPlacement) {
+    EXPECT_GE(IQArena::numaNodeCount(), 1);
+
+    // Local node: on the node the allocating thread runs on, when the
+    // kernel reports both
+    IQArena local(1 << 20, IQMemoryPolicy(false, IQMemoryPolicy::LOCAL_NODE));
+    ASSERT_GE(local.capacity(), 1u << 20);
+    int node = IQArena::currentNumaNode();
+    if (node >= 0 && local.numaNode() >= 0) {
+        EXPECT_EQ(local.numaNode(), node);
+    }
+
+    // Every node that exists can be asked for explicitly
+    for (int n = 0; n < IQArena::numaNodeCount(); n++) {
+        IQArena placed(1 << 16, IQMemoryPolicy(false, n));
+        float* p = placed.allocate<float>(1000);
+        p[999] = 1.0f;
+        EXPECT_EQ(p[999], 1.0f);
+    }
+
+    // A node that does not exist still yields usable memory
+    IQArena missing(1 << 16, IQMemoryPolicy(true, 1000));
+    float* p = missing.allocate<float>(1000);
+    p[0] = 2.0f;
+    EXPECT_EQ(p[0], 2.0f);
+    EXPECT_EQ(missing.policy().numaNode, 1000);
+
+    // A block over the policy's budget is refused, leaving the arena as it was
+    IQArena budgeted(4096, IQMemoryPolicy(false, IQMemoryPolicy::ANY_NODE, 4096));
+    EXPECT_THROW(budgeted.reset(4097, budgeted.policy()), std::bad_alloc);
+    EXPECT_EQ(budgeted.capacity(), 4096u);
+    EXPECT_THROW(IQArena(8192, IQMemoryPolicy(false, IQMemoryPolicy::ANY_NODE, 4096)), std::bad_alloc);
+
+    // Mapped blocks come back zeroed
+    IQArena zeroed(4096, IQMemoryPolicy(false, IQMemoryPolicy::LOCAL_NODE));
+    const unsigned char* bytes = zeroed.allocate<unsigned char>(4096);
+    for (size_t i = 0; i < 4096; i++) {
+        ASSERT_EQ(bytes[i], 0);
+    }
+
+    // The resampler places its scratch per policy with unchanged output
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP reference(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    resampler.reserve(2048, IQMemoryPolicy(true, IQMemoryPolicy::LOCAL_NODE));
+    EXPECT_EQ(resampler.arena().policy().numaNode, IQMemoryPolicy::LOCAL_NODE);
+    auto input = generateTestSignal(3000, INPUT_RATE, 10000.0f);
+    std::vector<std::complex<float> > output(2600);
+    std::vector<std::complex<float> > expected(2600);
+    size_t produced = resampler.process(input.data(), input.size(), output.data(), output.size());
+    ASSERT_EQ(reference.process(input.data(), input.size(), expected.data(), expected.size()), produced);
+    for (size_t i = 0; i < produced; i++) {
+        EXPECT_EQ(output[i], expected[i]);
+    }
+}
+
+// Test: A placing reserve() mid-stream moves history, pull overflow and
+// the FFT engine's buffers; output is unchanged (FFT frames move with the
+// new block size, so that path only to rounding)
+TEST_F(IQArenaTest, ReserveMidStreamKeepsState) {
+    std::vector<IQResamplerCPP::Mode> modes = {
+        IQResamplerCPP::Mode::Linear,
+        IQResamplerCPP::Mode::PolyphaseDirect,
+        IQResamplerCPP::Mode::PolyphaseFFT
+    };
+    const IQMemoryPolicy policy(true, IQMemoryPolicy::LOCAL_NODE);
+    auto input = generateTestSignal(3000, INPUT_RATE, 10000.0f);
+
+    for (auto mode : modes) {
+        IQResamplerCPP placed(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        IQResamplerCPP reference(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        std::vector<std::complex<float> > output(placed.maxOutputSamplesFor(input.size()));
+        std::vector<std::complex<float> > expected(output.size());
+
+        size_t produced = placed.process(input.data(), 1000, output.data(), output.size());
+        placed.reserve(1500, policy);
+        EXPECT_EQ(placed.arena().policy().numaNode, IQMemoryPolicy::LOCAL_NODE);
+        produced += placed.process(input.data() + 1000, 2000, output.data() + produced, output.size() - produced);
+        ASSERT_EQ(reference.process(input.data(), input.size(), expected.data(), expected.size()), produced);
+        for (size_t i = 0; i < produced; i++) {
+            EXPECT_NEAR(std::abs(output[i] - expected[i]), 0.0f, 1e-5f);
+        }
+    }
+
+    // Pull: an odd request leaves overflow behind, which survives reserve()
+    IQResamplerCPP puller(INPUT_RATE, 130000, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP reference(INPUT_RATE, 130000, 127, IQResamplerCPP::Mode::Polyphase);
+    size_t offset = 0;
+    puller.setInputSource([&](std::complex<float>* dst, size_t n) {
+        n = std::min(n, input.size() - offset);
+        std::copy(input.begin() + offset, input.begin() + offset + n, dst);
+        offset += n;
+        return n;
+    }, 64);
+    std::vector<std::complex<float> > pulled(2000);
+    ASSERT_EQ(puller.pull(pulled.data(), 777), 777u);
+    puller.reserve(512, policy);
+    ASSERT_EQ(puller.pull(pulled.data() + 777, 1223), 1223u);
+    std::vector<std::complex<float> > expected(reference.maxOutputSamplesFor(input.size()));
+    ASSERT_GE(reference.process(input.data(), input.size(), expected.data(), expected.size()), 2000u);
+    for (size_t i = 0; i < pulled.size(); i++) {
+        EXPECT_EQ(pulled[i], expected[i]);
+    }
+
+    // The engine itself places its spectra and history
+    IQResamplerFFT engine(INPUT_RATE, OUTPUT_RATE, 127);
+    engine.reserve(256, policy);
+    EXPECT_TRUE(engine.arena().policy().hugePages);
+    EXPECT_THROW(engine.reserve(0), std::invalid_argument);
+}
+
+// Test: Blocks longer than the reserved size are split with identical output
+TEST_F(IQArenaTest, LongBlocksSplit) {
+    std::vector<IQResamplerCPP::Mode> modes = {
+        IQResamplerCPP::Mode::Linear,
+        IQResamplerCPP::Mode::Polyphase,
+        IQResamplerCPP::Mode::PolyphaseFFT
+    };
+    auto input = generateTestSignal(5000, INPUT_RATE, 10000.0f);
+
+    for (auto mode : modes) {
+        IQResamplerCPP small(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        IQResamplerCPP large(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        small.reserve(97);
+        EXPECT_EQ(small.maxBlockSamples(), 97u);
+        EXPECT_EQ(large.maxBlockSamples(), IQResamplerCPP::DEFAULT_MAX_BLOCK_SAMPLES);
+
+        std::vector<std::complex<float> > output(small.outputSamplesFor(input.size()));
+        std::vector<std::complex<float> > expected(output.size());
+        ASSERT_EQ(small.process(input.data(), input.size(), output.data(), output.size()), output.size());
+        ASSERT_EQ(large.process(input.data(), input.size(), expected.data(), expected.size()), output.size());
+        for (size_t i = 0; i < output.size(); i++) {
+            EXPECT_NEAR(std::abs(output[i] - expected[i]), 0.0f, 1e-5f);
+        }
+    }
+    EXPECT_THROW(IQResamplerCPP(INPUT_RATE, OUTPUT_RATE).reserve(0), std::invalid_argument);
+}
+
+// Test: Steady-state processing makes no heap allocations
+TEST_F(IQArenaTest, SteadyStateDoesNotAllocate) {
+    struct TestCase {
+        int inputRate;
+        int outputRate;
+        IQResamplerCPP::Mode mode;
+    };
+
+    std::vector<TestCase> testCases = {
+        {120000, 100000, IQResamplerCPP::Mode::Linear},
+        {120000, 100000, IQResamplerCPP::Mode::Polyphase},
+        {120000, 100000, IQResamplerCPP::Mode::PolyphaseFFT},
+        {120000, 100000, IQResamplerCPP::Mode::LowLatency},
+        {100000, 50000, IQResamplerCPP::Mode::PolyphaseDirect},  // Symmetric folding
+        {30000, 100000, IQResamplerCPP::Mode::Polyphase}
+    };
+    auto input = generateTestSignal(20000, INPUT_RATE, 10000.0f);
+    std::vector<std::complex<float> > output(70000);
+    const size_t blockSizes[] = {1, 480, 1200, 8192, 20000};
+
+    for (const auto& tc : testCases) {
+        IQResamplerCPP resampler(tc.inputRate, tc.outputRate, 127, tc.mode);
+
+        AllocationCounter counter;
+        for (int pass = 0; pass < 3; pass++) {
+            for (size_t n : blockSizes) {
+                resampler.process(input.data(), n, output.data(), output.size());
+            }
+        }
+        resampler.flush(output.data(), output.size());
+        resampler.prime(input.data(), 300);
+        resampler.process(input.data(), 1200, output.data(), output.size());
+        EXPECT_EQ(counter.count(), 0u) << tc.inputRate << " to " << tc.outputRate;
+    }
+}
+
+// Test: Pull, bursts and tags do not allocate once set up
+TEST_F(IQArenaTest, StreamingApisDoNotAllocate) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQRingBuffer ring(4096);
+    resampler.setInputSource(ring, 256);
+
+    auto input = generateTestSignal(2000, INPUT_RATE, 10000.0f);
+    std::vector<std::complex<float> > output(4000);
+    std::vector<IQBurst> bursts = {
+        IQBurst(input.data(), 200, 1),
+        IQBurst(input.data() + 200, 1800, 2)
+    };
+    std::vector<IQBurstOutput> results(bursts.size());
+    IQOutputTag tags[4];
+
+    AllocationCounter counter;
+    for (int pass = 0; pass < 5; pass++) {
+        ring.write(input.data(), 2000);
+        resampler.pull(output.data(), 1000);
+        resampler.addTag(resampler.inputPosition(), pass);
+        resampler.pull(output.data(), 600);
+        resampler.takeTags(tags, 4);
+    }
+    resampler.processBursts(bursts.data(), bursts.size(), output.data(), output.size(), results.data());
+    EXPECT_EQ(counter.count(), 0u);
+}
+
+// Main function
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
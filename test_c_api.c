@@ -0,0 +1,56 @@
+/* C caller of the resampler library, compiled as C so the header is
+ * checked as a C interface (used by test_c_api_gtest.cpp) */
+#include "iq_resampler_c.h"
+#include <math.h>
+#include <stdlib.h>
+
+/* Stream `blocks` blocks of `block` samples of a tone through a new
+ * resampler with a filter_taps-tap prototype, then flush. Returns the total number of output samples, or
+ * a negative iq_status_t on failure. */
+long iq_c_api_stream(int input_rate, int output_rate, int filter_taps, iq_backend_t backend, size_t block,
+                     int blocks) {
+    iq_resampler_t* resampler = NULL;
+    iq_status_t status = iq_resampler_create(&resampler, input_rate, output_rate, filter_taps, backend);
+    if (status != IQ_OK) {
+        return status;
+    }
+
+    size_t capacity = iq_resampler_output_samples_for(resampler, block) + 1;
+    if (iq_resampler_flush_samples(resampler) > capacity) {
+        capacity = iq_resampler_flush_samples(resampler);
+    }
+    float* input = (float*)malloc(2 * block * sizeof(float));
+    float* output = (float*)malloc(2 * capacity * sizeof(float));
+    long total = 0;
+    if (!input || !output) {
+        total = IQ_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    for (int b = 0; b < blocks; b++) {
+        for (size_t i = 0; i < block; i++) {
+            double phase = 0.01 * (double)((size_t)b * block + i);
+            input[2 * i] = (float)cos(phase);
+            input[2 * i + 1] = (float)sin(phase);
+        }
+        size_t produced = 0;
+        status = iq_resampler_process(resampler, input, block, output, capacity, &produced);
+        if (status != IQ_OK) {
+            total = status;
+            goto done;
+        }
+        total += (long)produced;
+    }
+
+    {
+        size_t produced = 0;
+        status = iq_resampler_flush(resampler, output, capacity, &produced);
+        total = (status == IQ_OK) ? total + (long)produced : status;
+    }
+
+done:
+    free(input);
+    free(output);
+    iq_resampler_destroy(resampler);
+    return total;
+}
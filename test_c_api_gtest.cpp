@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "iq_resampler_c.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" long iq_c_api_stream(int input_rate, int output_rate, int filter_taps, iq_backend_t backend,
+                                size_t block, int blocks);
+
+// Test fixture for the C API (libiqresampler)
+class IQResamplerCApiTest : public ::testing::Test {
+protected:
+    const int INPUT_RATE = 120000;
+    const int OUTPUT_RATE = 100000;
+
+    std::vector<float> generateTestSignal(size_t numSamples, size_t offset = 0) {
+        std::vector<float> signal(numSamples * 2);
+        for (size_t i = 0; i < numSamples; i++) {
+            double phase = 2.0 * M_PI * 1000.0 * (offset + i) / INPUT_RATE;
+            signal[i * 2] = (float)std::cos(phase);
+            signal[i * 2 + 1] = (float)std::sin(phase);
+        }
+        return signal;
+    }
+
+    // Whole stream in blocks of blockSize, flush included
+    std::vector<float> runStream(iq_backend_t backend, const std::vector<float>& input, size_t blockSize) {
+        iq_resampler_t* r = nullptr;
+        EXPECT_EQ(iq_resampler_create(&r, INPUT_RATE, OUTPUT_RATE, 127, backend), IQ_OK);
+        std::vector<float> result;
+        if (!r) {
+            return result;
+        }
+        size_t numInput = input.size() / 2;
+        for (size_t pos = 0; pos < numInput; pos += blockSize) {
+            size_t n = std::min(blockSize, numInput - pos);
+            std::vector<float> out(2 * iq_resampler_output_samples_for(r, n));
+            size_t produced = 0;
+            EXPECT_EQ(iq_resampler_process(r, &input[2 * pos], n, out.data(), out.size() / 2, &produced), IQ_OK);
+            result.insert(result.end(), out.begin(), out.begin() + 2 * produced);
+        }
+        std::vector<float> tail(2 * iq_resampler_flush_samples(r));
+        size_t produced = 0;
+        EXPECT_EQ(iq_resampler_flush(r, tail.data(), tail.size() / 2, &produced), IQ_OK);
+        result.insert(result.end(), tail.begin(), tail.begin() + 2 * produced);
+        iq_resampler_destroy(r);
+        return result;
+    }
+};
+
+// Test: Block size does not change the output of any C++ backend
+TEST_F(IQResamplerCApiTest, BlockSizeInvariant) {
+    auto input = generateTestSignal(6000);
+    for (int b = IQ_BACKEND_LINEAR; b <= IQ_BACKEND_LOW_LATENCY; b++) {
+        iq_backend_t backend = (iq_backend_t)b;
+        auto whole = runStream(backend, input, input.size() / 2);
+        auto blocks = runStream(backend, input, 333);
+        ASSERT_EQ(whole.size(), blocks.size()) << iq_backend_name(backend);
+        ASSERT_GT(whole.size(), 0u);
+        for (size_t i = 0; i < whole.size(); i++) {
+            ASSERT_NEAR(whole[i], blocks[i], 1e-4f) << iq_backend_name(backend) << " at " << i;
+        }
+        // 6000 inputs at 5/6, plus the tail flushed out of the filter delay
+        EXPECT_GE(whole.size() / 2, 4999u) << iq_backend_name(backend);
+        EXPECT_LE(whole.size() / 2, 5000u + 127u) << iq_backend_name(backend);
+    }
+}
+
+// Test: reset() starts a new stream with the same output
+TEST_F(IQResamplerCApiTest, ResetStartsNewStream) {
+    iq_resampler_t* r = nullptr;
+    ASSERT_EQ(iq_resampler_create(&r, INPUT_RATE, OUTPUT_RATE, 127, IQ_BACKEND_POLYPHASE), IQ_OK);
+    ASSERT_EQ(iq_resampler_reserve(r, 1200), IQ_OK);
+    auto input = generateTestSignal(1200);
+    std::vector<float> first(2 * iq_resampler_output_samples_for(r, 1200));
+    std::vector<float> second(first.size());
+    size_t n1 = 0, n2 = 0;
+
+    ASSERT_EQ(iq_resampler_process(r, input.data(), 1200, first.data(), first.size() / 2, &n1), IQ_OK);
+    ASSERT_EQ(iq_resampler_reset(r), IQ_OK);
+    ASSERT_EQ(iq_resampler_process(r, input.data(), 1200, second.data(), second.size() / 2, &n2), IQ_OK);
+    EXPECT_EQ(n1, n2);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(iq_resampler_backend(r), IQ_BACKEND_POLYPHASE);
+    EXPECT_GT(iq_resampler_group_delay(r), 0.0);
+    iq_resampler_destroy(r);
+}
+
+// Test: Failures come back as status codes with a message
+TEST_F(IQResamplerCApiTest, ReportsErrors) {
+    iq_resampler_t* r = reinterpret_cast<iq_resampler_t*>(this);
+    EXPECT_EQ(iq_resampler_create(&r, 0, OUTPUT_RATE, 127, IQ_BACKEND_POLYPHASE), IQ_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(r, nullptr);
+    EXPECT_GT(std::strlen(iq_last_error()), 0u);
+    EXPECT_EQ(iq_resampler_create(nullptr, INPUT_RATE, OUTPUT_RATE, 127, IQ_BACKEND_POLYPHASE),
+              IQ_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(iq_resampler_create(&r, INPUT_RATE, OUTPUT_RATE, 127, (iq_backend_t)42), IQ_ERROR_INVALID_ARGUMENT);
+    if (!iq_backend_available(IQ_BACKEND_IPP)) {
+        EXPECT_EQ(iq_resampler_create(&r, INPUT_RATE, OUTPUT_RATE, 127, IQ_BACKEND_IPP), IQ_ERROR_UNSUPPORTED);
+    }
+
+    ASSERT_EQ(iq_resampler_create(&r, INPUT_RATE, OUTPUT_RATE, 127, IQ_BACKEND_POLYPHASE), IQ_OK);
+    auto input = generateTestSignal(1200);
+    std::vector<float> out(2);
+    size_t produced = 99;
+    EXPECT_EQ(iq_resampler_process(r, input.data(), 1200, out.data(), 1, &produced), IQ_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_EQ(produced, 0u);
+    EXPECT_EQ(iq_resampler_process(r, nullptr, 1200, out.data(), 1, &produced), IQ_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(iq_resampler_process(nullptr, input.data(), 1200, out.data(), 1, &produced),
+              IQ_ERROR_INVALID_ARGUMENT);
+    EXPECT_STREQ(iq_status_string(IQ_ERROR_BUFFER_TOO_SMALL), "buffer too small");
+    iq_resampler_destroy(r);
+    iq_resampler_destroy(nullptr);
+}
+
+// Test: Backends can be picked by name at runtime
+TEST_F(IQResamplerCApiTest, BackendNames) {
+    for (int b = IQ_BACKEND_LINEAR; b <= IQ_BACKEND_IPP; b++) {
+        EXPECT_EQ(iq_backend_from_name(iq_backend_name((iq_backend_t)b)), b);
+    }
+    EXPECT_EQ(iq_backend_from_name("fft"), -1);
+    EXPECT_EQ(iq_backend_from_name(nullptr), -1);
+    EXPECT_TRUE(iq_backend_available(IQ_BACKEND_POLYPHASE));
+    EXPECT_FALSE(iq_backend_available((iq_backend_t)-1));
+}
+
+// Test: The loaded library reports the ABI version of the header
+TEST_F(IQResamplerCApiTest, AbiVersion) {
+    EXPECT_EQ(iq_resampler_abi_version(), IQ_RESAMPLER_ABI_VERSION);
+    EXPECT_EQ(iq_resampler_abi_version() / 10000, IQ_RESAMPLER_ABI_MAJOR);
+}
+
+// Test: A plain C caller streams through the shared library
+TEST_F(IQResamplerCApiTest, StreamFromC) {
+    int taps = iq_minimum_filter_taps(48000, 44100);
+    EXPECT_EQ(taps, 8 * 160);
+    long total = iq_c_api_stream(48000, 44100, taps, IQ_BACKEND_POLYPHASE, 480, 100);
+    ASSERT_GT(total, 0);
+    // One second of input, plus the tail flushed out of the filter delay
+    EXPECT_GE(total, 44099);
+    EXPECT_LE(total, 44100 + taps / 147 + 1);
+    EXPECT_EQ(iq_c_api_stream(48000, 44100, taps, (iq_backend_t)42, 480, 1), IQ_ERROR_INVALID_ARGUMENT);
+
+    // 127 taps leave most of the 147 branches of 48k -> 44.1k empty
+    EXPECT_EQ(iq_c_api_stream(48000, 44100, 127, IQ_BACKEND_POLYPHASE, 480, 1), IQ_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(iq_minimum_filter_taps(0, 44100), 0);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "iq_filter_design.h"
+#include "iq_resampler_cpp.h"
+#include <cmath>
+#include <complex>
+#include <vector>
+
+// Test fixture for spec-driven filter design tests
+class IQFilterDesignTest : public ::testing::Test {
+protected:
+    // Helper function to generate a test signal with known frequency
+    std::vector<float> generateTestSignal(int numSamples, float sampleRate, float frequency) {
+        std::vector<float> signal(numSamples * 2);
+
+        for (int i = 0; i < numSamples; i++) {
+            double phase = 2.0 * M_PI * frequency * i / sampleRate;
+            signal[i * 2] = std::cos(phase);      // I
+            signal[i * 2 + 1] = std::sin(phase);  // Q
+        }
+
+        return signal;
+    }
+
+    // Amplitude of a complex tone in an IQ signal (skipping the filter warm-up)
+    double toneAmplitude(const std::vector<float>& signal, float sampleRate, float frequency,
+                         size_t skip) {
+        std::complex<double> sum(0.0, 0.0);
+        size_t count = 0;
+        for (size_t i = skip; i < signal.size() / 2; i++) {
+            double phase = -2.0 * M_PI * frequency * i / sampleRate;
+            sum += std::complex<double>(signal[i * 2], signal[i * 2 + 1]) *
+                   std::complex<double>(std::cos(phase), std::sin(phase));
+            count++;
+        }
+        return std::abs(sum) / count;
+    }
+};
+
+// Test: Designed prototypes meet spec across ratios and specs
+TEST_F(IQFilterDesignTest, KaiserMeetsSpec) {
+    struct TestCase {
+        int upFactor;
+        int downFactor;
+        IQFilterSpec spec;
+    };
+
+    std::vector<TestCase> testCases = {
+        {5, 6, IQFilterSpec(0.8, 80.0, 0.1)},      // 120k -> 100k
+        {5, 6, IQFilterSpec(0.9, 100.0, 0.01)},
+        {147, 160, IQFilterSpec(0.8, 70.0, 0.1)},  // 48k -> 44.1k
+        {1, 2, IQFilterSpec(0.5, 60.0, 0.5)},      // 2:1 decimation
+        {3, 1, IQFilterSpec(0.8, 90.0, 0.05)}      // 1:3 interpolation
+    };
+
+    for (const auto& tc : testCases) {
+        auto taps = IQFilterDesign::kaiser(tc.upFactor, tc.downFactor, tc.spec);
+        auto response = IQFilterDesign::response(taps, tc.upFactor, tc.downFactor, tc.spec);
+
+        EXPECT_TRUE(response.meetsSpec) << tc.upFactor << "/" << tc.downFactor;
+        EXPECT_LE(response.passbandRippleDb, tc.spec.passbandRippleDb);
+        EXPECT_GE(response.stopbandAttenuationDb, tc.spec.stopbandAttenuationDb);
+        EXPECT_EQ(taps.size() % tc.upFactor, 0u) << "Branches should be fully used";
+
+        // Unity DC gain
+        double sum = 0.0;
+        for (float t : taps) {
+            sum += t;
+        }
+        EXPECT_NEAR(sum, 1.0, 1e-5);
+    }
+}
+
+// Test: One tap fewer per branch no longer meets spec
+TEST_F(IQFilterDesignTest, MinimumBranchLength) {
+    IQFilterSpec spec(0.8, 80.0, 0.1);
+    auto taps = IQFilterDesign::kaiser(5, 6, spec);
+    int branchLen = (int)taps.size() / 5;
+
+    auto shorter = IQFilterDesign::kaiser(5, 6, spec, 5 * (branchLen - 1));
+    EXPECT_FALSE(IQFilterDesign::response(shorter, 5, 6, spec).meetsSpec);
+
+    // Tighter spec needs longer branches
+    auto tighter = IQFilterDesign::kaiser(5, 6, IQFilterSpec(0.9, 100.0, 0.01));
+    EXPECT_GT(tighter.size(), taps.size());
+}
+
+// Test: Response reports band edges in Hz and a full magnitude curve
+TEST_F(IQFilterDesignTest, ResponseGrid) {
+    IQFilterSpec spec(0.8, 80.0, 0.1);
+    IQResamplerCPP resampler(120000, 100000, spec);
+    auto response = resampler.filterResponse(spec);
+
+    // Narrower Nyquist band is 50 kHz: passband to 40 kHz, stopband from 60 kHz
+    EXPECT_NEAR(response.passbandEdgeHz, 40000.0, 1e-6);
+    EXPECT_NEAR(response.stopbandEdgeHz, 60000.0, 1e-6);
+    EXPECT_TRUE(response.meetsSpec);
+
+    ASSERT_EQ(response.frequencyHz.size(), response.magnitudeDb.size());
+    EXPECT_DOUBLE_EQ(response.frequencyHz.front(), 0.0);
+    EXPECT_NEAR(response.frequencyHz.back(), 5 * 120000 / 2.0, 1e-6);
+    EXPECT_NEAR(response.magnitudeDb.front(), 0.0, 1e-4);
+}
+
+// Test: The default Hamming prototype is reported as missing a strict spec
+TEST_F(IQFilterDesignTest, DefaultFilterAgainstStrictSpec) {
+    IQResamplerCPP resampler(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    auto response = resampler.filterResponse(IQFilterSpec(0.8, 80.0, 0.1));
+
+    EXPECT_FALSE(response.meetsSpec);
+    EXPECT_LT(response.stopbandAttenuationDb, 80.0);
+}
+
+// Test: The filterTaps prototype of the resamplers is the shared Hamming design
+TEST_F(IQFilterDesignTest, HammingPrototype) {
+    EXPECT_EQ(IQFilterDesign::gcd(120000, 100000), 20000);
+    EXPECT_EQ(IQFilterDesign::gcd(48000, 44100), 300);
+
+    auto taps = IQFilterDesign::hamming(5, 6, 127);
+    ASSERT_EQ(taps.size(), 127u);
+    double sum = 0.0;
+    for (int i = 0; i < 127; i++) {
+        EXPECT_NEAR(taps[i], taps[126 - i], 1e-15);
+        sum += taps[i];
+    }
+    EXPECT_NEAR(sum, 1.0, 1e-12);
+
+    IQResamplerCPP resampler(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    const auto& filter = resampler.filterCoefficients();
+    ASSERT_EQ(filter.size(), taps.size());
+    for (size_t i = 0; i < taps.size(); i++) {
+        EXPECT_EQ(filter[i], (float)taps[i]);
+    }
+}
+
+// Test: Spec-driven resampler passes the passband and rejects aliases
+TEST_F(IQFilterDesignTest, ResamplerRejectsAliases) {
+    const int inputRate = 100000;
+    const int outputRate = 50000;
+    IQFilterSpec spec(0.8, 80.0, 0.1);
+
+    // Passband to 20 kHz, stopband from 30 kHz
+    IQResamplerCPP inBand(inputRate, outputRate, spec);
+    auto output = inBand.process(generateTestSignal(20000, inputRate, 10000.0f));
+    size_t skip = inBand.branchTaps();
+    EXPECT_NEAR(toneAmplitude(output, outputRate, 10000.0f, skip), 1.0, 0.012);
+
+    // 35 kHz aliases to -15 kHz at the output
+    IQResamplerCPP alias(inputRate, outputRate, spec);
+    output = alias.process(generateTestSignal(20000, inputRate, 35000.0f));
+    double amplitude = toneAmplitude(output, outputRate, -15000.0f, skip);
+    EXPECT_LT(20.0 * std::log10(amplitude), -spec.stopbandAttenuationDb + 1.0);
+}
+
+// Test: Spec-driven prototype goes through the FFT engine unchanged
+TEST_F(IQFilterDesignTest, FFTEngineUsesDesignedFilter) {
+    IQFilterSpec spec(0.95, 100.0, 0.01);
+    IQResamplerCPP direct(120000, 100000, spec, IQResamplerCPP::Mode::PolyphaseDirect);
+    IQResamplerCPP fft(120000, 100000, spec, IQResamplerCPP::Mode::PolyphaseFFT);
+    ASSERT_TRUE(fft.usesFFT());
+
+    auto input = generateTestSignal(6000, 120000, 10000.0f);
+    auto expected = direct.process(input);
+    auto output = fft.process(input);
+
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_NEAR(output[i], expected[i], 1e-4f);
+    }
+}
+
+// Test: Minimum-phase version keeps the magnitude response and cuts the delay
+TEST_F(IQFilterDesignTest, MinimumPhase) {
+    IQFilterSpec spec(0.8, 80.0, 0.1);
+    auto linear = IQFilterDesign::kaiser(5, 6, spec);
+    auto minimum = IQFilterDesign::minimumPhase(linear);
+    ASSERT_EQ(minimum.size(), linear.size());
+
+    auto linearResponse = IQFilterDesign::response(linear, 5, 6, spec);
+    auto minimumResponse = IQFilterDesign::response(minimum, 5, 6, spec);
+    EXPECT_NEAR(minimumResponse.passbandRippleDb, linearResponse.passbandRippleDb, 0.01);
+    EXPECT_NEAR(minimumResponse.stopbandAttenuationDb, linearResponse.stopbandAttenuationDb, 1.0);
+
+    EXPECT_DOUBLE_EQ(IQFilterDesign::groupDelay(linear), (linear.size() - 1) / 2.0);
+    EXPECT_LT(IQFilterDesign::groupDelay(minimum), IQFilterDesign::groupDelay(linear) / 4.0);
+}
+
+// Test: Invalid specs are rejected
+TEST_F(IQFilterDesignTest, InvalidSpec) {
+    EXPECT_THROW(IQFilterDesign::kaiser(5, 6, IQFilterSpec(1.0, 80.0, 0.1)), std::invalid_argument);
+    EXPECT_THROW(IQFilterDesign::kaiser(5, 6, IQFilterSpec(0.8, -10.0, 0.1)), std::invalid_argument);
+    EXPECT_THROW(IQFilterDesign::kaiser(5, 6, IQFilterSpec(0.8, 80.0, 0.0)), std::invalid_argument);
+    EXPECT_THROW(IQFilterDesign::kaiser(5, 6, IQFilterSpec(), 0), std::invalid_argument);
+    EXPECT_THROW(IQFilterDesign::response(std::vector<float>(), 5, 6, IQFilterSpec()),
+                 std::invalid_argument);
+}
+
+// Main function
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "iq_quality.h"
+#include "iq_resampler_cpp.h"
+#include "iq_resampler_q15.h"
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+// Test fixture for the quality measurement harness
+class IQQualityTest : public ::testing::Test {
+protected:
+    const int INPUT_RATE = 120000;
+    const int OUTPUT_RATE = 100000;
+
+    // Fresh IQResamplerCPP per test signal
+    static IQQuality::Factory cppFactory(int inputRate, int outputRate, int taps, IQResamplerCPP::Mode mode) {
+        return [=]() {
+            std::shared_ptr<IQResamplerCPP> r = std::make_shared<IQResamplerCPP>(inputRate, outputRate, taps, mode);
+            return IQQuality::ProcessFunction([r](const std::vector<float>& in) { return r->process(in); });
+        };
+    }
+
+    static IQQuality::Factory specFactory(int inputRate, int outputRate, const IQFilterSpec& spec) {
+        return [=]() {
+            std::shared_ptr<IQResamplerCPP> r = std::make_shared<IQResamplerCPP>(inputRate, outputRate, spec);
+            return IQQuality::ProcessFunction([r](const std::vector<float>& in) { return r->process(in); });
+        };
+    }
+};
+
+// Test: Joint least-squares fit recovers closely spaced tones exactly
+TEST_F(IQQualityTest, FitTonesRecoversAmplitudes) {
+    std::vector<double> frequencies = {0.01, 0.0123, -0.2, 0.31};
+    std::vector<std::complex<double> > amplitudes = {
+        {0.5, 0.1}, {-0.2, 0.3}, {0.0, -0.7}, {1e-4, 0.0}};
+
+    std::vector<std::complex<double> > signal(1000);
+    for (size_t i = 0; i < signal.size(); i++) {
+        for (size_t k = 0; k < frequencies.size(); k++) {
+            signal[i] += amplitudes[k] * std::polar(1.0, 2.0 * M_PI * frequencies[k] * i);
+        }
+    }
+
+    auto fitted = IQQuality::fitTones(signal.data(), signal.size(), frequencies);
+    ASSERT_EQ(fitted.size(), frequencies.size());
+    for (size_t k = 0; k < frequencies.size(); k++) {
+        EXPECT_NEAR(std::abs(fitted[k] - amplitudes[k]), 0.0, 1e-9) << "tone " << k;
+    }
+
+    EXPECT_THROW(IQQuality::fitTones(signal.data(), signal.size(), {0.1, 0.1}), std::invalid_argument);
+}
+
+// Test: A lossless path measures at the float precision limit
+TEST_F(IQQualityTest, IdentityIsNearPerfect) {
+    IQQuality::Factory identity = []() {
+        return IQQuality::ProcessFunction([](const std::vector<float>& in) { return in; });
+    };
+    IQQualityReport report = IQQuality::measure(identity, 100000, 100000);
+
+    EXPECT_GT(report.snrDb, 130.0);
+    EXPECT_GT(report.sfdrDb, 140.0);
+    EXPECT_LT(report.passbandRippleDb, 1e-5);
+    EXPECT_TRUE(std::isnan(report.stopbandRejectionDb));
+}
+
+// Test: Measured figures rank the algorithms the way their filters do
+TEST_F(IQQualityTest, RanksResamplers) {
+    IQQualityReport linear = IQQuality::measure(
+        cppFactory(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Linear), INPUT_RATE, OUTPUT_RATE);
+    IQQualityReport polyphase = IQQuality::measure(
+        cppFactory(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase), INPUT_RATE, OUTPUT_RATE);
+    IQQualityReport designed = IQQuality::measure(
+        specFactory(INPUT_RATE, OUTPUT_RATE, IQFilterSpec(0.8, 80.0, 0.1)), INPUT_RATE, OUTPUT_RATE);
+
+    // Linear interpolation droops and aliases
+    EXPECT_GT(linear.passbandRippleDb, 1.0);
+    EXPECT_LT(linear.snrDb, 40.0);
+    EXPECT_GT(polyphase.snrDb, linear.snrDb + 20.0);
+    EXPECT_GT(polyphase.sfdrDb, linear.sfdrDb + 20.0);
+    EXPECT_GT(polyphase.stopbandRejectionDb, linear.stopbandRejectionDb);
+
+    // The spec-driven design delivers its spec, to within measurement error
+    EXPECT_LT(designed.passbandRippleDb, 0.12);
+    EXPECT_GT(designed.snrDb, 75.0);
+
+    // Near 1:1 the whole alias band is transition band; with a real
+    // stopband the designed rejection shows up
+    IQQualityReport decimating = IQQuality::measure(
+        specFactory(INPUT_RATE, 48000, IQFilterSpec(0.8, 80.0, 0.1)), INPUT_RATE, 48000);
+    EXPECT_GT(decimating.stopbandRejectionDb, 78.0);
+    EXPECT_GT(decimating.stopbandRejectionDb, designed.stopbandRejectionDb);
+}
+
+// Test: Interpolation measures image rejection instead of aliasing
+TEST_F(IQQualityTest, InterpolationMeasuresImages) {
+    IQQualityReport linear = IQQuality::measure(
+        cppFactory(OUTPUT_RATE, INPUT_RATE, 127, IQResamplerCPP::Mode::Linear), OUTPUT_RATE, INPUT_RATE);
+    IQQualityReport polyphase = IQQuality::measure(
+        cppFactory(OUTPUT_RATE, INPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase), OUTPUT_RATE, INPUT_RATE);
+
+    EXPECT_FALSE(std::isnan(polyphase.stopbandRejectionDb));
+    EXPECT_GT(polyphase.stopbandRejectionDb, linear.stopbandRejectionDb + 10.0);
+}
+
+// Test: Fixed point is limited by Q15 quantization
+TEST_F(IQQualityTest, Q15QuantizationFloor) {
+    IQQuality::Factory q15 = [this]() {
+        std::shared_ptr<IQResamplerQ15> r = std::make_shared<IQResamplerQ15>(INPUT_RATE, OUTPUT_RATE, 127);
+        return IQQuality::ProcessFunction([r](const std::vector<float>& in) { return r->process(in); });
+    };
+    IQQualityReport fixed = IQQuality::measure(q15, INPUT_RATE, OUTPUT_RATE);
+    IQQualityReport floating = IQQuality::measure(
+        cppFactory(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase), INPUT_RATE, OUTPUT_RATE);
+
+    EXPECT_GT(fixed.snrDb, 50.0);
+    EXPECT_LT(fixed.snrDb, 100.0);
+    EXPECT_NEAR(fixed.passbandRippleDb, floating.passbandRippleDb, 0.05);
+}
+
+// Test: Bad options are rejected
+TEST_F(IQQualityTest, ValidatesOptions) {
+    IQQualityOptions options;
+    options.analysisSamples = 1000;
+    EXPECT_THROW(IQQuality::measure(cppFactory(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase),
+                                    INPUT_RATE, OUTPUT_RATE, options),
+                 std::invalid_argument);
+}
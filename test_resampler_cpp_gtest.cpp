@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include "iq_resampler_cpp.h"
+#include <algorithm>
 #include <cmath>
+#include <complex>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 // Test fixture for IQ Resampler C++ implementation tests
@@ -73,6 +77,21 @@ TEST_F(IQResamplerCPPTest, Initialization) {
     });
 }
 
+// Test: Every filtering mode rejects prototypes too short to give each
+// polyphase branch real taps; Linear ignores the length
+TEST_F(IQResamplerCPPTest, RejectsFiltersTooShortForRatio) {
+    const int minimum = IQFilterDesign::minimumTaps(48000, 44100);
+    EXPECT_EQ(minimum, 8 * 160);
+    for (auto mode : {IQResamplerCPP::Mode::Polyphase, IQResamplerCPP::Mode::PolyphaseDirect,
+                      IQResamplerCPP::Mode::PolyphaseFFT, IQResamplerCPP::Mode::LowLatency}) {
+        EXPECT_THROW(IQResamplerCPP(48000, 44100, 127, mode), std::invalid_argument);
+        EXPECT_THROW(IQResamplerCPP(48000, 44100, minimum - 1, mode), std::invalid_argument);
+        EXPECT_NO_THROW(IQResamplerCPP(48000, 44100, minimum, mode));
+    }
+    EXPECT_NO_THROW(IQResamplerCPP(48000, 44100, 127, IQResamplerCPP::Mode::Linear));
+    EXPECT_THROW(IQFilterDesign::minimumTaps(0, 44100), std::invalid_argument);
+}
+
 // Test: Output size calculation
 TEST_F(IQResamplerCPPTest, OutputSizeCorrect) {
     IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE);
@@ -288,6 +307,818 @@ TEST_F(IQResamplerCPPTest, VariousRatios) {
     }
 }
 
+// Test: SC16 input matches float input within quantization error
+TEST_F(IQResamplerCPPTest, SC16InputMatchesFloat) {
+    IQResamplerCPP floatResampler(INPUT_RATE, OUTPUT_RATE);
+    IQResamplerCPP sc16Resampler(INPUT_RATE, OUTPUT_RATE);
+
+    auto input = generateTestSignal(1200, INPUT_RATE, 10000.0f);
+    std::vector<int16_t> inputSC16(input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+        inputSC16[i] = (int16_t)std::lrint(input[i] * 32767.0f);
+    }
+
+    auto expected = floatResampler.process(input);
+    auto output = sc16Resampler.process(inputSC16, 1.0f / 32767.0f);
+
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_NEAR(output[i], expected[i], 1e-4f) << "Mismatch at index " << i;
+    }
+}
+
+// Test: SC8 input matches float input within quantization error
+TEST_F(IQResamplerCPPTest, SC8InputMatchesFloat) {
+    IQResamplerCPP floatResampler(INPUT_RATE, OUTPUT_RATE);
+    IQResamplerCPP sc8Resampler(INPUT_RATE, OUTPUT_RATE);
+
+    auto input = generateTestSignal(1200, INPUT_RATE, 10000.0f);
+    std::vector<int8_t> inputSC8(input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+        inputSC8[i] = (int8_t)std::lrint(input[i] * 127.0f);
+    }
+
+    auto expected = floatResampler.process(input);
+    auto output = sc8Resampler.process(inputSC8, 1.0f / 127.0f);
+
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_NEAR(output[i], expected[i], 1.0f / 127.0f) << "Mismatch at index " << i;
+    }
+}
+
+// Test: SC16 output rounds like the float path and saturates instead of wrapping
+TEST_F(IQResamplerCPPTest, SC16OutputSaturates) {
+    IQResamplerCPP floatResampler(INPUT_RATE, OUTPUT_RATE);
+    IQResamplerCPP sc16Resampler(INPUT_RATE, OUTPUT_RATE);
+
+    auto input = generateTestSignal(1200, INPUT_RATE, 10000.0f);
+    auto expected = floatResampler.process(input);
+
+    // Full scale of 2^16 drives every |x| > 0.5 out of int16 range
+    const float outScale = 65536.0f;
+    auto output = sc16Resampler.processSC16(input, outScale);
+
+    ASSERT_EQ(output.size(), expected.size());
+    int saturated = 0;
+    for (size_t i = 0; i < output.size(); i++) {
+        float scaled = expected[i] * outScale;
+        if (scaled >= 32767.0f) {
+            EXPECT_EQ(output[i], 32767);
+            saturated++;
+        } else if (scaled <= -32768.0f) {
+            EXPECT_EQ(output[i], -32768);
+            saturated++;
+        } else {
+            EXPECT_NEAR(output[i], scaled, 0.51f);
+        }
+    }
+    EXPECT_GT(saturated, 0) << "Test signal should exercise saturation";
+}
+
+// Test: Float and SC16 input overloads share one full-scale default
+TEST_F(IQResamplerCPPTest, SC16DefaultFullScaleMatches) {
+    IQResamplerCPP floatResampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP sc16Resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+
+    // Float input on the SC16 grid, so both paths load identical samples
+    auto signal = generateTestSignal(1200, INPUT_RATE, 10000.0f);
+    std::vector<int16_t> inputSC16(signal.size());
+    std::vector<float> input(signal.size());
+    for (size_t i = 0; i < signal.size(); i++) {
+        inputSC16[i] = (int16_t)std::lrint(signal[i] * 0.9f * 32768.0f);
+        input[i] = inputSC16[i] / 32768.0f;
+    }
+
+    auto fromFloat = floatResampler.processSC16(input);
+    auto fromSC16 = sc16Resampler.processSC16(inputSC16);
+    EXPECT_EQ(fromFloat, fromSC16);
+
+    // 1.0 maps to 32768, i.e. saturates
+    IQResamplerCPP dc(INPUT_RATE, INPUT_RATE, 1, IQResamplerCPP::Mode::Linear);
+    auto full = dc.processSC16(std::vector<float>(64, 1.0f));
+    auto half = IQResamplerCPP(INPUT_RATE, INPUT_RATE, 1, IQResamplerCPP::Mode::Linear)
+                    .processSC16(std::vector<float>(64, 0.5f));
+    ASSERT_FALSE(full.empty());
+    EXPECT_EQ(full.back(), 32767);
+    EXPECT_EQ(half.back(), 16384);
+}
+
+// Test: Integer input with odd size is rejected
+TEST_F(IQResamplerCPPTest, InvalidIntegerInputSize) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE);
+
+    std::vector<int16_t> invalidSC16(123);
+    std::vector<int8_t> invalidSC8(123);
+
+    EXPECT_THROW(resampler.process(invalidSC16), std::invalid_argument);
+    EXPECT_THROW(resampler.process(invalidSC8), std::invalid_argument);
+    EXPECT_THROW(resampler.processSC16(invalidSC16), std::invalid_argument);
+}
+
+// Test: Polyphase mode preserves power and frequency
+TEST_F(IQResamplerCPPTest, PolyphasePowerAndFrequency) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+
+    float inputFreq = 10000.0f;
+    auto input = generateTestSignal(12000, INPUT_RATE, inputFreq);
+    auto output = resampler.process(input);
+
+    // Exactly one output per L/M input samples
+    EXPECT_EQ(output.size() / 2, 10000u);
+
+    // Skip the filter startup transient
+    std::vector<float> settled(output.begin() + 200, output.end());
+    float inputPower = calculatePower(input);
+    float outputPower = calculatePower(settled);
+    EXPECT_NEAR(outputPower, inputPower, inputPower * 0.01f)
+        << "Input power: " << inputPower << ", Output power: " << outputPower;
+
+    float detectedFreq = detectFrequency(settled, OUTPUT_RATE);
+    EXPECT_NEAR(detectedFreq, inputFreq, inputFreq * 0.01f)
+        << "Expected frequency " << inputFreq << " Hz, detected " << detectedFreq << " Hz";
+}
+
+// Test: Polyphase streaming output does not depend on block boundaries
+TEST_F(IQResamplerCPPTest, PolyphaseStreamingMatchesOneShot) {
+    const int taps = IQFilterDesign::minimumTaps(48000, 44100);
+    IQResamplerCPP oneShot(48000, 44100, taps, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP streaming(48000, 44100, taps, IQResamplerCPP::Mode::Polyphase);
+
+    auto input = generateTestSignal(4800, 48000, 5000.0f);
+    auto expected = oneShot.process(input);
+
+    std::vector<float> output;
+    size_t pos = 0;
+    const size_t blockSizes[] = {2, 14, 250, 1000, 6, 4000};
+    for (size_t b = 0; pos < input.size(); b++) {
+        size_t len = std::min(blockSizes[b % 6], input.size() - pos);
+        std::vector<float> block(input.begin() + pos, input.begin() + pos + len);
+        auto out = streaming.process(block);
+        output.insert(output.end(), out.begin(), out.end());
+        pos += len;
+    }
+
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_FLOAT_EQ(output[i], expected[i]) << "Mismatch at index " << i;
+    }
+}
+
+// Test: Linear mode keeps its fractional position across blocks and does
+// not drop outputs at the end of a block
+TEST_F(IQResamplerCPPTest, LinearStreamingMatchesOneShot) {
+    IQResamplerCPP oneShot(INPUT_RATE, OUTPUT_RATE);
+    IQResamplerCPP streaming(INPUT_RATE, OUTPUT_RATE);
+
+    auto input = generateTestSignal(12000, INPUT_RATE, 10000.0f);
+    auto expected = oneShot.process(input);
+
+    // Outputs at input positions 0, 1.2, 2.4, ... up to the last sample 11999
+    EXPECT_EQ(expected.size() / 2, 10000u);
+
+    std::vector<float> output;
+    size_t pos = 0;
+    const size_t blockSizes[] = {2, 14, 250, 1000, 6, 4000};
+    for (size_t b = 0; pos < input.size(); b++) {
+        size_t len = std::min(blockSizes[b % 6], input.size() - pos);
+        std::vector<float> block(input.begin() + pos, input.begin() + pos + len);
+        auto out = streaming.process(block);
+        output.insert(output.end(), out.begin(), out.end());
+        pos += len;
+    }
+
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_FLOAT_EQ(output[i], expected[i]) << "Mismatch at index " << i;
+    }
+    EXPECT_DOUBLE_EQ(streaming.groupDelay(), 0.0);
+}
+
+// Test: Low-latency mode keeps the magnitude response with a fraction of the delay
+TEST_F(IQResamplerCPPTest, LowLatencyMode) {
+    IQResamplerCPP linearPhase(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP lowLatency(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::LowLatency);
+
+    // 127 taps at 5x the input rate: (127 - 1) / 2 / 5 input samples
+    EXPECT_NEAR(linearPhase.groupDelay(), 12.6, 1e-9);
+    EXPECT_LT(lowLatency.groupDelay(), 3.0);
+    EXPECT_GT(lowLatency.groupDelay(), 0.0);
+
+    // Step response reaches half height after about groupDelay() samples
+    std::vector<float> step(2000 * 2, 0.0f);
+    for (size_t i = 200; i < step.size() / 2; i++) {
+        step[i * 2] = 1.0f;
+    }
+    for (IQResamplerCPP* resampler : {&linearPhase, &lowLatency}) {
+        auto output = resampler->process(step);
+        size_t crossing = 0;
+        while (crossing < output.size() / 2 && output[crossing * 2] < 0.5f) {
+            crossing++;
+        }
+        // Output n sits at input position 1.2 n
+        double delay = crossing * 1.2 - 200.0;
+        EXPECT_NEAR(delay, resampler->groupDelay(), 1.5);
+    }
+
+    // Same power and frequency as the linear-phase filter
+    lowLatency.reset();
+    float inputFreq = 10000.0f;
+    auto input = generateTestSignal(12000, INPUT_RATE, inputFreq);
+    auto output = lowLatency.process(input);
+    EXPECT_EQ(output.size() / 2, 10000u);
+
+    std::vector<float> settled(output.begin() + 200, output.end());
+    float inputPower = calculatePower(input);
+    EXPECT_NEAR(calculatePower(settled), inputPower, inputPower * 0.01f);
+    EXPECT_NEAR(detectFrequency(settled, OUTPUT_RATE), inputFreq, inputFreq * 0.01f);
+
+    // Long filters stay in direct form
+    IQResamplerCPP longFilter(INPUT_RATE, OUTPUT_RATE, 4095, IQResamplerCPP::Mode::LowLatency);
+    EXPECT_FALSE(longFilter.usesFFT());
+}
+
+// Test: outputSamplesFor / inputSamplesNeededFor are exact in every mode and phase
+TEST_F(IQResamplerCPPTest, ExactSampleCountQueries) {
+    struct TestCase {
+        int inputRate;
+        int outputRate;
+        IQResamplerCPP::Mode mode;
+    };
+
+    std::vector<TestCase> testCases = {
+        {120000, 100000, IQResamplerCPP::Mode::Linear},
+        {48000, 44100, IQResamplerCPP::Mode::Linear},
+        {50000, 100000, IQResamplerCPP::Mode::Linear},
+        {120000, 100000, IQResamplerCPP::Mode::Polyphase},
+        {48000, 44100, IQResamplerCPP::Mode::Polyphase},
+        {30000, 100000, IQResamplerCPP::Mode::LowLatency},
+        {120000, 100000, IQResamplerCPP::Mode::PolyphaseFFT}
+    };
+
+    const size_t blockSizes[] = {1, 7, 0, 250, 3, 1000, 2};
+    for (const auto& tc : testCases) {
+        int taps = std::max(127, IQFilterDesign::minimumTaps(tc.inputRate, tc.outputRate));
+        IQResamplerCPP resampler(tc.inputRate, tc.outputRate, taps, tc.mode);
+
+        for (int b = 0; b < 40; b++) {
+            size_t len = blockSizes[b % 7];
+            auto input = generateTestSignal((int)len, (float)tc.inputRate, 1000.0f);
+
+            size_t predicted = resampler.outputSamplesFor(len);
+            EXPECT_EQ(resampler.process(input).size() / 2, predicted)
+                << tc.inputRate << " to " << tc.outputRate << ", block " << b;
+
+            // Feeding exactly inputSamplesNeededFor(k) yields at least k
+            // outputs, one sample fewer yields less
+            for (size_t k : {1, 2, 5, 40}) {
+                size_t needed = resampler.inputSamplesNeededFor(k);
+                EXPECT_GE(resampler.outputSamplesFor(needed), k);
+                if (needed > 0) {
+                    EXPECT_LT(resampler.outputSamplesFor(needed - 1), k);
+                }
+            }
+        }
+        EXPECT_EQ(resampler.inputSamplesNeededFor(0), 0u);
+    }
+}
+
+// Test: Pull mode returns exactly what was asked for and matches push mode
+TEST_F(IQResamplerCPPTest, PullMatchesPush) {
+    struct TestCase {
+        int inputRate;
+        int outputRate;
+        IQResamplerCPP::Mode mode;
+    };
+
+    std::vector<TestCase> testCases = {
+        {120000, 100000, IQResamplerCPP::Mode::Polyphase},
+        {120000, 100000, IQResamplerCPP::Mode::Linear},
+        {30000, 100000, IQResamplerCPP::Mode::Polyphase},  // Several outputs per input
+        {30000, 100000, IQResamplerCPP::Mode::Linear},
+        {120000, 100000, IQResamplerCPP::Mode::PolyphaseFFT}
+    };
+
+    for (const auto& tc : testCases) {
+        auto input = generateTestSignal(6000, (float)tc.inputRate, 1000.0f);
+        IQResamplerCPP push(tc.inputRate, tc.outputRate, 127, tc.mode);
+        auto expected = push.process(input);
+
+        const std::complex<float>* source = reinterpret_cast<const std::complex<float>*>(input.data());
+        size_t sourcePos = 0;
+        size_t sourceLen = input.size() / 2;
+        IQResamplerCPP pull(tc.inputRate, tc.outputRate, 127, tc.mode);
+        pull.setInputSource([&](std::complex<float>* dst, size_t maxSamples) {
+            size_t n = std::min(maxSamples, sourceLen - sourcePos);
+            std::copy(source + sourcePos, source + sourcePos + n, dst);
+            sourcePos += n;
+            return n;
+        }, 100);
+
+        std::vector<std::complex<float>> output;
+        const size_t requests[] = {1, 3, 64, 1000, 7};
+        for (size_t r = 0; ; r++) {
+            std::vector<std::complex<float>> chunk(requests[r % 5]);
+            size_t got = pull.pull(chunk.data(), chunk.size());
+            output.insert(output.end(), chunk.begin(), chunk.begin() + got);
+            if (got < chunk.size()) {
+                break;
+            }
+            ASSERT_LT(r, 10000u);
+        }
+
+        // Source ran dry: everything push produced has been pulled
+        ASSERT_EQ(output.size() * 2, expected.size())
+            << tc.inputRate << " to " << tc.outputRate;
+        for (size_t i = 0; i < output.size(); i++) {
+            EXPECT_NEAR(output[i].real(), expected[i * 2], 1e-5f);
+            EXPECT_NEAR(output[i].imag(), expected[i * 2 + 1], 1e-5f);
+        }
+    }
+}
+
+// Test: Pull mode from a ring buffer survives underruns
+TEST_F(IQResamplerCPPTest, PullFromRingBuffer) {
+    IQRingBuffer ring(1000);
+    EXPECT_EQ(ring.capacity(), 1024u);
+
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP reference(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    resampler.setInputSource(ring, 64);
+    size_t needed = resampler.inputSamplesNeededFor(2500);
+
+    auto input = generateTestSignal(3000, INPUT_RATE, 10000.0f);
+    auto expected = reference.process(input);
+    const std::complex<float>* samples = reinterpret_cast<const std::complex<float>*>(input.data());
+
+    std::vector<std::complex<float>> output(2500);
+    size_t written = 0;
+    size_t produced = 0;
+    while (written < 3000) {
+        // Producer writes what fits (wrapping the ring), consumer pulls 256
+        written += ring.write(samples + written, std::min<size_t>(700, 3000 - written));
+        produced += resampler.pull(output.data() + produced, std::min<size_t>(256, 2500 - produced));
+    }
+    produced += resampler.pull(output.data() + produced, 2500 - produced);
+
+    // Pull reads no further than the last requested output needs
+    EXPECT_EQ(produced, 2500u);
+    EXPECT_EQ(ring.available(), 3000u - needed);
+    for (size_t i = 0; i < produced; i++) {
+        EXPECT_FLOAT_EQ(output[i].real(), expected[i * 2]);
+        EXPECT_FLOAT_EQ(output[i].imag(), expected[i * 2 + 1]);
+    }
+
+    // Drain the ring: the request comes back short
+    std::complex<float> extra[4];
+    EXPECT_EQ(resampler.pull(extra, 4), 0u);
+    EXPECT_EQ(ring.available(), 0u);
+}
+
+// Test: Pull without a registered source
+TEST_F(IQResamplerCPPTest, PullWithoutSource) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE);
+    std::complex<float> out[4];
+    EXPECT_THROW(resampler.pull(out, 4), std::logic_error);
+}
+
+// Test: Flush emits the delayed tail, as if the stream had been zero-padded
+TEST_F(IQResamplerCPPTest, FlushEmitsTail) {
+    std::vector<IQResamplerCPP::Mode> modes = {
+        IQResamplerCPP::Mode::Linear,
+        IQResamplerCPP::Mode::Polyphase,
+        IQResamplerCPP::Mode::PolyphaseFFT,
+        IQResamplerCPP::Mode::LowLatency
+    };
+
+    for (auto mode : modes) {
+        IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        IQResamplerCPP padded(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        size_t padding = (size_t)std::ceil(resampler.groupDelay() - 1e-6);
+
+        // DC input: every output up to the last input sample (after the
+        // delay) should be at full amplitude
+        std::vector<float> input(2 * 1001, 1.0f);
+        auto output = resampler.process(input);
+        size_t tailSize = resampler.outputSamplesForFlush();
+        auto tail = resampler.flush();
+        EXPECT_EQ(tail.size(), tailSize * 2);
+
+        std::vector<float> zeroPadded(input);
+        zeroPadded.resize(input.size() + padding * 2, 0.0f);
+        auto expected = padded.process(zeroPadded);
+
+        output.insert(output.end(), tail.begin(), tail.end());
+        ASSERT_EQ(output.size(), expected.size());
+        for (size_t i = 0; i < output.size(); i++) {
+            EXPECT_NEAR(output[i], expected[i], 1e-5f);
+        }
+
+        // Output n shows input time n*M/L - delay: the next one would be
+        // past the last input sample, so all of it came out
+        double step = (double)INPUT_RATE / OUTPUT_RATE;
+        double lastTime = (output.size() / 2 - 1) * step - resampler.groupDelay();
+        EXPECT_GT(lastTime + step, 1000.0);
+        size_t settled = (size_t)(resampler.groupDelay() * OUTPUT_RATE / INPUT_RATE) + 30;
+        size_t lastFull = (size_t)((1000.0 + resampler.groupDelay()) * OUTPUT_RATE / INPUT_RATE) - 30;
+        for (size_t n = settled; n < lastFull; n++) {
+            EXPECT_NEAR(output[n * 2], 1.0f, 0.01f);
+        }
+
+        // Flush leaves the resampler ready for a new stream
+        IQResamplerCPP fresh(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        auto block = generateTestSignal(500, INPUT_RATE, 10000.0f);
+        EXPECT_EQ(resampler.process(block), fresh.process(block));
+    }
+}
+
+// Test: Flush hands out pull-mode leftovers first and checks capacity
+TEST_F(IQResamplerCPPTest, FlushAfterPull) {
+    IQResamplerCPP resampler(30000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    auto input = generateTestSignal(100, 30000, 1000.0f);
+    const std::complex<float>* samples = reinterpret_cast<const std::complex<float>*>(input.data());
+    size_t pos = 0;
+    resampler.setInputSource([&](std::complex<float>* dst, size_t maxSamples) {
+        size_t n = std::min(maxSamples, (size_t)100 - pos);
+        std::copy(samples + pos, samples + pos + n, dst);
+        pos += n;
+        return n;
+    });
+
+    // 10 outputs per 3 inputs: pulling 5 leaves some pending
+    std::vector<std::complex<float> > output(5);
+    ASSERT_EQ(resampler.pull(output.data(), 5), 5u);
+    std::vector<std::complex<float> > small(1);
+    EXPECT_THROW(resampler.flush(small.data(), small.size()), std::length_error);
+
+    IQResamplerCPP reference(30000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    auto expected = reference.process(std::vector<float>(input.begin(), input.begin() + 2 * pos));
+    auto expectedTail = reference.flush();
+    expected.insert(expected.end(), expectedTail.begin(), expectedTail.end());
+
+    std::vector<std::complex<float> > tail(resampler.outputSamplesForFlush());
+    size_t produced = resampler.flush(tail.data(), tail.size());
+    ASSERT_EQ(produced, tail.size());
+    output.insert(output.end(), tail.begin(), tail.end());
+    ASSERT_EQ(output.size() * 2, expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_FLOAT_EQ(output[i].real(), expected[i * 2]);
+        EXPECT_FLOAT_EQ(output[i].imag(), expected[i * 2 + 1]);
+    }
+}
+
+// Test: Priming with earlier samples continues the stream without a transient
+TEST_F(IQResamplerCPPTest, PrimeMatchesContinuousStream) {
+    std::vector<IQResamplerCPP::Mode> modes = {
+        IQResamplerCPP::Mode::Linear,
+        IQResamplerCPP::Mode::Polyphase,
+        IQResamplerCPP::Mode::PolyphaseFFT
+    };
+
+    for (auto mode : modes) {
+        // 1200 samples is a whole number of 6-sample periods, so the
+        // continuous resampler is back at phase 0 for the second block
+        auto first = generateTestSignal(1200, INPUT_RATE, 10000.0f);
+        auto second = generateTestSignal(1200, INPUT_RATE, 7000.0f);
+
+        IQResamplerCPP continuous(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        continuous.process(first);
+        auto expected = continuous.process(second);
+
+        IQResamplerCPP primed(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        primed.process(generateTestSignal(333, INPUT_RATE, 3000.0f));  // Unrelated state
+        primed.prime(reinterpret_cast<const std::complex<float>*>(first.data()), first.size() / 2);
+        auto output = primed.process(second);
+
+        ASSERT_EQ(output.size(), expected.size());
+        for (size_t i = 0; i < output.size(); i++) {
+            EXPECT_NEAR(output[i], expected[i], 1e-5f);
+        }
+    }
+
+    // Short history is right-aligned; older taps see zeros
+    IQResamplerCPP shortHistory(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP zeroPrefixed(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    auto history = generateTestSignal(6, INPUT_RATE, 10000.0f);
+    auto block = generateTestSignal(600, INPUT_RATE, 7000.0f);
+    shortHistory.prime(reinterpret_cast<const std::complex<float>*>(history.data()), 6);
+    std::vector<float> joined(history);
+    joined.insert(joined.end(), block.begin(), block.end());
+    auto expected = zeroPrefixed.process(joined);
+    auto output = shortHistory.process(block);
+    // Joined run has 6 more input samples (one period, same phase): skip
+    // the outputs they produced
+    size_t skip = expected.size() - output.size();
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_NEAR(output[i], expected[i + skip], 1e-5f);
+    }
+}
+
+// Test: Batched bursts match resampling each burst on its own
+TEST_F(IQResamplerCPPTest, ProcessBursts) {
+    std::vector<IQResamplerCPP::Mode> modes = {
+        IQResamplerCPP::Mode::Linear,
+        IQResamplerCPP::Mode::Polyphase,
+        IQResamplerCPP::Mode::PolyphaseDirect,
+        IQResamplerCPP::Mode::PolyphaseFFT
+    };
+    auto signal = generateTestSignal(5000, INPUT_RATE, 10000.0f);
+    const std::complex<float>* samples = reinterpret_cast<const std::complex<float>*>(signal.data());
+
+    // Bursts of 200-2000 samples; the third is primed with its guard interval
+    std::vector<IQBurst> bursts = {
+        IQBurst(samples, 200, 1000),
+        IQBurst(samples + 300, 1999, 5000),
+        IQBurst(samples + 2500, 2000, 9000),
+        IQBurst(samples + 4600, 0, 12000)
+    };
+    bursts[2].history = samples + 2400;
+    bursts[2].historySamples = 100;
+
+    for (auto mode : modes) {
+        IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        resampler.process(generateTestSignal(77, INPUT_RATE, 3000.0f));  // Leftover stream state
+
+        std::vector<std::complex<float> > output(resampler.outputSamplesForBursts(bursts.data(), bursts.size()));
+        std::vector<IQBurstOutput> results(bursts.size());
+        size_t produced = resampler.processBursts(bursts.data(), bursts.size(), output.data(), output.size(),
+                                                  results.data());
+        ASSERT_EQ(produced, output.size());
+
+        size_t offset = 0;
+        for (size_t b = 0; b < bursts.size(); b++) {
+            IQResamplerCPP single(INPUT_RATE, OUTPUT_RATE, 127, mode);
+            single.prime(bursts[b].history, bursts[b].historySamples);
+            const float* begin = reinterpret_cast<const float*>(bursts[b].samples);
+            auto expected = single.process(std::vector<float>(begin, begin + bursts[b].numSamples * 2));
+            auto tail = single.flush();
+            expected.insert(expected.end(), tail.begin(), tail.end());
+
+            EXPECT_EQ(results[b].offset, offset);
+            EXPECT_EQ(results[b].timestamp, bursts[b].timestamp);
+            ASSERT_EQ(results[b].numSamples * 2, expected.size());
+            for (size_t i = 0; i < results[b].numSamples; i++) {
+                EXPECT_NEAR(output[offset + i].real(), expected[i * 2], 1e-5f);
+                EXPECT_NEAR(output[offset + i].imag(), expected[i * 2 + 1], 1e-5f);
+            }
+            offset += results[b].numSamples;
+        }
+
+        // Without flushing, each burst keeps only its own outputs
+        std::vector<IQBurstOutput> unflushed(bursts.size());
+        size_t count = resampler.outputSamplesForBursts(bursts.data(), bursts.size(), false);
+        EXPECT_EQ(resampler.processBursts(bursts.data(), bursts.size(), output.data(), output.size(),
+                                          unflushed.data(), false), count);
+        EXPECT_EQ(unflushed[0].numSamples, mode == IQResamplerCPP::Mode::Linear ? 166u : 167u);
+
+        // The stream then continues from the last burst
+        resampler.processBursts(bursts.data(), 3, output.data(), output.size(), unflushed.data(), false);
+        IQResamplerCPP last(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        last.prime(bursts[2].history, bursts[2].historySamples);
+        last.process(bursts[2].samples, bursts[2].numSamples, output.data(), output.size());
+        EXPECT_EQ(resampler.inputPosition(), last.inputPosition());
+        auto more = generateTestSignal(300, INPUT_RATE, 5000.0f);
+        auto expectedMore = last.process(more);
+        EXPECT_EQ(resampler.process(more), expectedMore);
+
+        std::vector<std::complex<float> > small(output.size() - 1);
+        EXPECT_THROW(resampler.processBursts(bursts.data(), bursts.size(), small.data(), small.size(),
+                                             results.data()), std::length_error);
+    }
+}
+
+// Test: A burst with a null pointer is rejected before anything is touched
+TEST_F(IQResamplerCPPTest, ProcessBurstsRejectsNullBurst) {
+    std::vector<IQResamplerCPP::Mode> modes = {
+        IQResamplerCPP::Mode::Linear,
+        IQResamplerCPP::Mode::PolyphaseDirect,
+        IQResamplerCPP::Mode::PolyphaseFFT
+    };
+    auto signal = generateTestSignal(1000, INPUT_RATE, 10000.0f);
+    auto more = generateTestSignal(300, INPUT_RATE, 5000.0f);
+    const std::complex<float>* samples = reinterpret_cast<const std::complex<float>*>(signal.data());
+
+    for (auto mode : modes) {
+        IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        IQResamplerCPP reference(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        resampler.process(signal);
+        reference.process(signal);
+
+        // The bad burst comes after a good one, which must not be processed either
+        std::vector<IQBurst> bursts = {IQBurst(samples, 500), IQBurst(nullptr, 200)};
+        std::vector<std::complex<float> > output(resampler.outputSamplesForBursts(bursts.data(), bursts.size()));
+        std::vector<IQBurstOutput> results(bursts.size());
+        EXPECT_THROW(resampler.processBursts(bursts.data(), bursts.size(), output.data(), output.size(),
+                                             results.data()), std::invalid_argument);
+
+        bursts[1] = IQBurst(samples, 200);
+        bursts[1].historySamples = 10;
+        EXPECT_THROW(resampler.processBursts(bursts.data(), bursts.size(), output.data(), output.size(),
+                                             results.data()), std::invalid_argument);
+
+        // Stream state unchanged
+        EXPECT_EQ(resampler.inputPosition(), reference.inputPosition());
+        EXPECT_EQ(resampler.process(more), reference.process(more));
+    }
+}
+
+// Test: Tags come out at the output sample that shows the tagged input
+TEST_F(IQResamplerCPPTest, TagsFollowImpulses) {
+    std::vector<IQResamplerCPP::Mode> modes = {
+        IQResamplerCPP::Mode::Polyphase,
+        IQResamplerCPP::Mode::PolyphaseFFT,
+        IQResamplerCPP::Mode::Linear
+    };
+
+    for (auto mode : modes) {
+        IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, mode);
+
+        // Impulses at known input indices, fed in blocks of 500
+        const uint64_t impulses[] = {100, 733, 1499, 1500, 2222};
+        std::vector<float> input(2 * 3000, 0.0f);
+        for (uint64_t index : impulses) {
+            input[index * 2] = 1.0f;
+            resampler.addTag(index, (int64_t)index * 10);
+        }
+
+        std::vector<float> output;
+        std::vector<IQOutputTag> tags;
+        for (size_t block = 0; block < 6; block++) {
+            auto chunk = resampler.process(std::vector<float>(input.begin() + block * 1000,
+                                                              input.begin() + (block + 1) * 1000));
+            output.insert(output.end(), chunk.begin(), chunk.end());
+            EXPECT_EQ(resampler.inputPosition(), (block + 1) * 500);
+            EXPECT_EQ(resampler.outputPosition(), output.size() / 2);
+
+            IQOutputTag taken[8];
+            size_t n = resampler.takeTags(taken, 8);
+            for (size_t i = 0; i < n; i++) {
+                // Released as soon as the output at floor(position) exists
+                EXPECT_LT(std::floor(taken[i].position), (double)output.size() / 2);
+                EXPECT_GE(std::floor(taken[i].position), (double)(output.size() - chunk.size()) / 2);
+                tags.push_back(taken[i]);
+            }
+        }
+
+        ASSERT_EQ(tags.size(), 5u);
+        for (size_t t = 0; t < tags.size(); t++) {
+            EXPECT_EQ(tags[t].inputIndex, impulses[t]);
+            EXPECT_EQ(tags[t].payload, (int64_t)impulses[t] * 10);
+            double expected = (impulses[t] + resampler.groupDelay()) * OUTPUT_RATE / INPUT_RATE;
+            EXPECT_NEAR(tags[t].position, expected, 1e-9);
+        }
+
+        // Isolated impulses peak at the output nearest the tag position
+        for (size_t t : {0, 1, 4}) {
+            size_t centre = (size_t)std::floor(tags[t].position);
+            size_t peak = centre;
+            for (size_t n = centre - 3; n <= centre + 3; n++) {
+                if (std::abs(output[n * 2]) > std::abs(output[peak * 2])) {
+                    peak = n;
+                }
+            }
+            EXPECT_NEAR((double)peak, tags[t].position, 1.0) << "Tag " << t;
+        }
+    }
+}
+
+// Test: Tag ordering, capacity and reset
+TEST_F(IQResamplerCPPTest, TagBuffer) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    resampler.reserveTags(2);  // The default capacity is larger and stays
+    resampler.addTag(10, 1);
+    EXPECT_THROW(resampler.addTag(5, 2), std::invalid_argument);
+
+    IQResamplerCPP small(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    for (int i = 0; i < 64; i++) {
+        small.addTag(i, i);
+    }
+    EXPECT_THROW(small.addTag(64, 64), std::length_error);
+
+    // Ready tags free their slots once taken
+    small.process(generateTestSignal(200, INPUT_RATE, 1000.0f));
+    std::vector<IQOutputTag> taken(64);
+    EXPECT_EQ(small.takeTags(taken.data(), 64), 64u);
+    EXPECT_EQ(small.readyTags(), 0u);
+    small.addTag(150, 7);
+    EXPECT_EQ(small.readyTags(), 1u);  // Its output is already out
+    small.addTag(500, 8);
+
+    // Tags whose output never came are dropped with the stream
+    small.reset();
+    EXPECT_EQ(small.inputPosition(), 0u);
+    small.process(generateTestSignal(600, INPUT_RATE, 1000.0f));
+    EXPECT_EQ(small.takeTags(taken.data(), 64), 1u);
+    EXPECT_EQ(taken[0].payload, 7);
+}
+
+// Test: Symmetric folding (decimation-only ratios) matches the generic kernel
+TEST_F(IQResamplerCPPTest, SymmetricFoldingMatchesGeneric) {
+    // Odd lengths around the SIMD block sizes (2:1 needs at least 16 taps),
+    // plus an even-length Kaiser design (the Hamming prototype is only
+    // symmetric when odd)
+    for (int taps : {127, 33, 31, 25, 17, 0}) {
+        std::unique_ptr<IQResamplerCPP> folded, generic;
+        if (taps > 0) {
+            folded.reset(new IQResamplerCPP(100000, 50000, taps, IQResamplerCPP::Mode::PolyphaseDirect));
+            generic.reset(new IQResamplerCPP(100000, 50000, taps, IQResamplerCPP::Mode::PolyphaseDirect));
+        } else {
+            IQFilterSpec spec(0.8, 80.0, 0.1);
+            folded.reset(new IQResamplerCPP(100000, 50000, spec, IQResamplerCPP::Mode::PolyphaseDirect));
+            generic.reset(new IQResamplerCPP(100000, 50000, spec, IQResamplerCPP::Mode::PolyphaseDirect));
+            ASSERT_EQ(folded->branchTaps() % 2, 0);
+        }
+        generic->setSymmetricFolding(false);
+        ASSERT_TRUE(folded->usesSymmetricFolding()) << taps << " taps";
+        ASSERT_FALSE(generic->usesSymmetricFolding());
+
+        auto input = generateTestSignal(3000, 100000, 7000.0f);
+        auto expected = generic->process(input);
+        auto output = folded->process(input);
+
+        ASSERT_EQ(output.size(), expected.size());
+        for (size_t i = 0; i < output.size(); i++) {
+            EXPECT_NEAR(output[i], expected[i], 1e-5f) << taps << " taps, index " << i;
+        }
+    }
+
+    // Interpolating ratios split the prototype into non-symmetric branches
+    IQResamplerCPP polyphase(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    EXPECT_FALSE(polyphase.usesSymmetricFolding());
+}
+
+// Test: std::complex<float> pointer API matches the vector API
+TEST_F(IQResamplerCPPTest, ComplexPointerMatchesVector) {
+    for (auto mode : {IQResamplerCPP::Mode::Linear, IQResamplerCPP::Mode::Polyphase}) {
+        IQResamplerCPP vectorResampler(INPUT_RATE, OUTPUT_RATE, 127, mode);
+        IQResamplerCPP pointerResampler(INPUT_RATE, OUTPUT_RATE, 127, mode);
+
+        auto input = generateTestSignal(1200, INPUT_RATE, 10000.0f);
+        std::vector<std::complex<float>> complexInput(input.size() / 2);
+        for (size_t i = 0; i < complexInput.size(); i++) {
+            complexInput[i] = std::complex<float>(input[i * 2], input[i * 2 + 1]);
+        }
+
+        auto expected = vectorResampler.process(input);
+
+        std::vector<std::complex<float>> output(complexInput.size());
+        size_t produced = pointerResampler.process(complexInput.data(), complexInput.size(),
+                                                   output.data(), output.size());
+
+        ASSERT_EQ(produced * 2, expected.size());
+        for (size_t i = 0; i < produced; i++) {
+            EXPECT_EQ(output[i].real(), expected[i * 2]);
+            EXPECT_EQ(output[i].imag(), expected[i * 2 + 1]);
+        }
+    }
+}
+
+// Test: Spans over parts of a larger buffer are processed in place
+TEST_F(IQResamplerCPPTest, SpanOverLargerBuffer) {
+    IQResamplerCPP vectorResampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP spanResampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+
+    // Simulated DMA buffer: two 600-sample transfers back to back
+    auto dma = generateTestSignal(1200, INPUT_RATE, 10000.0f);
+    std::vector<float> first(dma.begin(), dma.begin() + 1200);
+    std::vector<float> second(dma.begin() + 1200, dma.end());
+    auto expected1 = vectorResampler.process(first);
+    auto expected2 = vectorResampler.process(second);
+
+    IQSpan<const float> whole(dma);
+    std::vector<float> output(2000);
+    IQSpan<float> out(output);
+
+    size_t n1 = spanResampler.process(whole.subspan(0, 1200), out);
+    size_t n2 = spanResampler.process(whole.subspan(1200, 1200), out.subspan(n1 * 2, out.size() - n1 * 2));
+
+    ASSERT_EQ(n1 * 2, expected1.size());
+    ASSERT_EQ(n2 * 2, expected2.size());
+    for (size_t i = 0; i < expected1.size(); i++) {
+        EXPECT_EQ(output[i], expected1[i]);
+    }
+    for (size_t i = 0; i < expected2.size(); i++) {
+        EXPECT_EQ(output[n1 * 2 + i], expected2[i]);
+    }
+}
+
+// Test: Too-small output span is rejected before any state changes
+TEST_F(IQResamplerCPPTest, SpanOutputTooSmall) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE);
+
+    std::vector<std::complex<float>> input(1200);
+    std::vector<std::complex<float>> output(10);
+
+    EXPECT_THROW(resampler.process(IQSpan<const std::complex<float>>(input.data(), input.size()),
+                                   IQSpan<std::complex<float>>(output)),
+                 std::length_error);
+
+    std::vector<float> oddInput(123);
+    std::vector<float> floatOutput(1000);
+    EXPECT_THROW(resampler.process(IQSpan<const float>(oddInput), IQSpan<float>(floatOutput)),
+                 std::invalid_argument);
+}
+
 // Main function
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+#include "iq_fft.h"
+#include "iq_resampler_cpp.h"
+#include "iq_resampler_fft.h"
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+// Test fixture for FFT overlap-save resampler tests
+class IQResamplerFFTTest : public ::testing::Test {
+protected:
+    static constexpr int INPUT_RATE = 120000;
+    static constexpr int OUTPUT_RATE = 100000;
+
+    // Helper function to generate a test signal with known frequency
+    std::vector<float> generateTestSignal(int numSamples, float sampleRate, float frequency) {
+        std::vector<float> signal(numSamples * 2);
+        float dt = 1.0f / sampleRate;
+
+        for (int i = 0; i < numSamples; i++) {
+            float t = i * dt;
+            float phase = 2.0f * M_PI * frequency * t;
+            signal[i * 2] = std::cos(phase);      // I
+            signal[i * 2 + 1] = std::sin(phase);  // Q
+        }
+
+        return signal;
+    }
+
+    // Helper function to generate a random IQ signal
+    std::vector<float> generateRandomSignal(int numSamples) {
+        std::vector<float> signal(numSamples * 2);
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+        for (size_t i = 0; i < signal.size(); i++) {
+            signal[i] = dis(gen);
+        }
+        return signal;
+    }
+
+    // Largest absolute difference between two equally sized signals
+    float maxAbsDiff(const std::vector<float>& a, const std::vector<float>& b) {
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < a.size(); i++) {
+            maxDiff = std::max(maxDiff, std::abs(a[i] - b[i]));
+        }
+        return maxDiff;
+    }
+};
+
+// Test: Built-in FFT matches a direct DFT for radix-4 and mixed radix-2/4 sizes
+TEST_F(IQResamplerFFTTest, FFTMatchesDFT) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+
+    for (int size : {1, 2, 4, 8, 16, 32, 64, 128, 512}) {
+        std::vector<std::complex<float>> x(size);
+        for (auto& v : x) {
+            v = std::complex<float>(dis(gen), dis(gen));
+        }
+
+        std::vector<std::complex<float>> y = x;
+        IQFFT fft(size);
+        fft.forward(y.data());
+
+        for (int k = 0; k < size; k++) {
+            std::complex<double> sum(0.0, 0.0);
+            for (int n = 0; n < size; n++) {
+                double theta = -2.0 * M_PI * (double)k * n / size;
+                sum += std::complex<double>(x[n]) * std::complex<double>(std::cos(theta), std::sin(theta));
+            }
+            EXPECT_NEAR(y[k].real(), sum.real(), 1e-4 * size) << "size " << size << " bin " << k;
+            EXPECT_NEAR(y[k].imag(), sum.imag(), 1e-4 * size) << "size " << size << " bin " << k;
+        }
+
+        // Inverse is unnormalized
+        fft.inverse(y.data());
+        for (int n = 0; n < size; n++) {
+            EXPECT_NEAR(y[n].real() / size, x[n].real(), 1e-5f);
+            EXPECT_NEAR(y[n].imag() / size, x[n].imag(), 1e-5f);
+        }
+    }
+}
+
+// Test: Non power-of-two FFT sizes are rejected
+TEST_F(IQResamplerFFTTest, FFTInvalidSize) {
+    EXPECT_THROW(IQFFT(0), std::invalid_argument);
+    EXPECT_THROW(IQFFT(96), std::invalid_argument);
+}
+
+// Test: The engine shares the direct form's minimum filter length
+TEST_F(IQResamplerFFTTest, RejectsFiltersTooShortForRatio) {
+    EXPECT_THROW(IQResamplerFFT(48000, 44100), std::invalid_argument);
+    EXPECT_NO_THROW(IQResamplerFFT(48000, 44100, IQFilterDesign::minimumTaps(48000, 44100)));
+}
+
+// Test: FFT engine matches the direct-form polyphase output
+TEST_F(IQResamplerFFTTest, MatchesDirectForm) {
+    struct TestCase {
+        int inputRate;
+        int outputRate;
+        int filterTaps;
+    };
+
+    std::vector<TestCase> testCases = {
+        {120000, 100000, 127},    // 5:6, fold by 2
+        {120000, 100000, 2047},
+        {48000, 44100, 160 * 8},  // 147:160, fold by 32
+        {100000, 50000, 511},     // 2:1 decimation, single branch
+        {50000, 100000, 511},     // 1:2 interpolation, no folding
+        {30000, 100000, 301}      // 10:3 interpolation, odd M
+    };
+
+    for (const auto& tc : testCases) {
+        IQResamplerCPP direct(tc.inputRate, tc.outputRate, tc.filterTaps,
+                              IQResamplerCPP::Mode::PolyphaseDirect);
+        IQResamplerFFT fft(tc.inputRate, tc.outputRate, tc.filterTaps);
+
+        auto input = generateRandomSignal(6000);
+        auto expected = direct.process(input);
+        auto output = fft.process(input);
+
+        ASSERT_EQ(output.size(), expected.size())
+            << tc.inputRate << " to " << tc.outputRate << ", " << tc.filterTaps << " taps";
+        EXPECT_LT(maxAbsDiff(output, expected), 1e-4f)
+            << tc.inputRate << " to " << tc.outputRate << ", " << tc.filterTaps << " taps";
+    }
+}
+
+// Test: Streaming in uneven blocks gives the same output as one call
+TEST_F(IQResamplerFFTTest, StreamingMatchesOneShot) {
+    IQResamplerFFT oneShot(INPUT_RATE, OUTPUT_RATE, 1023);
+    IQResamplerFFT streaming(INPUT_RATE, OUTPUT_RATE, 1023);
+
+    auto input = generateTestSignal(8000, INPUT_RATE, 10000.0f);
+    auto expected = oneShot.process(input);
+
+    std::vector<float> output;
+    size_t pos = 0;
+    const size_t blockSizes[] = {2, 14, 250, 1000, 6, 4000};
+    for (size_t b = 0; pos < input.size(); b++) {
+        size_t len = std::min(blockSizes[b % 6], input.size() - pos);
+        std::vector<float> block(input.begin() + pos, input.begin() + pos + len);
+        auto out = streaming.process(block);
+        output.insert(output.end(), out.begin(), out.end());
+        pos += len;
+    }
+
+    ASSERT_EQ(output.size(), expected.size());
+    EXPECT_LT(maxAbsDiff(output, expected), 1e-5f);
+}
+
+// Test: Blocks of a few samples (pull() chunks, single samples) go
+// through the direct form with the same output as whole blocks
+TEST_F(IQResamplerFFTTest, ShortBlocksMatchDirectForm) {
+    struct TestCase {
+        int inputRate;
+        int outputRate;
+        int filterTaps;
+    };
+
+    std::vector<TestCase> testCases = {
+        {120000, 100000, 2047},
+        {48000, 44100, 160 * 8},
+        {30000, 100000, 301}
+    };
+
+    for (const auto& tc : testCases) {
+        IQResamplerCPP direct(tc.inputRate, tc.outputRate, tc.filterTaps,
+                              IQResamplerCPP::Mode::PolyphaseDirect);
+        IQResamplerFFT fft(tc.inputRate, tc.outputRate, tc.filterTaps);
+
+        auto input = generateRandomSignal(3000);
+        auto expected = direct.process(input);
+
+        std::vector<float> output;
+        size_t pos = 0;
+        const size_t blockSizes[] = {1, 1, 3, 7, 1, 2};
+        for (size_t b = 0; pos < input.size(); b++) {
+            size_t len = std::min(2 * blockSizes[b % 6], input.size() - pos);
+            std::vector<float> block(input.begin() + pos, input.begin() + pos + len);
+            auto out = fft.process(block);
+            output.insert(output.end(), out.begin(), out.end());
+            pos += len;
+        }
+
+        ASSERT_EQ(output.size(), expected.size())
+            << tc.inputRate << " to " << tc.outputRate << ", " << tc.filterTaps << " taps";
+        EXPECT_LT(maxAbsDiff(output, expected), 1e-4f)
+            << tc.inputRate << " to " << tc.outputRate << ", " << tc.filterTaps << " taps";
+    }
+}
+
+// Test: Mode::Polyphase switches to the FFT engine past the crossover
+TEST_F(IQResamplerFFTTest, AutomaticCrossover) {
+    int crossover = IQResamplerCPP::FFT_CROSSOVER_BRANCH_TAPS;
+
+    // 5 branches: taps per branch = ceil(taps / 5)
+    IQResamplerCPP shortFilter(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP longFilter(INPUT_RATE, OUTPUT_RATE, 5 * crossover + 1, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerCPP forcedDirect(INPUT_RATE, OUTPUT_RATE, 5 * crossover + 1,
+                                IQResamplerCPP::Mode::PolyphaseDirect);
+    IQResamplerCPP linear(INPUT_RATE, OUTPUT_RATE, 8191);
+
+    EXPECT_FALSE(shortFilter.usesFFT());
+    EXPECT_TRUE(longFilter.usesFFT());
+    EXPECT_FALSE(forcedDirect.usesFFT());
+    EXPECT_FALSE(linear.usesFFT());
+
+    // Same result either way, including SC16 output through the staging path
+    auto input = generateTestSignal(3000, INPUT_RATE, 10000.0f);
+    auto expected = forcedDirect.process(input);
+    auto output = longFilter.process(input);
+    ASSERT_EQ(output.size(), expected.size());
+    EXPECT_LT(maxAbsDiff(output, expected), 1e-4f);
+
+    auto expectedSC16 = forcedDirect.processSC16(input, 16384.0f);
+    auto outputSC16 = longFilter.processSC16(input, 16384.0f);
+    ASSERT_EQ(outputSC16.size(), expectedSC16.size());
+    for (size_t i = 0; i < outputSC16.size(); i++) {
+        EXPECT_NEAR(outputSC16[i], expectedSC16[i], 1);
+    }
+}
+
+// Test: Reset functionality
+TEST_F(IQResamplerFFTTest, ResetState) {
+    IQResamplerFFT resampler(INPUT_RATE, OUTPUT_RATE, 2047);
+
+    auto input = generateTestSignal(2000, INPUT_RATE, 10000.0f);
+
+    auto output1 = resampler.process(input);
+    resampler.reset();
+    auto output2 = resampler.process(input);
+
+    ASSERT_EQ(output1.size(), output2.size());
+    EXPECT_EQ(maxAbsDiff(output1, output2), 0.0f) << "Reset did not restore initial state";
+}
+
+// Test: Invalid input (odd size)
+TEST_F(IQResamplerFFTTest, InvalidInputSize) {
+    IQResamplerFFT resampler(INPUT_RATE, OUTPUT_RATE);
+
+    std::vector<float> invalidInput(123);
+
+    EXPECT_THROW(resampler.process(invalidInput), std::invalid_argument);
+}
+
+// Main function
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -325,6 +325,48 @@ TEST_F(IQResamplerIPPTest, DifferentFrequencies) {
     }
 }
 
+// Test: outputSamplesFor bounds process() (exact unless M divides n x L),
+// inputSamplesNeededFor is enough, and a buffer of the bound is accepted
+TEST_F(IQResamplerIPPTest, SampleCountQueries) {
+    IQResamplerIPP resampler(INPUT_RATE, OUTPUT_RATE);
+
+    for (int len : {1, 6, 7, 250, 1000, 1200}) {
+        auto input = generateTestSignal(len, INPUT_RATE, 10000.0f);
+        size_t bound = resampler.outputSamplesFor(len);
+        size_t produced = resampler.process(input).size() / 2;
+        EXPECT_LE(produced, bound) << len << " input samples";
+        EXPECT_GE(produced + ((len * 5) % 6 == 0 ? 1 : 0), bound) << len << " input samples";
+
+        std::vector<float> output(bound * 2);
+        EXPECT_EQ(resampler.process(input.data(), len, output.data(), bound), produced);
+        EXPECT_THROW(resampler.process(input.data(), len, output.data(), bound - 1), std::length_error);
+    }
+
+    for (size_t k : {1, 2, 5, 40, 1000}) {
+        size_t needed = resampler.inputSamplesNeededFor(k);
+        EXPECT_GE(resampler.outputSamplesFor(needed), k);
+        EXPECT_LT(resampler.outputSamplesFor(needed - 1), k);
+    }
+
+    EXPECT_GT(resampler.groupDelay(), 0.0);
+}
+
+// Test: The caller-buffer path never grows the scratch; past reserve() it throws
+TEST_F(IQResamplerIPPTest, BlockPastReserve) {
+    IQResamplerIPP resampler(INPUT_RATE, OUTPUT_RATE);
+    resampler.reserve(1000);
+    auto input = generateTestSignal(1200, INPUT_RATE, 10000.0f);
+    std::vector<float> output(resampler.outputSamplesFor(1200) * 2);
+
+    EXPECT_THROW(resampler.process(input.data(), 1200, output.data(), output.size() / 2), std::length_error);
+    EXPECT_EQ(resampler.maxBlockSamples(), 1000u);
+
+    // The vector overload allocates anyway and grows it
+    EXPECT_FALSE(resampler.process(input).empty());
+    EXPECT_EQ(resampler.maxBlockSamples(), 1200u);
+    EXPECT_GT(resampler.process(input.data(), 1200, output.data(), output.size() / 2), 0u);
+}
+
 // Test: Performance comparison test (for information only)
 TEST_F(IQResamplerIPPTest, PerformanceInfo) {
     IQResamplerIPP resampler(INPUT_RATE, OUTPUT_RATE);
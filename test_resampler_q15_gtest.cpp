@@ -0,0 +1,362 @@
+#include <gtest/gtest.h>
+#include "iq_resampler_cpp.h"
+#include "iq_quality.h"
+#include "iq_resampler_q15.h"
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Test fixture for IQ Resampler fixed-point (Q15) implementation tests
+class IQResamplerQ15Test : public ::testing::Test {
+protected:
+    static constexpr int INPUT_RATE = 120000;
+    static constexpr int OUTPUT_RATE = 100000;
+
+    // Helper function to generate a test signal with known frequency
+    std::vector<float> generateTestSignal(int numSamples, float sampleRate, float frequency,
+                                          float amplitude = 0.5f) {
+        std::vector<float> signal(numSamples * 2);
+        float dt = 1.0f / sampleRate;
+
+        for (int i = 0; i < numSamples; i++) {
+            float t = i * dt;
+            float phase = 2.0f * M_PI * frequency * t;
+            signal[i * 2] = amplitude * std::cos(phase);      // I
+            signal[i * 2 + 1] = amplitude * std::sin(phase);  // Q
+        }
+
+        return signal;
+    }
+
+    // Helper function to convert a float IQ signal to SC16
+    std::vector<int16_t> toSC16(const std::vector<float>& signal) {
+        std::vector<int16_t> out(signal.size());
+        for (size_t i = 0; i < signal.size(); i++) {
+            out[i] = (int16_t)std::lrint(signal[i] * 32767.0f);
+        }
+        return out;
+    }
+
+    // Helper function to compute SNR (dB) of a signal against a reference
+    double computeSNR(const std::vector<float>& reference, const std::vector<float>& signal) {
+        double signalPower = 0.0;
+        double noisePower = 0.0;
+        for (size_t i = 0; i < reference.size(); i++) {
+            double err = (double)signal[i] - reference[i];
+            signalPower += (double)reference[i] * reference[i];
+            noisePower += err * err;
+        }
+        return 10.0 * std::log10(signalPower / noisePower);
+    }
+};
+
+// Test: Basic initialization
+TEST_F(IQResamplerQ15Test, Initialization) {
+    EXPECT_NO_THROW({
+        IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE);
+    });
+}
+
+// Test: Q15 output tracks the float polyphase path
+TEST_F(IQResamplerQ15Test, SNRAgainstFloatPath) {
+    struct TestCase {
+        int inputRate;
+        int outputRate;
+        int filterTaps;
+    };
+
+    // Both paths share the prototype, so this only checks the fixed-point
+    // arithmetic; AbsoluteQuality checks the filter itself
+    std::vector<TestCase> testCases = {
+        {120000, 100000, 127},   // 5:6 ratio
+        {48000, 44100, 160 * 8}, // Common audio resampling, shortest filter allowed
+        {100000, 50000, 127},    // 2:1 downsampling
+        {50000, 100000, 127}     // 1:2 upsampling
+    };
+
+    for (const auto& tc : testCases) {
+        IQResamplerCPP floatResampler(tc.inputRate, tc.outputRate, tc.filterTaps,
+                                      IQResamplerCPP::Mode::Polyphase);
+        IQResamplerQ15 fixedResampler(tc.inputRate, tc.outputRate, tc.filterTaps);
+
+        auto input = generateTestSignal(4800, tc.inputRate, tc.inputRate / 20.0f);
+        auto expected = floatResampler.process(input);
+        auto output = fixedResampler.process(input);
+
+        ASSERT_EQ(output.size(), expected.size())
+            << "Output size differs for " << tc.inputRate << " to " << tc.outputRate;
+
+        double snr = computeSNR(expected, output);
+        EXPECT_GT(snr, 70.0)
+            << "Q15 SNR too low for " << tc.inputRate << " to " << tc.outputRate << ": " << snr << " dB";
+    }
+}
+
+// Test: Filters too short to give every branch real taps are rejected
+TEST_F(IQResamplerQ15Test, RejectsFiltersTooShortForRatio) {
+    // 147 branches: 127 taps would leave most of them empty
+    EXPECT_THROW(IQResamplerQ15(48000, 44100), std::invalid_argument);
+    EXPECT_THROW(IQResamplerQ15(48000, 44100, IQFilterDesign::minimumTaps(48000, 44100) - 1),
+                 std::invalid_argument);
+    EXPECT_NO_THROW(IQResamplerQ15(48000, 44100, IQFilterDesign::minimumTaps(48000, 44100)));
+    EXPECT_EQ(IQFilterDesign::minimumTaps(INPUT_RATE, OUTPUT_RATE), 48);
+    EXPECT_EQ(IQFilterDesign::minimumTaps(8000, 11025), 8 * 441);
+}
+
+// Test: Measured against the exact tones (not another resampler), the
+// default and the shortest allowed filters actually filter
+TEST_F(IQResamplerQ15Test, AbsoluteQuality) {
+    struct TestCase {
+        int inputRate;
+        int outputRate;
+        int filterTaps;
+        double minSnrDb;
+    };
+    std::vector<TestCase> testCases = {
+        {120000, 100000, 127, 55.0},
+        {48000, 44100, IQFilterDesign::minimumTaps(48000, 44100), 55.0},
+        {96000, 44100, IQFilterDesign::minimumTaps(96000, 44100), 55.0},
+        {44100, 48000, IQFilterDesign::minimumTaps(44100, 48000), 25.0},
+    };
+
+    for (const auto& tc : testCases) {
+        const int taps = tc.filterTaps;
+        IQQualityReport fixed = IQQuality::measure([&tc, taps]() {
+            std::shared_ptr<IQResamplerQ15> r(new IQResamplerQ15(tc.inputRate, tc.outputRate, taps));
+            return IQQuality::ProcessFunction([r](const std::vector<float>& in) { return r->process(in); });
+        }, tc.inputRate, tc.outputRate);
+        IQQualityReport floating = IQQuality::measure([&tc, taps]() {
+            std::shared_ptr<IQResamplerCPP> r(
+                new IQResamplerCPP(tc.inputRate, tc.outputRate, taps, IQResamplerCPP::Mode::Polyphase));
+            return IQQuality::ProcessFunction([r](const std::vector<float>& in) { return r->process(in); });
+        }, tc.inputRate, tc.outputRate);
+
+        EXPECT_GT(fixed.snrDb, tc.minSnrDb) << tc.inputRate << " to " << tc.outputRate << ", " << taps << " taps";
+        EXPECT_GT(floating.snrDb, tc.minSnrDb) << tc.inputRate << " to " << tc.outputRate << ", " << taps << " taps";
+    }
+}
+
+// Test: Splitting the stream into blocks gives bit-identical output
+TEST_F(IQResamplerQ15Test, StreamingIsBitExact) {
+    IQResamplerQ15 oneShot(INPUT_RATE, OUTPUT_RATE);
+    IQResamplerQ15 streaming(INPUT_RATE, OUTPUT_RATE);
+
+    auto input = toSC16(generateTestSignal(6000, INPUT_RATE, 10000.0f, 0.9f));
+    auto expected = oneShot.processSC16(input);
+
+    std::vector<int16_t> output;
+    size_t pos = 0;
+    const size_t blockSizes[] = {2, 14, 250, 1000, 6, 4000};
+    for (size_t b = 0; pos < input.size(); b++) {
+        size_t len = std::min(blockSizes[b % 6], input.size() - pos);
+        std::vector<int16_t> block(input.begin() + pos, input.begin() + pos + len);
+        auto out = streaming.processSC16(block);
+        output.insert(output.end(), out.begin(), out.end());
+        pos += len;
+    }
+
+    ASSERT_EQ(output.size(), expected.size());
+    EXPECT_TRUE(output == expected) << "Streaming output is not bit-exact";
+}
+
+// Test: Reset restores the initial state exactly
+TEST_F(IQResamplerQ15Test, ResetState) {
+    IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE);
+
+    auto input = toSC16(generateTestSignal(1000, INPUT_RATE, 10000.0f));
+
+    auto output1 = resampler.processSC16(input);
+    resampler.reset();
+    auto output2 = resampler.processSC16(input);
+
+    EXPECT_TRUE(output1 == output2) << "Reset did not restore initial state";
+}
+
+// Test: DC signal preservation
+TEST_F(IQResamplerQ15Test, DCSignalPreservation) {
+    IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE);
+
+    std::vector<float> input(12000 * 2);
+    for (size_t i = 0; i < input.size(); i += 2) {
+        input[i] = 0.5f;
+        input[i + 1] = -0.25f;
+    }
+
+    auto output = resampler.process(input);
+    ASSERT_GT(output.size(), 400u);
+
+    // Skip the filter startup transient
+    for (size_t i = 400; i < output.size(); i += 2) {
+        EXPECT_NEAR(output[i], 0.5f, 1e-3f);
+        EXPECT_NEAR(output[i + 1], -0.25f, 1e-3f);
+    }
+}
+
+// Test: Full-scale input saturates instead of wrapping
+TEST_F(IQResamplerQ15Test, FullScaleSaturates) {
+    IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE);
+
+    // Square wave at full scale overshoots after filtering
+    std::vector<int16_t> input(4000 * 2);
+    for (size_t i = 0; i < input.size(); i += 2) {
+        int16_t v = ((i / 2) / 40) % 2 ? 32767 : -32768;
+        input[i] = v;
+        input[i + 1] = v;
+    }
+
+    auto output = resampler.processSC16(input);
+    ASSERT_GT(output.size(), 0u);
+
+    // Sign must follow the input square wave (no wrap-around from overflow)
+    IQResamplerCPP reference(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    auto expected = reference.process(input, 1.0f / 32768.0f);
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_NEAR(output[i] / 32768.0f, std::max(-1.0f, std::min(expected[i], 32767.0f / 32768.0f)), 1e-3f);
+    }
+}
+
+// Test: Invalid input (odd size)
+TEST_F(IQResamplerQ15Test, InvalidInputSize) {
+    IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE);
+
+    std::vector<float> invalidFloat(123);
+    std::vector<int16_t> invalidSC16(123);
+
+    EXPECT_THROW(resampler.process(invalidFloat), std::invalid_argument);
+    EXPECT_THROW(resampler.processSC16(invalidSC16), std::invalid_argument);
+}
+
+// Test: Empty input
+TEST_F(IQResamplerQ15Test, EmptyInput) {
+    IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE);
+
+    std::vector<int16_t> emptyInput;
+
+    auto output = resampler.processSC16(emptyInput);
+    EXPECT_EQ(output.size(), 0u) << "Empty input should produce empty output";
+}
+
+// Test: Caller buffers match the vector path, across reserve() splits
+TEST_F(IQResamplerQ15Test, CallerBuffersMatchVectorPath) {
+    IQResamplerQ15 vectorPath(INPUT_RATE, OUTPUT_RATE);
+    IQResamplerQ15 bufferPath(INPUT_RATE, OUTPUT_RATE);
+    bufferPath.reserve(100);  // Split every call into 100-sample pieces
+
+    auto input = toSC16(generateTestSignal(1234, INPUT_RATE, 10000.0f, 0.9f));
+    std::vector<int16_t> output;
+    for (int call = 0; call < 3; call++) {
+        auto expected = vectorPath.processSC16(input);
+        size_t capacity = bufferPath.outputSamplesFor(input.size() / 2);
+        EXPECT_EQ(capacity * 2, expected.size());
+        output.assign(2 * capacity, 0);
+        size_t produced = bufferPath.processSC16(input.data(), input.size() / 2, output.data(), capacity);
+        ASSERT_EQ(produced * 2, expected.size());
+        EXPECT_TRUE(output == expected) << "call " << call;
+    }
+
+    EXPECT_THROW(bufferPath.processSC16(input.data(), input.size() / 2, output.data(), 1), std::length_error);
+}
+
+// Test: SC8 is Q15 shifted up 8 bits, so it matches SC16 bit for bit
+TEST_F(IQResamplerQ15Test, SC8MatchesSC16) {
+    IQResamplerQ15 sc8(INPUT_RATE, OUTPUT_RATE);
+    IQResamplerQ15 sc16(INPUT_RATE, OUTPUT_RATE);
+
+    auto signal = generateTestSignal(1500, INPUT_RATE, 10000.0f, 0.9f);
+    std::vector<int8_t> input8(signal.size());
+    std::vector<int16_t> input16(signal.size());
+    for (size_t i = 0; i < signal.size(); i++) {
+        input8[i] = (int8_t)std::lrint(signal[i] * 127.0f);
+        input16[i] = (int16_t)(input8[i] * 256);
+    }
+
+    auto expected = sc16.processSC16(input16);
+    EXPECT_TRUE(sc8.processSC16(input8) == expected);
+
+    // Float output is the same Q15 values, scaled
+    IQResamplerQ15 floatOut(INPUT_RATE, OUTPUT_RATE);
+    auto output = floatOut.process(input8);
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        EXPECT_EQ(output[i], expected[i] / 32768.0f);
+    }
+
+    // Caller buffers
+    sc8.reset();
+    std::vector<int16_t> buffer(expected.size());
+    EXPECT_EQ(sc8.processSC16(input8.data(), input8.size() / 2, buffer.data(), buffer.size() / 2) * 2,
+              expected.size());
+    EXPECT_TRUE(buffer == expected);
+}
+
+// Test: Size queries match process() at every phase, as for IQResamplerCPP
+TEST_F(IQResamplerQ15Test, SampleCountQueries) {
+    IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE);
+    auto input = toSC16(generateTestSignal(200, INPUT_RATE, 10000.0f));
+
+    for (size_t len = 1; len <= 13; len++) {
+        size_t needed = resampler.inputSamplesNeededFor(len);
+        EXPECT_GE(resampler.outputSamplesFor(needed), len);
+        EXPECT_LT(resampler.outputSamplesFor(needed - 1), len);
+
+        size_t expected = resampler.outputSamplesFor(len);
+        EXPECT_LE(expected, resampler.maxOutputSamplesFor(len));
+        std::vector<int16_t> block(input.begin(), input.begin() + 2 * len);
+        EXPECT_EQ(resampler.processSC16(block).size(), 2 * expected);
+    }
+    EXPECT_EQ(resampler.inputSamplesNeededFor(0), 0u);
+}
+
+// Test: Scratch lives in an arena placed per policy; reserve() mid-stream
+// and copies keep the history, so output stays bit-exact
+TEST_F(IQResamplerQ15Test, ArenaReserveAndCopyKeepState) {
+    IQResamplerQ15 reference(INPUT_RATE, OUTPUT_RATE);
+    IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE);
+    EXPECT_EQ(resampler.maxBlockSamples(), IQResamplerQ15::DEFAULT_MAX_BLOCK_SAMPLES);
+    EXPECT_GT(resampler.arena().capacity(), 0u);
+
+    auto input = toSC16(generateTestSignal(777, INPUT_RATE, 10000.0f, 0.9f));
+    EXPECT_TRUE(resampler.processSC16(input) == reference.processSC16(input));
+
+    resampler.reserve(300, IQMemoryPolicy(true, IQMemoryPolicy::LOCAL_NODE));
+    EXPECT_EQ(resampler.maxBlockSamples(), 300u);
+    EXPECT_EQ(resampler.arena().policy().numaNode, IQMemoryPolicy::LOCAL_NODE);
+
+    IQResamplerQ15 copy(resampler);
+    EXPECT_EQ(copy.maxBlockSamples(), 300u);
+    EXPECT_EQ(copy.arena().policy().numaNode, IQMemoryPolicy::LOCAL_NODE);
+
+    auto expected = reference.processSC16(input);
+    EXPECT_TRUE(resampler.processSC16(input) == expected);
+    EXPECT_TRUE(copy.processSC16(input) == expected);
+
+    // Over budget: refused, and the resampler carries on as before
+    EXPECT_THROW(resampler.reserve(100000, IQMemoryPolicy(false, IQMemoryPolicy::ANY_NODE, 4096)),
+                 std::bad_alloc);
+    EXPECT_EQ(resampler.maxBlockSamples(), 300u);
+    EXPECT_TRUE(resampler.processSC16(input) == reference.processSC16(input));
+}
+
+// Test: The quantized bank does not depend on the build; pinned by a hash
+// of the 120k -> 100k, 127-tap design (changes only with the filter design)
+TEST_F(IQResamplerQ15Test, QuantizedBankIsPinned) {
+    IQResamplerQ15 resampler(INPUT_RATE, OUTPUT_RATE, 127);
+    const std::vector<int16_t>& bank = resampler.polyphaseBank();
+    ASSERT_EQ(bank.size(), (size_t)5 * resampler.branchLength());
+
+    uint32_t hash = 2166136261u;  // FNV-1a over the taps
+    for (size_t i = 0; i < bank.size(); i++) {
+        hash = (hash ^ (uint16_t)bank[i]) * 16777619u;
+    }
+    EXPECT_EQ(resampler.coefficientShift(), 15);
+    const uint32_t expectedHash = 2604014964u;
+    EXPECT_EQ(hash, expectedHash);
+}
+
+// Main function
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
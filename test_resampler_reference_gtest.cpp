@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "iq_resampler_reference.h"
+#include "iq_resampler_cpp.h"
+#include "iq_resampler_q15.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+// Test fixture for the double-precision reference resampler
+class IQResamplerReferenceTest : public ::testing::Test {
+protected:
+    struct Ratio {
+        int inputRate;
+        int outputRate;
+    };
+
+    // Ratios covering decimation, interpolation, a single-branch (L = 1)
+    // bank and a large L
+    std::vector<Ratio> ratios() {
+        return {{120000, 100000}, {100000, 120000}, {120000, 60000}, {48000, 44100}};
+    }
+
+    // Full-band noise, so every tap and phase contributes
+    std::vector<float> generateNoise(int numSamples) {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<float> dis(-0.5f, 0.5f);
+        std::vector<float> signal(numSamples * 2);
+        for (auto& v : signal) {
+            v = dis(gen);
+        }
+        return signal;
+    }
+
+    // Sum of tones (Hz) at rate, unit total amplitude
+    std::vector<float> generateTones(int numSamples, double rate, const std::vector<double>& frequencies) {
+        std::vector<float> signal(numSamples * 2);
+        for (int i = 0; i < numSamples; i++) {
+            std::complex<double> sum(0.0, 0.0);
+            for (size_t k = 0; k < frequencies.size(); k++) {
+                sum += std::polar(1.0 / frequencies.size(), 2.0 * M_PI * frequencies[k] * i / rate + k);
+            }
+            signal[i * 2] = (float)sum.real();
+            signal[i * 2 + 1] = (float)sum.imag();
+        }
+        return signal;
+    }
+};
+
+// Test: Fast kernels reproduce the exact evaluation of their own prototype
+// to within float rounding (the error budget of the arithmetic alone)
+TEST_F(IQResamplerReferenceTest, KernelErrorBudget) {
+    struct ModeCase {
+        IQResamplerCPP::Mode mode;
+        int taps;
+        double maxErrorDb;
+    };
+    std::vector<ModeCase> modes = {
+        {IQResamplerCPP::Mode::PolyphaseDirect, 127, -130.0},
+        {IQResamplerCPP::Mode::LowLatency, 127, -130.0},
+        {IQResamplerCPP::Mode::PolyphaseFFT, 1023, -125.0},
+    };
+    auto input = generateNoise(6000);
+
+    for (const auto& ratio : ratios()) {
+        for (const auto& m : modes) {
+            // Large L needs a longer prototype than the mode's default
+            int taps = std::max(m.taps, IQFilterDesign::minimumTaps(ratio.inputRate, ratio.outputRate));
+            IQResamplerCPP resampler(ratio.inputRate, ratio.outputRate, taps, m.mode);
+            auto output = resampler.process(input);
+
+            IQResamplerReference reference(ratio.inputRate, ratio.outputRate, resampler.filterCoefficients());
+            auto expected = reference.process(input);
+            ASSERT_EQ(output.size() / 2, expected.size());
+            EXPECT_NEAR(reference.groupDelay(), resampler.groupDelay(), 1e-9);
+
+            IQErrorBudget budget = IQResamplerReference::compare(expected.data(), output.data(), expected.size());
+            EXPECT_LT(budget.errorDb, m.maxErrorDb)
+                << ratio.inputRate << " -> " << ratio.outputRate << ", " << taps << " taps";
+            EXPECT_LT(budget.maxAbsError, 1e-6);
+        }
+    }
+}
+
+// Test: Fixed point stays within its Q15 quantization budget
+TEST_F(IQResamplerReferenceTest, Q15ErrorBudget) {
+    auto input = generateNoise(6000);
+    IQResamplerQ15 q15(120000, 100000, 127);
+    auto output = q15.process(input);
+
+    // Same Hamming prototype as the float resampler
+    IQResamplerCPP floating(120000, 100000, 127, IQResamplerCPP::Mode::Polyphase);
+    IQResamplerReference reference(120000, 100000, floating.filterCoefficients());
+    auto expected = reference.process(input);
+    ASSERT_EQ(output.size() / 2, expected.size());
+
+    IQErrorBudget budget = IQResamplerReference::compare(expected.data(), output.data(), expected.size());
+    EXPECT_LT(budget.errorDb, -70.0);
+    EXPECT_GT(budget.errorDb, -110.0);  // Worse than float: quantization shows
+    EXPECT_LT(budget.maxAbsError, 4.0 / 32768.0);
+}
+
+// Test: The ideal reference reproduces bandlimited tones exactly
+TEST_F(IQResamplerReferenceTest, IdealReproducesTones) {
+    for (const auto& ratio : ratios()) {
+        double band = 0.4 * std::min(ratio.inputRate, ratio.outputRate);
+        std::vector<double> frequencies = {-0.9 * band, -0.31 * band, 0.0, 0.57 * band, band};
+        auto input = generateTones(4000, ratio.inputRate, frequencies);
+
+        const double delay = 10.25;
+        IQResamplerReference reference(ratio.inputRate, ratio.outputRate, delay, 256, 14.0);
+        EXPECT_EQ(reference.groupDelay(), delay);
+        auto output = reference.process(input);
+
+        // Away from the ends (zero extension), output n is the tones at
+        // input time n x in / out - delay
+        double maxError = 0.0;
+        size_t edge = (size_t)(300.0 * ratio.outputRate / std::min(ratio.inputRate, ratio.outputRate));
+        for (size_t n = edge; n + edge < output.size(); n++) {
+            double t = (double)n * ratio.inputRate / ratio.outputRate - delay;
+            std::complex<double> ideal(0.0, 0.0);
+            for (size_t k = 0; k < frequencies.size(); k++) {
+                ideal += std::polar(1.0 / frequencies.size(), 2.0 * M_PI * frequencies[k] * t / ratio.inputRate + k);
+            }
+            maxError = std::max(maxError, std::abs(output[n] - ideal));
+        }
+        EXPECT_LT(maxError, 1e-6) << ratio.inputRate << " -> " << ratio.outputRate;
+    }
+}
+
+// Test: A spec-driven resampler matches the ideal one to within its spec
+TEST_F(IQResamplerReferenceTest, SpecDesignAgainstIdeal) {
+    const int inputRate = 120000;
+    const int outputRate = 100000;
+    std::vector<double> frequencies = {-35000.0, -12000.0, 3000.0, 21000.0, 38000.0};
+    auto input = generateTones(8000, inputRate, frequencies);
+
+    IQResamplerCPP resampler(inputRate, outputRate, IQFilterSpec(0.8, 100.0, 0.001));
+    auto output = resampler.process(input);
+
+    IQResamplerReference reference(inputRate, outputRate, resampler.groupDelay());
+    auto expected = reference.process(input);
+    ASSERT_EQ(output.size() / 2, expected.size());
+
+    // Skip the warm-up and the tail, where the two see different zeros
+    size_t edge = 1000;
+    IQErrorBudget budget = IQResamplerReference::compare(expected.data(), output.data(),
+                                                         expected.size() - edge, edge);
+    EXPECT_LT(budget.errorDb, -95.0);
+}
+
+// Test: Output counts match a fresh streaming resampler, errors are checked
+TEST_F(IQResamplerReferenceTest, CountsAndValidation) {
+    for (const auto& ratio : ratios()) {
+        int taps = std::max(127, IQFilterDesign::minimumTaps(ratio.inputRate, ratio.outputRate));
+        IQResamplerCPP resampler(ratio.inputRate, ratio.outputRate, taps, IQResamplerCPP::Mode::Polyphase);
+        IQResamplerReference reference(ratio.inputRate, ratio.outputRate);
+        for (size_t n : {1u, 7u, 1000u, 4801u}) {
+            EXPECT_EQ(reference.outputSamplesFor(n), resampler.outputSamplesFor(n));
+        }
+    }
+
+    EXPECT_THROW(IQResamplerReference(0, 100), std::invalid_argument);
+    EXPECT_THROW(IQResamplerReference(100, 100, 0.0, 0), std::invalid_argument);
+    EXPECT_THROW(IQResamplerReference(100, 100, std::vector<float>()), std::invalid_argument);
+    EXPECT_THROW(IQResamplerReference(100, 100).process(std::vector<float>(3)), std::invalid_argument);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "iq_telemetry.h"
+#include "iq_resampler_cpp.h"
+#include "iq_ring_buffer.h"
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Test fixture for per-resampler runtime telemetry
+class IQTelemetryTest : public ::testing::Test {
+protected:
+    const int INPUT_RATE = 120000;
+    const int OUTPUT_RATE = 100000;
+
+    void SetUp() override {
+        if (!IQTelemetry::ENABLED) {
+            GTEST_SKIP() << "built with IQ_NO_TELEMETRY";
+        }
+    }
+
+    std::vector<std::complex<float> > generateTestSignal(int numSamples) {
+        std::vector<std::complex<float> > signal(numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            double phase = 2.0 * M_PI * 1000.0 * i / INPUT_RATE;
+            signal[i] = std::complex<float>(std::cos(phase), std::sin(phase));
+        }
+        return signal;
+    }
+
+    static uint64_t histogramTotal(const IQTelemetrySnapshot& s) {
+        uint64_t total = 0;
+        for (int b = 0; b < IQTelemetrySnapshot::HISTOGRAM_BUCKETS; b++) {
+            total += s.histogram[b];
+        }
+        return total;
+    }
+};
+
+// Test: Calls and samples add up to what went through process()
+TEST_F(IQTelemetryTest, CountsCallsAndSamples) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    auto input = generateTestSignal(1200);
+    std::vector<std::complex<float> > output(resampler.outputSamplesFor(input.size()) + 1);
+
+    size_t produced = 0;
+    for (int i = 0; i < 10; i++) {
+        produced += resampler.process(input.data(), input.size(), output.data(), output.size());
+    }
+
+    IQTelemetrySnapshot s = resampler.telemetry().snapshot();
+    EXPECT_EQ(s.calls, 10u);
+    EXPECT_EQ(s.inputSamples, 12000u);
+    EXPECT_EQ(s.outputSamples, produced);
+    EXPECT_EQ(histogramTotal(s), s.calls);
+    EXPECT_GT(s.totalTicks, 0u);
+    EXPECT_LE(s.maxTicks, s.totalTicks);
+    EXPECT_EQ(s.underruns, 0u);
+    EXPECT_EQ(s.overruns, 0u);
+
+    // reset() starts a new stream but keeps the statistics
+    resampler.reset();
+    EXPECT_EQ(resampler.telemetry().snapshot().calls, 10u);
+    resampler.telemetry().reset();
+    EXPECT_EQ(resampler.telemetry().snapshot().calls, 0u);
+}
+
+// Test: Times convert to plausible durations
+TEST_F(IQTelemetryTest, TimesAreConsistent) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    auto input = generateTestSignal(4096);
+    std::vector<std::complex<float> > output(resampler.outputSamplesFor(input.size()) + 1);
+    for (int i = 0; i < 50; i++) {
+        resampler.process(input.data(), input.size(), output.data(), output.size());
+    }
+
+    IQTelemetrySnapshot s = resampler.telemetry().snapshot();
+    ASSERT_GT(s.ticksPerSecond, 0.0);
+    double mean = s.meanNs();
+    EXPECT_GT(mean, 0.0);
+    EXPECT_LT(mean, 1e9);
+    EXPECT_LE(s.percentileNs(0.5), s.percentileNs(0.99));
+    EXPECT_LE(s.percentileNs(0.99), s.maxTicks / s.ticksPerSecond * 1e9 + 1e-6);
+    EXPECT_NEAR(s.totalSeconds() * 1e9, mean * s.calls, mean * s.calls * 1e-9 + 1.0);
+}
+
+// Test: Starved pulls and undersized outputs are counted
+TEST_F(IQTelemetryTest, CountsUnderrunsAndOverruns) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQRingBuffer ring(1024);
+    auto input = generateTestSignal(600);
+    ring.write(input.data(), input.size());
+    resampler.setInputSource(ring, 256);
+
+    std::vector<std::complex<float> > output(1000);
+    size_t got = resampler.pull(output.data(), output.size());
+    EXPECT_LT(got, output.size());
+    EXPECT_EQ(resampler.telemetry().snapshot().underruns, 1u);
+
+    EXPECT_THROW(resampler.process(input.data(), input.size(), output.data(), 1), std::length_error);
+    EXPECT_EQ(resampler.telemetry().snapshot().overruns, 1u);
+}
+
+// Test: Another thread can read the counters while the resampler runs
+TEST_F(IQTelemetryTest, ReadableFromAnotherThread) {
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    auto input = generateTestSignal(256);
+    std::vector<std::complex<float> > output(resampler.outputSamplesFor(input.size()) + 1);
+    const uint64_t CALLS = 2000;
+
+    std::atomic<bool> done(false);
+    uint64_t lastSeen = 0;
+    bool monotonic = true;
+    std::thread reader([&]() {
+        while (!done.load(std::memory_order_acquire)) {
+            uint64_t calls = resampler.telemetry().snapshot().calls;
+            monotonic = monotonic && calls >= lastSeen && calls <= CALLS;
+            lastSeen = calls;
+        }
+    });
+    for (uint64_t i = 0; i < CALLS; i++) {
+        resampler.process(input.data(), input.size(), output.data(), output.size());
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_TRUE(monotonic);
+    EXPECT_EQ(resampler.telemetry().snapshot().calls, CALLS);
+}
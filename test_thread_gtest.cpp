@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+#include "iq_thread.h"
+#include "iq_resampler_cpp.h"
+#include "iq_ring_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Test fixture for thread configuration and the pipeline worker
+class IQThreadTest : public ::testing::Test {
+protected:
+    const int INPUT_RATE = 120000;
+    const int OUTPUT_RATE = 100000;
+
+    std::vector<std::complex<float> > generateTestSignal(int numSamples, float sampleRate, float frequency) {
+        std::vector<std::complex<float> > signal(numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            double phase = 2.0 * M_PI * frequency * i / sampleRate;
+            signal[i] = std::complex<float>(std::cos(phase), std::sin(phase));
+        }
+        return signal;
+    }
+
+    // Wait (up to a few seconds) until the worker has processed blocks
+    bool waitForBlocks(const IQResamplerWorker& worker, uint64_t blocks) {
+        for (int i = 0; i < 5000 && worker.stats().blocks < blocks; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return worker.stats().blocks >= blocks;
+    }
+};
+
+// Test: Default config changes nothing and reports success
+TEST_F(IQThreadTest, DefaultConfig) {
+    IQThreadStatus status = applyThreadConfig(IQThreadConfig());
+    EXPECT_TRUE(status.affinityApplied);
+    EXPECT_TRUE(status.schedulingApplied);
+    EXPECT_FALSE(status.memoryLocked);
+    EXPECT_EQ(status.error, 0);
+}
+
+#if defined(__linux__)
+// Test: A thread pinned to one CPU stays there
+TEST_F(IQThreadTest, PinsAffinity) {
+    IQThreadConfig config;
+    config.cpus.push_back(sched_getcpu());
+
+    IQThreadStatus status;
+    int cpuAfter = -1;
+    std::thread t([&]() {
+        status = applyThreadConfig(config);
+        std::this_thread::yield();
+        cpuAfter = sched_getcpu();
+    });
+    t.join();
+
+    ASSERT_TRUE(status.affinityApplied);
+    EXPECT_EQ(cpuAfter, config.cpus[0]);
+}
+
+// Test: Real-time scheduling is applied when permitted, reported when not
+TEST_F(IQThreadTest, RealtimeSchedulingDegrades) {
+    IQThreadConfig config;
+    config.scheduling = IQThreadConfig::Scheduling::Fifo;
+    config.priority = 1000;  // Clamped to the maximum
+
+    IQThreadStatus status;
+    int policy = -1;
+    std::thread t([&]() {
+        status = applyThreadConfig(config);
+        sched_param param;
+        pthread_getschedparam(pthread_self(), &policy, &param);
+    });
+    t.join();
+
+    if (status.schedulingApplied) {
+        EXPECT_EQ(policy, SCHED_FIFO);
+        EXPECT_EQ(status.error, 0);
+    } else {
+        EXPECT_EQ(policy, SCHED_OTHER);
+        EXPECT_NE(status.error, 0);
+    }
+}
+#endif
+
+// Test: The worker's output matches processing the same blocks directly
+TEST_F(IQThreadTest, WorkerMatchesDirectProcessing) {
+    const size_t block = 600;
+    const int blocks = 10;
+    auto input = generateTestSignal(block * blocks, INPUT_RATE, 10000.0f);
+
+    IQResamplerCPP reference(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    std::vector<std::complex<float> > expected(reference.outputSamplesFor(input.size()));
+    size_t expectedCount = reference.process(input.data(), input.size(), expected.data(), expected.size());
+
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::Polyphase);
+    IQRingBuffer in(8192);
+    IQRingBuffer out(8192);
+    ASSERT_EQ(in.write(input.data(), input.size()), input.size());
+
+    IQResamplerWorker worker(resampler, in, out, block);
+    EXPECT_EQ(worker.period(), 5000000);  // 600 samples at 120 kHz
+    worker.setPeriod(200000);
+
+    std::atomic<int> observed(0);
+    worker.setLatencyObserver([&observed](int64_t latency) {
+        EXPECT_GE(latency, 0);
+        observed++;
+    });
+
+    worker.start();
+    EXPECT_TRUE(worker.running());
+    EXPECT_TRUE(worker.threadStatus().affinityApplied);
+    ASSERT_TRUE(waitForBlocks(worker, blocks));
+    worker.stop();
+    EXPECT_FALSE(worker.running());
+
+    IQDeadlineStats stats = worker.stats();
+    EXPECT_EQ(stats.blocks, (uint64_t)blocks);
+    EXPECT_EQ(observed.load(), blocks);
+    EXPECT_EQ(stats.droppedSamples, 0u);
+
+    ASSERT_EQ(out.available(), expectedCount);
+    std::vector<std::complex<float> > output(expectedCount);
+    out.read(output.data(), expectedCount);
+    for (size_t i = 0; i < expectedCount; i++) {
+        ASSERT_EQ(output[i], expected[i]) << "at " << i;
+    }
+}
+
+// Test: Linear upsampling, where later blocks produce more output than
+// the first, runs with no lost blocks
+TEST_F(IQThreadTest, WorkerLinearUpsampling) {
+    const size_t block = 256;
+    const int blocks = 12;
+    auto input = generateTestSignal(block * blocks, 25000, 1000.0f);
+
+    // Block by block, as the worker sees it: 1021 outputs first, 1024 after
+    IQResamplerCPP reference(25000, 100000, 127, IQResamplerCPP::Mode::Linear);
+    std::vector<std::complex<float> > expected(4 * block * blocks);
+    size_t expectedCount = 0;
+    for (int b = 0; b < blocks; b++) {
+        size_t n = reference.outputSamplesFor(block);
+        EXPECT_LE(n, reference.maxOutputSamplesFor(block));
+        expectedCount += reference.process(input.data() + b * block, block, expected.data() + expectedCount, n);
+    }
+
+    IQResamplerCPP resampler(25000, 100000, 127, IQResamplerCPP::Mode::Linear);
+    IQRingBuffer in(8192);
+    IQRingBuffer out(16384);
+    ASSERT_EQ(in.write(input.data(), input.size()), input.size());
+
+    IQResamplerWorker worker(resampler, in, out, block);
+    worker.setPeriod(200000);
+    worker.start();
+    ASSERT_TRUE(waitForBlocks(worker, blocks));
+    worker.stop();
+
+    IQDeadlineStats stats = worker.stats();
+    EXPECT_EQ(stats.errors, 0u);
+    EXPECT_EQ(stats.droppedSamples, 0u);
+    ASSERT_EQ(out.available(), expectedCount);
+    std::vector<std::complex<float> > output(expectedCount);
+    out.read(output.data(), expectedCount);
+    for (size_t i = 0; i < expectedCount; i++) {
+        ASSERT_EQ(output[i], expected[i]) << "at " << i;
+    }
+}
+
+// Test: Deadlines shorter than the processing time are reported as missed;
+// empty input and a full output ring are counted, not waited on
+TEST_F(IQThreadTest, WorkerReportsMissedDeadlines) {
+    const size_t block = 4096;
+    auto input = generateTestSignal(block * 4, INPUT_RATE, 10000.0f);
+
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 255, IQResamplerCPP::Mode::PolyphaseDirect);
+    IQRingBuffer in(16384);
+    IQRingBuffer out(4096);
+    in.write(input.data(), input.size());
+
+    IQResamplerWorker worker(resampler, in, out, block);
+    worker.setPeriod(1000);  // 1 us: no block of 4096 samples fits
+    worker.start();
+    ASSERT_TRUE(waitForBlocks(worker, 4));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    worker.stop();
+
+    IQDeadlineStats stats = worker.stats();
+    EXPECT_EQ(stats.blocks, 4u);
+    EXPECT_EQ(stats.missedDeadlines, 4u);
+    EXPECT_GT(stats.worstLatencyNs, 1000);
+    EXPECT_GT(stats.underruns, 0u);
+    EXPECT_GT(stats.droppedSamples, 0u);
+    EXPECT_EQ(out.available(), out.capacity());
+
+    // Restart clears the statistics
+    worker.setPeriod(1000000);
+    worker.start();
+    worker.stop();
+    EXPECT_EQ(worker.stats().blocks, 0u);
+}
+
+// Test: A reserve() failing on the worker thread is reported by start()
+// instead of terminating the process
+TEST_F(IQThreadTest, WorkerReportsFailedReserve) {
+    const size_t block = 65536;
+    auto input = generateTestSignal(block, INPUT_RATE, 10000.0f);
+
+    // A memory budget the default block fits in but the worker's does not
+    IQResamplerCPP resampler(INPUT_RATE, OUTPUT_RATE, 127, IQResamplerCPP::Mode::PolyphaseDirect);
+    resampler.reserve(IQResamplerCPP::DEFAULT_MAX_BLOCK_SAMPLES, IQMemoryPolicy(false, IQMemoryPolicy::ANY_NODE,
+                                                                                 resampler.arena().capacity()));
+    IQRingBuffer in(2 * block);
+    IQRingBuffer out(2 * block);
+    IQResamplerWorker worker(resampler, in, out, block);
+
+    EXPECT_THROW(worker.start(), std::bad_alloc);
+    EXPECT_FALSE(worker.running());
+    EXPECT_EQ(worker.stats().errors, 1u);
+    EXPECT_EQ(resampler.maxBlockSamples(), IQResamplerCPP::DEFAULT_MAX_BLOCK_SAMPLES);
+
+    // Nothing is left behind: without the budget the next start() runs normally
+    resampler.reserve(IQResamplerCPP::DEFAULT_MAX_BLOCK_SAMPLES);
+    in.write(input.data(), input.size());
+    worker.start();
+    ASSERT_TRUE(waitForBlocks(worker, 1));
+    worker.stop();
+    EXPECT_EQ(worker.stats().errors, 0u);
+    EXPECT_EQ(resampler.maxBlockSamples(), block);
+}